@@ -18,13 +18,101 @@ uint64_t averageDmg(const DamageRange & range)
 	return (range.min + range.max) / 2;
 }
 
-void DamageCache::cacheDamage(const battle::Unit * attacker, const battle::Unit * defender, std::shared_ptr<CBattleInfoCallback> hb)
+/// Upper limit for IDs of units stored in damage matrix, units with higher IDs are not cached
+static constexpr uint32_t MAX_CACHED_UNITS = 1024;
+
+static float getDamagePerCreature(const battle::Unit * attacker, const DamageEstimation & estimation)
+{
+	return static_cast<float>(averageDmg(estimation.damage)) / attacker->getCount();
+}
+
+static float estimateDamagePerCreature(const battle::Unit * attacker, const battle::Unit * defender, std::shared_ptr<CBattleInfoCallback> hb)
 {
-	auto damage = averageDmg(hb->battleEstimateDamage(attacker, defender, 0).damage);
+	return getDamagePerCreature(attacker, hb->battleEstimateDamage(attacker, defender, 0));
+}
+
+bool DamageCache::DamageCell::load(const StateTag & attacker, const StateTag & defender, float & result) const
+{
+	uint32_t before = sequence.load(std::memory_order_acquire);
+
+	if(before & 1)
+		return false;
 
-	damageCache[attacker->unitId()][defender->unitId()] = static_cast<float>(damage) / attacker->getCount();
+	bool matches = attackerType.load(std::memory_order_relaxed) == attacker.type
+		&& attackerVersion.load(std::memory_order_relaxed) == attacker.version
+		&& defenderType.load(std::memory_order_relaxed) == defender.type
+		&& defenderVersion.load(std::memory_order_relaxed) == defender.version;
+
+	result = damage.load(std::memory_order_relaxed);
+
+	// cell must not be changed while it was read
+	std::atomic_thread_fence(std::memory_order_acquire);
+
+	return matches && sequence.load(std::memory_order_relaxed) == before;
 }
 
+void DamageCache::DamageCell::store(const StateTag & attacker, const StateTag & defender, float value)
+{
+	uint32_t before = sequence.load(std::memory_order_relaxed);
+
+	// concurrent thread stores value of its own, which is as good as ours
+	if((before & 1) || !sequence.compare_exchange_strong(before, before + 1, std::memory_order_relaxed))
+		return;
+
+	std::atomic_thread_fence(std::memory_order_release);
+
+	attackerType.store(attacker.type, std::memory_order_relaxed);
+	attackerVersion.store(attacker.version, std::memory_order_relaxed);
+	defenderType.store(defender.type, std::memory_order_relaxed);
+	defenderVersion.store(defender.version, std::memory_order_relaxed);
+	damage.store(value, std::memory_order_relaxed);
+
+	sequence.store(before + 2, std::memory_order_release);
+}
+
+void DamageCache::DamageCell::assign(const DamageCell & other)
+{
+	sequence.store(other.sequence.load(std::memory_order_relaxed), std::memory_order_relaxed);
+	attackerType.store(other.attackerType.load(std::memory_order_relaxed), std::memory_order_relaxed);
+	attackerVersion.store(other.attackerVersion.load(std::memory_order_relaxed), std::memory_order_relaxed);
+	defenderType.store(other.defenderType.load(std::memory_order_relaxed), std::memory_order_relaxed);
+	defenderVersion.store(other.defenderVersion.load(std::memory_order_relaxed), std::memory_order_relaxed);
+	damage.store(other.damage.load(std::memory_order_relaxed), std::memory_order_relaxed);
+}
+
+void DamageCache::DamageCell::clear()
+{
+	// type of every valid state is set, so empty type never matches
+	attackerType.store(nullptr, std::memory_order_relaxed);
+	defenderType.store(nullptr, std::memory_order_relaxed);
+}
+
+DamageCache::DamageCache(const DamageCache & other)
+	: builtStateTags(other.builtStateTags),
+	unitsCount(other.unitsCount),
+	parent(other.parent)
+{
+	if(!other.damageMatrix)
+		return;
+
+	damageMatrix.reset(new DamageCell[unitsCount * unitsCount]);
+
+	for(uint32_t i = 0; i < unitsCount * unitsCount; i++)
+		damageMatrix[i].assign(other.damageMatrix[i]);
+}
+
+DamageCache::DamageCell * DamageCache::getCell(const battle::Unit * attacker, const battle::Unit * defender) const
+{
+	if(attacker->unitId() >= unitsCount || defender->unitId() >= unitsCount)
+		return nullptr;
+
+	return &damageMatrix[attacker->unitId() * unitsCount + defender->unitId()];
+}
+
+DamageCache::StateTag DamageCache::getStateTag(const battle::Unit * unit)
+{
+	return StateTag{&typeid(*unit), unit->getTreeVersion()};
+}
 
 void DamageCache::buildDamageCache(std::shared_ptr<HypotheticBattle> hb, int side)
 {
@@ -33,6 +121,30 @@ void DamageCache::buildDamageCache(std::shared_ptr<HypotheticBattle> hb, int sid
 			return u->isValidTarget();
 		});
 
+	if(!damageMatrix)
+	{
+		// unit IDs are assigned sequentially, except for units summoned in hypothetic battles
+		for(auto stack : stacks)
+		{
+			if(stack->unitId() < MAX_CACHED_UNITS)
+				vstd::amax(unitsCount, stack->unitId() + 1);
+		}
+
+		damageMatrix.reset(new DamageCell[unitsCount * unitsCount]);
+	}
+
+	// versions of units in different hypothetic battles may be equal, so values of previous state can not be reused
+	for(uint32_t i = 0; i < unitsCount * unitsCount; i++)
+		damageMatrix[i].clear();
+
+	builtStateTags.assign(unitsCount, StateTag());
+
+	for(auto stack : stacks)
+	{
+		if(stack->unitId() < unitsCount)
+			builtStateTags[stack->unitId()] = getStateTag(stack);
+	}
+
 	std::vector<const battle::Unit *> ourUnits;
 	std::vector<const battle::Unit *> enemyUnits;
 
@@ -44,6 +156,9 @@ void DamageCache::buildDamageCache(std::shared_ptr<HypotheticBattle> hb, int sid
 			enemyUnits.push_back(stack);
 	}
 
+	// same attacks as battleEstimateDamage(attacker, defender, 0) evaluates, but computed in single batch
+	std::vector<BattleAttackInfo> attacks;
+
 	for(auto ourUnit : ourUnits)
 	{
 		if(!ourUnit->alive())
@@ -53,37 +168,64 @@ void DamageCache::buildDamageCache(std::shared_ptr<HypotheticBattle> hb, int sid
 		{
 			if(enemyUnit->alive())
 			{
-				cacheDamage(ourUnit, enemyUnit, hb);
-				cacheDamage(enemyUnit, ourUnit, hb);
+				attacks.emplace_back(ourUnit, enemyUnit, 0, hb->battleCanShoot(ourUnit, enemyUnit->getPosition()));
+				attacks.emplace_back(enemyUnit, ourUnit, 0, hb->battleCanShoot(enemyUnit, ourUnit->getPosition()));
 			}
 		}
 	}
+
+	auto estimations = hb->calculateDmgRanges(attacks);
+
+	for(size_t i = 0; i < attacks.size(); i++)
+	{
+		auto * cell = getCell(attacks[i].attacker, attacks[i].defender);
+
+		if(cell)
+		{
+			cell->store(
+				getStateTag(attacks[i].attacker),
+				getStateTag(attacks[i].defender),
+				getDamagePerCreature(attacks[i].attacker, estimations[i]));
+		}
+	}
 }
 
 int64_t DamageCache::getDamage(const battle::Unit * attacker, const battle::Unit * defender, std::shared_ptr<CBattleInfoCallback> hb)
 {
-	bool wasComputedBefore = damageCache[attacker->unitId()].count(defender->unitId());
+	auto * cell = getCell(attacker, defender);
+
+	if(!cell)
+		return static_cast<int64_t>(estimateDamagePerCreature(attacker, defender, hb) * attacker->getCount());
 
-	if (!wasComputedBefore)
-		cacheDamage(attacker, defender, hb);
+	auto attackerTag = getStateTag(attacker);
+	auto defenderTag = getStateTag(defender);
+	float damage;
 
-	return damageCache[attacker->unitId()][defender->unitId()] * attacker->getCount();
+	if(!cell->load(attackerTag, defenderTag, damage))
+	{
+		// concurrent threads may compute same value twice, which is cheaper than synchronization
+		damage = estimateDamagePerCreature(attacker, defender, hb);
+		cell->store(attackerTag, defenderTag, damage);
+	}
+
+	return static_cast<int64_t>(damage * attacker->getCount());
 }
 
 int64_t DamageCache::getOriginalDamage(const battle::Unit * attacker, const battle::Unit * defender, std::shared_ptr<CBattleInfoCallback> hb)
 {
 	if(parent)
 	{
-		auto attackerDamageMap = parent->damageCache.find(attacker->unitId());
+		auto * cell = parent->getCell(attacker, defender);
 
-		if(attackerDamageMap != parent->damageCache.end())
+		if(cell)
 		{
-			auto targetDamage = attackerDamageMap->second.find(defender->unitId());
+			const auto & attackerTag = parent->builtStateTags[attacker->unitId()];
+			const auto & defenderTag = parent->builtStateTags[defender->unitId()];
+			float damage;
 
-			if(targetDamage != attackerDamageMap->second.end())
-			{
-				return static_cast<int64_t>(targetDamage->second * attacker->getCount());
-			}
+			// cell may be overwritten with damage of units from other states that share parent cache
+			if(attackerTag.type && defenderTag.type && cell->load(attackerTag, defenderTag, damage))
+				return static_cast<int64_t>(damage * attacker->getCount());
 		}
 	}
 
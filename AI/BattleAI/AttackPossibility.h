@@ -14,20 +14,62 @@
 
 #define BATTLE_TRACE_LEVEL 0
 
+/// Estimated damage between pairs of units, stored per single attacking creature
+/// Once built, cache can be used concurrently from multiple threads, each cell is filled independently without locks
 class DamageCache
 {
 private:
-	std::unordered_map<uint32_t, std::unordered_map<uint32_t, float>> damageCache;
-	DamageCache * parent;
+	/// Bonus state of unit, real stacks and units of hypothetic battles count bonus versions independently
+	/// so equal versions of units of different types may mean different bonuses
+	struct StateTag
+	{
+		const std::type_info * type = nullptr;
+		int64_t version = 0;
+	};
+
+	/// Damage per creature along with exact states of both units it was computed for
+	/// Cells are written without locks, sequence is odd while cell is being written and such cell is treated as empty
+	struct DamageCell
+	{
+		std::atomic<uint32_t> sequence{0};
+		std::atomic<const std::type_info *> attackerType{nullptr};
+		std::atomic<int64_t> attackerVersion{0};
+		std::atomic<const std::type_info *> defenderType{nullptr};
+		std::atomic<int64_t> defenderVersion{0};
+		std::atomic<float> damage{0};
+
+		/// returns true and sets result if cell contains damage between units in specified states
+		bool load(const StateTag & attacker, const StateTag & defender, float & result) const;
+		/// does nothing if cell is being written by another thread at the same time
+		void store(const StateTag & attacker, const StateTag & defender, float value);
+		/// not thread-safe, used only while cache is not shared
+		void assign(const DamageCell & other);
+		void clear();
+	};
+
+	/// Dense matrix indexed by attacker and defender unit ID
+	std::unique_ptr<DamageCell[]> damageMatrix;
+	/// State tags of units at the moment cache was built, empty for units that were not present
+	std::vector<StateTag> builtStateTags;
+	uint32_t unitsCount;
+	const DamageCache * parent;
+
+	DamageCell * getCell(const battle::Unit * attacker, const battle::Unit * defender) const;
+	static StateTag getStateTag(const battle::Unit * unit);
 
 public:
-	DamageCache() : parent(nullptr) {}
-	DamageCache(DamageCache * parent) : parent(parent) {}
+	DamageCache() : unitsCount(0), parent(nullptr) {}
+	DamageCache(const DamageCache * parent) : unitsCount(0), parent(parent) {}
+	DamageCache(const DamageCache & other);
+
+	/// Precomputes damage between all alive units of opposite sides, dropping values cached for previous battle state
+	/// Storage is allocated on first call only, so one cache can be rebuilt for several hypothetic battles
+	/// Must be called before cache is shared between threads. Units summoned later are evaluated without caching
+	void buildDamageCache(std::shared_ptr<HypotheticBattle> hb, int side);
 
-	void cacheDamage(const battle::Unit * attacker, const battle::Unit * defender, std::shared_ptr<CBattleInfoCallback> hb);
 	int64_t getDamage(const battle::Unit * attacker, const battle::Unit * defender, std::shared_ptr<CBattleInfoCallback> hb);
+	/// Returns damage that was cached in parent, before any changes to battle state, if available
 	int64_t getOriginalDamage(const battle::Unit * attacker, const battle::Unit * defender, std::shared_ptr<CBattleInfoCallback> hb);
-	void buildDamageCache(std::shared_ptr<HypotheticBattle> hb, int side);
 };
 
 /// <summary>
@@ -538,6 +538,9 @@ bool BattleEvaluator::attemptCastingSpell(const CStack * activeStack)
 	tbb::parallel_for(tbb::blocked_range<size_t>(0, possibleCasts.size()), [&](const tbb::blocked_range<size_t> & r)
 		{
 #endif
+			// storage is allocated once and rebuilt for state of each evaluated spell
+			DamageCache innerCache(&damageCache);
+
 			for(auto i = r.begin(); i != r.end(); i++)
 			{
 				auto & ps = possibleCasts[i];
@@ -559,8 +562,6 @@ bool BattleEvaluator::attemptCastingSpell(const CStack * activeStack)
 						return  !original || u->getMovementRange() != original->getMovementRange();
 					});
 
-				DamageCache safeCopy = damageCache;
-				DamageCache innerCache(&safeCopy);
 				innerCache.buildDamageCache(state, side);
 
 				if(needFullEval || !cachedAttack)
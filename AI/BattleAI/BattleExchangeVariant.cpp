@@ -228,7 +228,7 @@ EvaluationResult BattleExchangeEvaluator::findBestTarget(
 		logAi->trace("Evaluating waited attack for %s", activeStack->getDescription());
 #endif
 
-		auto hbWaited = std::make_shared<HypotheticBattle>(env.get(), hb);
+		auto hbWaited = HypotheticBattle::fork(hb);
 
 		hbWaited->getForUpdate(activeStack->unitId())->waiting = true;
 		hbWaited->getForUpdate(activeStack->unitId())->waitedThisTurn = true;
@@ -528,7 +528,7 @@ BattleScore BattleExchangeEvaluator::calculateExchange(
 		return BattleScore();
 	}
 
-	auto exchangeBattle = std::make_shared<HypotheticBattle>(env.get(), hb);
+	auto exchangeBattle = HypotheticBattle::fork(hb);
 	BattleExchangeVariant v;
 
 	for(auto unit : exchangeUnits.units)
@@ -41,6 +41,7 @@ StackWithBonuses::StackWithBonuses(const HypotheticBattle * Owner, const battle:
 	: battle::CUnitState(),
 	origBearer(Stack->getBonusBearer()),
 	owner(Owner),
+	frozen(false),
 	type(Stack->unitType()),
 	baseAmount(Stack->unitBaseAmount()),
 	id(Stack->unitId()),
@@ -58,6 +59,7 @@ StackWithBonuses::StackWithBonuses(const HypotheticBattle * Owner, const battle:
 	: battle::CUnitState(),
 	origBearer(Stack->getBonusBearer()),
 	owner(Owner),
+	frozen(false),
 	type(Stack->unitType()),
 	baseAmount(Stack->unitBaseAmount()),
 	id(Stack->unitId()),
@@ -76,6 +78,7 @@ StackWithBonuses::StackWithBonuses(const HypotheticBattle * Owner, const battle:
 	: battle::CUnitState(),
 	origBearer(nullptr),
 	owner(Owner),
+	frozen(false),
 	baseAmount(info.count),
 	id(info.id),
 	side(info.side),
@@ -93,6 +96,27 @@ StackWithBonuses::StackWithBonuses(const HypotheticBattle * Owner, const battle:
 	summoned = info.summoned;
 }
 
+StackWithBonuses::StackWithBonuses(const HypotheticBattle * Owner, const StackWithBonuses & other)
+	: battle::CUnitState(),
+	bonusesToAdd(other.bonusesToAdd),
+	bonusesToUpdate(other.bonusesToUpdate),
+	bonusesToRemove(other.bonusesToRemove),
+	treeVersionLocal(other.treeVersionLocal),
+	origBearer(other.origBearer),
+	owner(Owner),
+	frozen(false),
+	type(other.type),
+	baseAmount(other.baseAmount),
+	id(other.id),
+	side(other.side),
+	player(other.player),
+	slot(other.slot)
+{
+	localInit(Owner);
+
+	battle::CUnitState::operator=(other);
+}
+
 StackWithBonuses::~StackWithBonuses() = default;
 
 StackWithBonuses & StackWithBonuses::operator=(const battle::CUnitState & other)
@@ -259,6 +283,32 @@ HypotheticBattle::HypotheticBattle(const Environment * ENV, Subject realBattle)
 
 	nextId = 0x00F00000;
 
+	initEnvironment();
+}
+
+HypotheticBattle::HypotheticBattle(const std::shared_ptr<HypotheticBattle> & parent)
+	: BattleProxy(parent->subject),
+	stackStates(parent->stackStates),
+	env(parent->env),
+	bonusTreeVersion(parent->bonusTreeVersion),
+	activeUnitId(parent->activeUnitId),
+	nextId(parent->nextId),
+	parent(parent)
+{
+	//from now on both battles reference same states, so neither of them may change these states in place
+	for(auto & idState : stackStates)
+		idState.second->frozen = true;
+
+	initEnvironment();
+}
+
+std::shared_ptr<HypotheticBattle> HypotheticBattle::fork(const std::shared_ptr<HypotheticBattle> & parent)
+{
+	return std::shared_ptr<HypotheticBattle>(new HypotheticBattle(parent));
+}
+
+void HypotheticBattle::initEnvironment()
+{
 	eventBus.reset(new events::EventBus());
 
 	localEnvironment.reset(new HypotheticEnvironment(this, env));
@@ -292,10 +342,12 @@ std::shared_ptr<StackWithBonuses> HypotheticBattle::getForUpdate(uint32_t id)
 		stackStates[id] = ret;
 		return ret;
 	}
-	else
-	{
-		return iter->second;
-	}
+
+	//state is shared with another battle, copy it before any change
+	if(iter->second->owner != this || iter->second->frozen)
+		iter->second = std::make_shared<StackWithBonuses>(this, *iter->second);
+
+	return iter->second;
 }
 
 battle::Units HypotheticBattle::getUnitsIf(const battle::UnitFilter & predicate) const
@@ -321,6 +373,24 @@ battle::Units HypotheticBattle::getUnitsIf(const battle::UnitFilter & predicate)
 	return ret;
 }
 
+const battle::Unit * HypotheticBattle::getUnitAtPos(BattleHex pos) const
+{
+	//units changed in this hypothetic battle may be damaged or moved via getForUpdate at any moment, so they are checked directly
+	for(const auto & idUnit : stackStates)
+	{
+		const auto * unit = idUnit.second.get();
+		if(!unit->isGhost() && unit->alive() && unit->coversPos(pos))
+			return unit;
+	}
+
+	//for all other units occupancy table of real battle is still accurate
+	const auto * unit = BattleProxy::getUnitAtPos(pos);
+	if(unit && stackStates.find(unit->unitId()) == stackStates.end())
+		return unit;
+
+	return nullptr;
+}
+
 BattleID HypotheticBattle::getBattleID() const
 {
 	return subject->getBattle()->getBattleID();
@@ -11,6 +11,8 @@
 
 #include <vstd/RNG.h>
 
+#include <boost/container/flat_map.hpp>
+
 #include <vcmi/Environment.h>
 #include <vcmi/ServerCallback.h>
 
@@ -55,6 +57,9 @@ public:
 
 	StackWithBonuses(const HypotheticBattle * Owner, const battle::UnitInfo & info);
 
+	/// Copy of state owned by another battle, bonus changes are copied as well so bonus lookups do not chain through other battle
+	StackWithBonuses(const HypotheticBattle * Owner, const StackWithBonuses & other);
+
 	virtual ~StackWithBonuses();
 
 	StackWithBonuses & operator= (const battle::CUnitState & other);
@@ -85,9 +90,15 @@ public:
 	std::string getDescription() const override;
 
 private:
+	friend class HypotheticBattle;
+
 	const IBonusBearer * origBearer;
 	const HypotheticBattle * owner;
 
+	/// State is referenced by battle forked from owner and must not be changed anymore, owner will update its own copy instead
+	/// Set by forks, which may be created from same battle on several threads at once
+	std::atomic<bool> frozen;
+
 	const CCreature * type;
 	ui32 baseAmount;
 	uint32_t id;
@@ -99,12 +110,18 @@ private:
 class HypotheticBattle : public BattleProxy, public battle::IUnitEnvironment
 {
 public:
-	std::map<uint32_t, std::shared_ptr<StackWithBonuses>> stackStates;
+	/// States of units changed in this battle. Unchanged states are shared with the battle this one was forked from
+	boost::container::flat_map<uint32_t, std::shared_ptr<StackWithBonuses>> stackStates;
 
 	const Environment * env;
 
 	HypotheticBattle(const Environment * ENV, Subject realBattle);
 
+	/// Creates independent copy of parent battle state, parent can be changed further without affecting returned battle
+	/// Unit states are shared with parent until one of battles changes them, so forking is as cheap as copying few pointers
+	/// Forked battle proxies real battle directly, so lookups do not get slower with each fork
+	static std::shared_ptr<HypotheticBattle> fork(const std::shared_ptr<HypotheticBattle> & parent);
+
 	bool unitHasAmmoCart(const battle::Unit * unit) const override;
 	PlayerColor unitEffectiveOwner(const battle::Unit * unit) const override;
 
@@ -115,6 +132,7 @@ public:
 	int32_t getActiveStackID() const override;
 
 	battle::Units getUnitsIf(const battle::UnitFilter & predicate) const override;
+	const battle::Unit * getUnitAtPos(BattleHex pos) const override;
 
 	void nextRound() override;
 	void nextTurn(uint32_t unitId) override;
@@ -196,6 +214,13 @@ private:
 	int32_t activeUnitId;
 	mutable uint32_t nextId;
 
+	/// Keeps alive battle that owns states shared with this one
+	std::shared_ptr<const HypotheticBattle> parent;
+
+	HypotheticBattle(const std::shared_ptr<HypotheticBattle> & parent);
+
+	void initEnvironment();
+
 	std::unique_ptr<HypotheticServerCallback> serverCallback;
 	std::unique_ptr<HypotheticEnvironment> localEnvironment;
 
@@ -285,6 +285,10 @@ void AIGateway::tileRevealed(const std::unordered_set<int3> & pos)
 		for(const CGObjectInstance * obj : myCb->getVisitableObjs(tile))
 			addVisitableObj(obj);
 	}
+
+	// revealed guards and obstacles change enemy paths
+	if(!pos.empty())
+		nullkiller->dangerHitMap->invalidateThreatLayers();
 }
 
 void AIGateway::heroExchangeStarted(ObjectInstanceID hero1, ObjectInstanceID hero2, QueryID query)
@@ -383,6 +387,12 @@ void AIGateway::objectRemoved(const CGObjectInstance * obj, const PlayerColor &
 	{
 		nullkiller->dangerHitMap->reset();
 	}
+
+	// removed guard or obstacle opens paths for enemy heroes
+	if(obj->ID == Obj::MONSTER || obj->blockVisit || !obj->getBlockedOffsets().empty())
+	{
+		nullkiller->dangerHitMap->invalidateThreatLayers();
+	}
 }
 
 void AIGateway::showHillFortWindow(const CGObjectInstance * object, const CGHeroInstance * visitor)
@@ -828,6 +838,9 @@ void AIGateway::makeTurn()
 				nullkiller->memory->markObjectUnvisited(obj);
 			}
 		}
+
+		// guards grew, enemy paths have to be recalculated
+		nullkiller->dangerHitMap->invalidateThreatLayers();
 	}
 
 #if NKAI_TRACE_LEVEL == 0
@@ -1143,13 +1156,15 @@ void AIGateway::waitTillFree()
 
 void AIGateway::retrieveVisitableObjs()
 {
-	foreach_tile_pos([&](const int3 & pos)
+	int3 mapSize = myCb->getMapSize();
+
+	for(int z = 0; z < mapSize.z; z++)
 	{
-		for(const CGObjectInstance * obj : myCb->getVisitableObjs(pos, false))
+		for(const CGObjectInstance * obj : myCb->getVisitableObjsInRect(int3(0, 0, z), int3(mapSize.x - 1, mapSize.y - 1, z)))
 		{
 			addVisitableObj(obj);
 		}
-	});
+	}
 }
 
 std::vector<const CGObjectInstance *> AIGateway::getFlaggedObjects() const
@@ -1168,12 +1183,19 @@ void AIGateway::addVisitableObj(const CGObjectInstance * obj)
 	if(obj->ID == Obj::EVENT)
 		return;
 
+	bool alreadyKnown = vstd::contains(nullkiller->memory->visitableObjs, obj);
+
 	nullkiller->memory->addVisitableObject(obj);
 
 	if(obj->ID == Obj::HERO && cb->getPlayerRelations(obj->tempOwner, playerID) == PlayerRelations::ENEMIES)
 	{
 		nullkiller->dangerHitMap->reset();
 	}
+
+	if(obj->ID == Obj::MONSTER && !alreadyKnown)
+	{
+		nullkiller->dangerHitMap->invalidateThreatLayers();
+	}
 }
 
 bool AIGateway::moveHeroToTile(int3 dst, HeroPtr h)
@@ -23,6 +23,17 @@ double HitMapInfo::value() const
 	return danger / std::sqrt(turn / 3.0f + 1);
 }
 
+bool HeroThreatLayer::isUpToDate(const CGHeroInstance * enemy, int currentMapVersion) const
+{
+	uint64_t enemyDanger = enemy->getFightingStrength() * enemy->getArmyStrength();
+
+	return mapVersion == currentMapVersion
+		&& position == enemy->visitablePos()
+		&& movementPoints == enemy->movementPointsRemaining()
+		&& mana == enemy->mana
+		&& danger == enemyDanger;
+}
+
 void DangerHitMapAnalyzer::updateHitMap()
 {
 	if(hitMapUpToDate)
@@ -33,14 +44,13 @@ void DangerHitMapAnalyzer::updateHitMap()
 	hitMapUpToDate = true;
 	auto start = std::chrono::high_resolution_clock::now();
 
-	auto cb = ai->cb.get();
 	auto mapSize = ai->cb->getMapSize();
 	
 	if(hitMap.shape()[0] != mapSize.x || hitMap.shape()[1] != mapSize.y || hitMap.shape()[2] != mapSize.z)
+	{
 		hitMap.resize(boost::extents[mapSize.x][mapSize.y][mapSize.z]);
-
-	enemyHeroAccessibleObjects.clear();
-	townThreats.clear();
+		threatLayers.clear();
+	}
 
 	std::map<PlayerColor, std::map<const CGHeroInstance *, HeroRole>> heroes;
 
@@ -54,18 +64,27 @@ void DangerHitMapAnalyzer::updateHitMap()
 		}
 	}
 
-	auto ourTowns = cb->getTownsInfo();
+	updateThreatLayers(heroes);
+	mergeThreatLayers();
 
-	for(auto town : ourTowns)
-	{
-		townThreats[town->id]; // insert empty list
-	}
+	logAi->trace("Danger hit map updated in %ld", timeElapsed(start));
+}
 
-	foreach_tile_pos([&](const int3 & pos){
-		hitMap[pos.x][pos.y][pos.z].reset();
-	});
+int DangerHitMapAnalyzer::tileIndex(const int3 & tile) const
+{
+	return (tile.z * hitMap.shape()[0] + tile.x) * hitMap.shape()[1] + tile.y;
+}
 
-	for(auto pair : heroes)
+void DangerHitMapAnalyzer::updateThreatLayers(const std::map<PlayerColor, std::map<const CGHeroInstance *, HeroRole>> & heroes)
+{
+	auto mapSize = ai->cb->getMapSize();
+	int tilesCount = mapSize.x * mapSize.y * mapSize.z;
+	int layersRebuilt = 0;
+
+	// layers of heroes that are gone or no longer enemies are dropped
+	std::map<ObjectInstanceID, HeroThreatLayer> actualLayers;
+
+	for(auto & pair : heroes)
 	{
 		if(!pair.first.isValidPlayer())
 			continue;
@@ -73,77 +92,142 @@ void DangerHitMapAnalyzer::updateHitMap()
 		if(ai->cb->getPlayerRelations(ai->playerID, pair.first) != PlayerRelations::ENEMIES)
 			continue;
 
+		std::map<const CGHeroInstance *, HeroRole> outdatedHeroes;
+		std::map<const CGHeroInstance *, HeroThreatLayer *> outdatedLayers;
+
+		for(auto & hero : pair.second)
+		{
+			auto & layer = actualLayers[hero.first->id];
+			auto cached = threatLayers.find(hero.first->id);
+
+			if(cached != threatLayers.end() && cached->second.isUpToDate(hero.first, mapVersion))
+			{
+				layer = std::move(cached->second);
+				layer.hero = hero.first;
+				continue;
+			}
+
+			layer.hero = hero.first;
+			layer.danger = hero.first->getFightingStrength() * hero.first->getArmyStrength();
+			layer.position = hero.first->visitablePos();
+			layer.movementPoints = hero.first->movementPointsRemaining();
+			layer.mana = hero.first->mana;
+			layer.mapVersion = mapVersion;
+			layer.turns.assign(tilesCount, HeroThreatLayer::UNREACHABLE);
+
+			outdatedHeroes[hero.first] = hero.second;
+			outdatedLayers[hero.first] = &layer;
+		}
+
+		if(outdatedHeroes.empty())
+			continue;
+
+		layersRebuilt += outdatedHeroes.size();
+
 		PathfinderSettings ps;
 
 		ps.mainTurnDistanceLimit = 10;
 		ps.scoutTurnDistanceLimit = 10;
 		ps.useHeroChain = false;
 
-		ai->pathfinder->updatePaths(pair.second, ps);
+		ai->pathfinder->updatePaths(outdatedHeroes, ps);
 
 		boost::this_thread::interruption_point();
 
 		pforeachTilePos(mapSize, [&](const int3 & pos)
 		{
-			for(AIPath & path : ai->pathfinder->getPathInfo(pos))
+			int index = tileIndex(pos);
+
+			ai->pathfinder->forEachPathSummary(pos, [&](const AIPathSummary & path)
 			{
 				if(path.getFirstBlockedAction())
-					continue;
+					return;
 
-				auto & node = hitMap[pos.x][pos.y][pos.z];
+				auto layer = outdatedLayers.find(path.targetHero);
 
-				HitMapInfo newThreat;
+				if(layer != outdatedLayers.end())
+					vstd::amin(layer->second->turns[index], path.turn());
+			});
+		});
+	}
 
-				newThreat.hero = path.targetHero;
-				newThreat.turn = path.turn();
-				newThreat.danger = path.getHeroStrength();
+	threatLayers = std::move(actualLayers);
 
-				if(newThreat.value() > node.maximumDanger.value())
-				{
-					node.maximumDanger = newThreat;
-				}
+	logAi->trace("Threat layers rebuilt: %d of %d", layersRebuilt, threatLayers.size());
+}
 
-				if(newThreat.turn < node.fastestDanger.turn
-					|| (newThreat.turn == node.fastestDanger.turn && node.fastestDanger.danger < newThreat.danger))
-				{
-					node.fastestDanger = newThreat;
-				}
+void DangerHitMapAnalyzer::mergeThreatLayers()
+{
+	auto cb = ai->cb.get();
+	auto mapSize = cb->getMapSize();
 
-				auto objects = cb->getVisitableObjs(pos, false);
+	std::vector<const HeroThreatLayer *> layers;
 
-				for(auto obj : objects)
-				{
-					if(obj->ID == Obj::TOWN && obj->getOwner() == ai->playerID)
-					{
-						auto & threats = townThreats[obj->id];
-						auto threat = std::find_if(threats.begin(), threats.end(), [&](const HitMapInfo & i) -> bool
-							{
-								return i.hero.hid == path.targetHero->id;
-							});
-
-						if(threat == threats.end())
-						{
-							threats.emplace_back();
-							threat = std::prev(threats.end(), 1);
-						}
-
-						if(newThreat.value() > threat->value())
-						{
-							*threat = newThreat;
-						}
-
-						if(newThreat.turn == 0)
-						{
-							if(cb->getPlayerRelations(obj->tempOwner, ai->playerID) != PlayerRelations::ENEMIES)
-								enemyHeroAccessibleObjects.emplace_back(path.targetHero, obj);
-						}
-					}
-				}
+	for(auto & layer : threatLayers)
+		layers.push_back(&layer.second);
+
+	// maximum reduction of all layers, every tile is reduced by single task in fixed layer order
+	pforeachTilePos(mapSize, [&](const int3 & pos)
+	{
+		auto & node = hitMap[pos.x][pos.y][pos.z];
+		int index = tileIndex(pos);
+
+		node.reset();
+
+		for(auto layer : layers)
+		{
+			uint8_t turn = layer->turns[index];
+
+			if(turn == HeroThreatLayer::UNREACHABLE)
+				continue;
+
+			HitMapInfo newThreat;
+
+			newThreat.turn = turn;
+			newThreat.danger = layer->danger;
+
+			if(newThreat.value() > node.maximumDanger.value())
+			{
+				node.maximumDanger = newThreat;
+				node.maximumDanger.hero = layer->hero;
 			}
-		});
-	}
 
-	logAi->trace("Danger hit map updated in %ld", timeElapsed(start));
+			if(newThreat.turn < node.fastestDanger.turn
+				|| (newThreat.turn == node.fastestDanger.turn && node.fastestDanger.danger < newThreat.danger))
+			{
+				node.fastestDanger = newThreat;
+				node.fastestDanger.hero = layer->hero;
+			}
+		}
+	});
+
+	enemyHeroAccessibleObjects.clear();
+	townThreats.clear();
+
+	for(auto town : cb->getTownsInfo())
+	{
+		auto & threats = townThreats[town->id];
+		int index = tileIndex(town->visitablePos());
+
+		for(auto layer : layers)
+		{
+			uint8_t turn = layer->turns[index];
+
+			if(turn == HeroThreatLayer::UNREACHABLE)
+				continue;
+
+			HitMapInfo threat;
+
+			threat.hero = layer->hero;
+			threat.turn = turn;
+			threat.danger = layer->danger;
+
+			threats.push_back(threat);
+
+			if(turn == 0)
+				enemyHeroAccessibleObjects.emplace_back(layer->hero, town);
+		}
+	}
 }
 
 void DangerHitMapAnalyzer::calculateTileOwners()
@@ -201,10 +285,10 @@ void DangerHitMapAnalyzer::calculateTileOwners()
 			const CGTownInstance * enemyTown = nullptr;
 			const CGTownInstance * ourTown = nullptr;
 
-			for(AIPath & path : ai->pathfinder->getPathInfo(pos))
+			ai->pathfinder->forEachPathSummary(pos, [&](const AIPathSummary & path)
 			{
 				if(!path.targetHero || path.getFirstBlockedAction())
-					continue;
+					return;
 
 				auto town = heroTownMap[path.targetHero];
 
@@ -224,7 +308,7 @@ void DangerHitMapAnalyzer::calculateTileOwners()
 						enemyTown = town;
 					}
 				}
-			}
+			});
 
 			if(vstd::isAlmostEqual(ourDistance, enemyDistance))
 			{
@@ -303,4 +387,10 @@ void DangerHitMapAnalyzer::reset()
 	hitMapUpToDate = false;
 }
 
+void DangerHitMapAnalyzer::invalidateThreatLayers()
+{
+	mapVersion++;
+	hitMapUpToDate = false;
+}
+
 }
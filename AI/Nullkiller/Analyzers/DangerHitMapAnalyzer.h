@@ -66,6 +66,26 @@ struct EnemyHeroAccessibleObject
 	}
 };
 
+/// Tiles reachable by single enemy hero. Enemy heroes do not move during our turn,
+/// so layer stays valid while its hero, its army and guards on the map stay the same
+struct HeroThreatLayer
+{
+	static const uint8_t UNREACHABLE = 255;
+
+	const CGHeroInstance * hero = nullptr;
+	uint64_t danger = 0;
+
+	int3 position;
+	int movementPoints = 0;
+	int mana = 0;
+	int mapVersion = 0;
+
+	/// Turn when hero reaches tile by unblocked path, indexed by tile
+	std::vector<uint8_t> turns;
+
+	bool isUpToDate(const CGHeroInstance * enemy, int currentMapVersion) const;
+};
+
 class DangerHitMapAnalyzer
 {
 private:
@@ -75,6 +95,12 @@ private:
 	bool tileOwnersUpToDate = false;
 	const Nullkiller * ai;
 	std::map<ObjectInstanceID, std::vector<HitMapInfo>> townThreats;
+	std::map<ObjectInstanceID, HeroThreatLayer> threatLayers;
+	int mapVersion = 0;
+
+	int tileIndex(const int3 & tile) const;
+	void updateThreatLayers(const std::map<PlayerColor, std::map<const CGHeroInstance *, HeroRole>> & heroes);
+	void mergeThreatLayers();
 
 public:
 	DangerHitMapAnalyzer(const Nullkiller * ai) :ai(ai) {}
@@ -86,6 +112,8 @@ public:
 	const HitMapNode & getTileThreat(const int3 & tile) const;
 	std::set<const CGObjectInstance *> getOneTurnAccessibleObjects(const CGHeroInstance * enemy) const;
 	void reset();
+	/// Guards that can stop enemy heroes have changed, all threat layers will be rebuilt on next update
+	void invalidateThreatLayers();
 	void resetTileOwners() { tileOwnersUpToDate = false; }
 	PlayerColor getTileOwner(const int3 & tile) const;
 	const CGTownInstance * getClosestTown(const int3 & tile) const;
@@ -244,7 +244,13 @@ void ObjectClusterizer::clusterize()
 			logAi->trace("Check object %s%s.", obj->getObjectName(), obj->visitablePos().toString());
 #endif
 
-			auto paths = ai->pathfinder->getPathInfo(obj->visitablePos());
+			// full paths are built only for heroes that should visit the object
+			std::vector<AIPathSummary> paths;
+
+			ai->pathfinder->forEachPathSummary(obj->visitablePos(), [&](const AIPathSummary & path)
+			{
+				paths.push_back(path);
+			});
 
 			if(paths.empty())
 			{
@@ -254,17 +260,19 @@ void ObjectClusterizer::clusterize()
 				continue;
 			}
 
-			std::sort(paths.begin(), paths.end(), [](const AIPath & p1, const AIPath & p2) -> bool
+			std::sort(paths.begin(), paths.end(), [](const AIPathSummary & p1, const AIPathSummary & p2) -> bool
 			{
 				return p1.movementCost() < p2.movementCost();
 			});
 
 			if(vstd::contains(ignoreObjects, obj->ID))
 			{
-				farObjects.addObject(obj, paths.front(), 0);
+				auto path = paths.front().toPath();
+
+				farObjects.addObject(obj, path, 0);
 
 #if NKAI_TRACE_LEVEL >= 2
-				logAi->trace("Object ignored. Moved to far objects with path %s", paths.front().toString());
+				logAi->trace("Object ignored. Moved to far objects with path %s", path.toString());
 #endif
 
 				continue;
@@ -272,20 +280,22 @@ void ObjectClusterizer::clusterize()
 
 			std::set<const CGHeroInstance *> heroesProcessed;
 
-			for(auto & path : paths)
+			for(auto & summary : paths)
 			{
-#if NKAI_TRACE_LEVEL >= 2
-				logAi->trace("Checking path %s", path.toString());
-#endif
-
-				if(!shouldVisit(ai, path.targetHero, obj))
+				if(!shouldVisit(ai, summary.targetHero, obj))
 				{
 #if NKAI_TRACE_LEVEL >= 2
-					logAi->trace("Hero %s does not need to visit %s", path.targetHero->getObjectName(), obj->getObjectName());
+					logAi->trace("Hero %s does not need to visit %s", summary.targetHero->getObjectName(), obj->getObjectName());
 #endif
 					continue;
 				}
 
+				auto path = summary.toPath();
+
+#if NKAI_TRACE_LEVEL >= 2
+				logAi->trace("Checking path %s", path.toString());
+#endif
+
 				if(path.nodes.size() > 1)
 				{
 					auto blocker = getBlocker(path);
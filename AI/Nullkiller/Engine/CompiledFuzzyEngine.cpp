@@ -0,0 +1,287 @@
+/*
+* CompiledFuzzyEngine.cpp, part of VCMI engine
+*
+* Authors: listed in file AUTHORS in main folder
+*
+* License: GNU General Public License v2.0 or later
+* Full text of license available in license.txt file, in main folder
+*
+*/
+#include "StdInc.h"
+#include "CompiledFuzzyEngine.h"
+
+#include <random>
+
+namespace NKAI
+{
+
+CompiledFuzzyEngine::CompiledFuzzyEngine(fl::Engine * engine)
+	: engine(engine), output(nullptr)
+{
+}
+
+std::unique_ptr<CompiledFuzzyEngine> CompiledFuzzyEngine::compile(fl::Engine * engine)
+{
+	std::unique_ptr<CompiledFuzzyEngine> result(new CompiledFuzzyEngine(engine));
+
+	if(engine->numberOfOutputVariables() != 1 || !result->compileOutput(engine->getOutputVariable(0)))
+		return nullptr;
+
+	for(std::size_t i = 0; i < engine->numberOfRuleBlocks(); i++)
+	{
+		const fl::RuleBlock * ruleBlock = engine->getRuleBlock(i);
+
+		if(!ruleBlock->isEnabled())
+			continue;
+
+		// General activation triggers every rule in order, other activation methods select subset of rules
+		if(ruleBlock->getActivation() && !dynamic_cast<const fl::General *>(ruleBlock->getActivation()))
+			return nullptr;
+
+		if(!dynamic_cast<const fl::AlgebraicProduct *>(ruleBlock->getImplication()))
+			return nullptr;
+
+		for(std::size_t j = 0; j < ruleBlock->numberOfRules(); j++)
+		{
+			const fl::Rule * rule = ruleBlock->getRule(j);
+
+			if(rule->isEnabled() && !result->compileRule(rule, ruleBlock))
+				return nullptr;
+		}
+	}
+
+	result->propositionDegrees.resize(result->propositions.size());
+	result->complementProducts.resize(result->integrationPoints.size());
+
+	return result;
+}
+
+bool CompiledFuzzyEngine::compileOutput(fl::OutputVariable * variable)
+{
+	auto centroid = dynamic_cast<const fl::Centroid *>(variable->getDefuzzifier());
+
+	if(!variable->isEnabled()
+		|| variable->isLockPreviousValue()
+		|| !centroid
+		|| !dynamic_cast<const fl::AlgebraicSum *>(variable->fuzzyOutput()->getAggregation()))
+	{
+		return false;
+	}
+
+	output = variable;
+
+	// same integration points as fl::Centroid::defuzzify uses
+	int resolution = centroid->getResolution();
+	double minimum = variable->getMinimum();
+	double dx = (variable->getMaximum() - minimum) / resolution;
+
+	for(int i = 0; i < resolution; i++)
+		integrationPoints.push_back(minimum + (i + 0.5) * dx);
+
+	for(std::size_t t = 0; t < variable->numberOfTerms(); t++)
+	{
+		const fl::Term * term = variable->getTerm(t);
+		OutputTerm compiled;
+
+		for(int i = 0; i < resolution; i++)
+		{
+			double membership = term->membership(integrationPoints[i]);
+
+			if(membership != 0)
+			{
+				compiled.points.push_back(i);
+				compiled.memberships.push_back(membership);
+			}
+		}
+
+		outputTerms.push_back(compiled);
+	}
+
+	return true;
+}
+
+bool CompiledFuzzyEngine::compileRule(const fl::Rule * rule, const fl::RuleBlock * ruleBlock)
+{
+	if(!rule->isLoaded())
+		return false;
+
+	Rule compiled;
+
+	compiled.weight = rule->getWeight();
+
+	if(!compileAntecedent(rule->getAntecedent()->getExpression(), compiled.propositions))
+		return false;
+
+	if(compiled.propositions.size() > 1 && !dynamic_cast<const fl::AlgebraicProduct *>(ruleBlock->getConjunction()))
+		return false;
+
+	const auto & conclusions = rule->getConsequent()->conclusions();
+
+	if(conclusions.size() != 1 || conclusions[0]->variable != output || !conclusions[0]->hedges.empty())
+		return false;
+
+	compiled.outputTerm = -1;
+
+	for(std::size_t t = 0; t < output->numberOfTerms(); t++)
+	{
+		if(output->getTerm(t) == conclusions[0]->term)
+			compiled.outputTerm = static_cast<int>(t);
+	}
+
+	if(compiled.outputTerm < 0)
+		return false;
+
+	rules.push_back(compiled);
+
+	return true;
+}
+
+bool CompiledFuzzyEngine::compileAntecedent(const fl::Expression * expression, std::vector<int> & result)
+{
+	if(auto proposition = dynamic_cast<const fl::Proposition *>(expression))
+	{
+		int index = findOrAddProposition(proposition);
+
+		if(index < 0)
+			return false;
+
+		result.push_back(index);
+
+		return true;
+	}
+
+	auto op = dynamic_cast<const fl::Operator *>(expression);
+
+	if(!op || op->name != fl::Rule::andKeyword())
+		return false;
+
+	return compileAntecedent(op->left, result) && compileAntecedent(op->right, result);
+}
+
+int CompiledFuzzyEngine::findOrAddProposition(const fl::Proposition * proposition)
+{
+	auto variable = dynamic_cast<const fl::InputVariable *>(proposition->variable);
+
+	if(!variable || !variable->isEnabled())
+		return -1;
+
+	Proposition compiled;
+
+	compiled.variable = variable;
+	compiled.term = proposition->term;
+
+	for(const fl::Hedge * hedge : proposition->hedges)
+	{
+		// "any" hedge ignores term membership, it is never used by AI rules
+		if(dynamic_cast<const fl::Any *>(hedge))
+			return -1;
+
+		compiled.hedges.push_back(hedge);
+	}
+
+	for(std::size_t i = 0; i < propositions.size(); i++)
+	{
+		const Proposition & existing = propositions[i];
+
+		if(existing.variable == compiled.variable && existing.term == compiled.term && existing.hedges == compiled.hedges)
+			return static_cast<int>(i);
+	}
+
+	propositions.push_back(compiled);
+
+	return static_cast<int>(propositions.size() - 1);
+}
+
+void CompiledFuzzyEngine::process()
+{
+	for(std::size_t i = 0; i < propositions.size(); i++)
+	{
+		const Proposition & proposition = propositions[i];
+		double degree = proposition.term->membership(proposition.variable->getValue());
+
+		// hedges are applied from the one closest to term, same as fl::Antecedent does
+		for(auto hedge = proposition.hedges.rbegin(); hedge != proposition.hedges.rend(); hedge++)
+			degree = (*hedge)->hedge(degree);
+
+		propositionDegrees[i] = degree;
+	}
+
+	// AlgebraicSum of activated terms is 1 - product(1 - activation * membership)
+	std::fill(complementProducts.begin(), complementProducts.end(), 1.0);
+
+	bool anyTriggered = false;
+
+	for(const Rule & rule : rules)
+	{
+		double activation = rule.weight;
+
+		for(int proposition : rule.propositions)
+			activation *= propositionDegrees[proposition];
+
+		if(!fl::Op::isGt(activation, 0.0))
+			continue;
+
+		anyTriggered = true;
+
+		const OutputTerm & term = outputTerms[rule.outputTerm];
+
+		for(std::size_t i = 0; i < term.points.size(); i++)
+			complementProducts[term.points[i]] *= 1.0 - activation * term.memberships[i];
+	}
+
+	if(!anyTriggered)
+	{
+		output->setValue(output->getDefaultValue());
+		return;
+	}
+
+	double area = 0;
+	double centroid = 0;
+
+	for(std::size_t i = 0; i < integrationPoints.size(); i++)
+	{
+		double membership = 1.0 - complementProducts[i];
+
+		centroid += membership * integrationPoints[i];
+		area += membership;
+	}
+
+	output->setValue(centroid / area);
+}
+
+double CompiledFuzzyEngine::compareWithInterpreter(int samplesCount, uint32_t seed)
+{
+	std::mt19937 rng(seed);
+	double maxDifference = 0;
+
+	for(int sample = 0; sample < samplesCount; sample++)
+	{
+		for(std::size_t i = 0; i < engine->numberOfInputVariables(); i++)
+		{
+			fl::InputVariable * variable = engine->getInputVariable(i);
+			std::uniform_real_distribution<double> distribution(variable->getMinimum(), variable->getMaximum());
+
+			variable->setValue(distribution(rng));
+		}
+
+		engine->process();
+		double interpreted = output->getValue();
+
+		process();
+		double compiled = output->getValue();
+
+		if(std::isnan(interpreted) || std::isnan(compiled))
+		{
+			if(std::isnan(interpreted) != std::isnan(compiled))
+				return std::numeric_limits<double>::infinity();
+
+			continue;
+		}
+
+		vstd::amax(maxDifference, std::abs(interpreted - compiled));
+	}
+
+	return maxDifference;
+}
+
+}
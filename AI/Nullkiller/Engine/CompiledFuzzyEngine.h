@@ -0,0 +1,79 @@
+/*
+* CompiledFuzzyEngine.h, part of VCMI engine
+*
+* Authors: listed in file AUTHORS in main folder
+*
+* License: GNU General Public License v2.0 or later
+* Full text of license available in license.txt file, in main folder
+*
+*/
+#pragma once
+#if __has_include(<fuzzylite/Headers.h>)
+#  include <fuzzylite/Headers.h>
+#else
+#  include <fl/Headers.h>
+#endif
+
+namespace NKAI
+{
+
+/// Evaluates rule base of fuzzylite engine without interpreting rule expressions on every call.
+/// Each distinct proposition is computed once per evaluation instead of once per rule, and output terms
+/// are sampled at centroid integration points in advance, so defuzzification only scales precomputed tables.
+/// Supports subset of fuzzylite used by AI: single output variable, conjunction-only antecedents,
+/// AlgebraicProduct conjunction and implication, AlgebraicSum aggregation and Centroid defuzzifier
+class CompiledFuzzyEngine
+{
+public:
+	/// Returns nullptr if engine uses features not supported by compiled evaluator
+	static std::unique_ptr<CompiledFuzzyEngine> compile(fl::Engine * engine);
+
+	/// Same as fl::Engine::process - reads current values of input variables and sets value of output variable
+	void process();
+
+	/// Evaluates random inputs within ranges of input variables by both compiled and interpreted engine
+	/// Returns largest absolute difference between results
+	double compareWithInterpreter(int samplesCount, uint32_t seed);
+
+private:
+	struct Proposition
+	{
+		const fl::InputVariable * variable;
+		const fl::Term * term;
+		std::vector<const fl::Hedge *> hedges;
+	};
+
+	struct Rule
+	{
+		std::vector<int> propositions;
+		double weight;
+		int outputTerm;
+	};
+
+	struct OutputTerm
+	{
+		/// Integration points where term membership is not zero and memberships in these points
+		std::vector<int> points;
+		std::vector<double> memberships;
+	};
+
+	fl::Engine * engine;
+	fl::OutputVariable * output;
+
+	std::vector<Proposition> propositions;
+	std::vector<Rule> rules;
+	std::vector<OutputTerm> outputTerms;
+	std::vector<double> integrationPoints;
+
+	std::vector<double> propositionDegrees;
+	std::vector<double> complementProducts;
+
+	explicit CompiledFuzzyEngine(fl::Engine * engine);
+
+	bool compileOutput(fl::OutputVariable * variable);
+	bool compileRule(const fl::Rule * rule, const fl::RuleBlock * ruleBlock);
+	bool compileAntecedent(const fl::Expression * expression, std::vector<int> & result);
+	int findOrAddProposition(const fl::Proposition * proposition);
+};
+
+}
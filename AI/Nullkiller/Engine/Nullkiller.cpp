@@ -33,6 +33,27 @@ using namespace Goals;
 #define MAXPASS 30
 #endif
 
+/// Worker threads of parallel algorithms do not have thread-local AI state of the thread that started them.
+/// Behaviors and goals rely on it, so it is shared with worker for the lifetime of each task
+struct ShareGlobalState
+{
+	AIGateway * previousAi;
+	CCallback * previousCb;
+
+	ShareGlobalState(AIGateway * sharedAi, CCallback * sharedCb)
+		: previousAi(ai), previousCb(cb)
+	{
+		ai = sharedAi;
+		cb = sharedCb;
+	}
+
+	~ShareGlobalState()
+	{
+		ai = previousAi;
+		cb = previousCb;
+	}
+};
+
 Nullkiller::Nullkiller()
 {
 	memory.reset(new AIMemory());
@@ -58,7 +79,6 @@ void Nullkiller::init(std::shared_ptr<CCallback> cb, PlayerColor playerID)
 	pathfinder.reset(new AIPathfinder(cb.get(), this));
 	armyManager.reset(new ArmyManager(cb.get(), this));
 	heroManager.reset(new HeroManager(cb.get(), this));
-	decomposer.reset(new DeepDecomposer());
 	armyFormation.reset(new ArmyFormation(cb, this));
 }
 
@@ -71,7 +91,29 @@ Goals::TTask Nullkiller::choseBestTask(Goals::TTaskVec & tasks) const
 	return bestTask;
 }
 
-Goals::TTask Nullkiller::choseBestTask(Goals::TSubgoal behavior, int decompositionMaxDepth) const
+Goals::TTaskVec Nullkiller::choseBestTasks(const std::vector<std::pair<Goals::TSubgoal, int>> & behaviors) const
+{
+	Goals::TTaskVec result(behaviors.size());
+	AIGateway * sharedAi = ai;
+
+	boost::this_thread::interruption_point();
+
+	// decomposition cache is not thread-safe so each task gets own decomposer
+	parallel_for(blocked_range<size_t>(0, behaviors.size(), 1), [&](const blocked_range<size_t> & r)
+	{
+		ShareGlobalState globalState(sharedAi, cb.get());
+		DeepDecomposer decomposer;
+
+		for(size_t i = r.begin(); i != r.end(); i++)
+		{
+			result[i] = choseBestTask(behaviors[i].first, behaviors[i].second, decomposer);
+		}
+	});
+
+	return result;
+}
+
+Goals::TTask Nullkiller::choseBestTask(Goals::TSubgoal behavior, int decompositionMaxDepth, DeepDecomposer & decomposer) const
 {
 	boost::this_thread::interruption_point();
 
@@ -79,20 +121,29 @@ Goals::TTask Nullkiller::choseBestTask(Goals::TSubgoal behavior, int decompositi
 
 	auto start = std::chrono::high_resolution_clock::now();
 	
-	Goals::TGoalVec elementarGoals = decomposer->decompose(behavior, decompositionMaxDepth);
-	Goals::TTaskVec tasks;
+	Goals::TGoalVec elementarGoals = decomposer.decompose(behavior, decompositionMaxDepth);
+	Goals::TTaskVec tasks(elementarGoals.size());
+	AIGateway * sharedAi = ai;
 
 	boost::this_thread::interruption_point();
-	
-	for(auto goal : elementarGoals)
+
+	// fuzzy engine is not thread-safe so each range takes own evaluator from pool
+	// tasks are stored by goal index so best task does not depend on scheduling
+	parallel_for(blocked_range<size_t>(0, elementarGoals.size()), [&](const blocked_range<size_t> & r)
 	{
-		Goals::TTask task = Goals::taskptr(*goal);
+		ShareGlobalState globalState(sharedAi, cb.get());
+		auto evaluator = priorityEvaluators->acquire();
 
-		if(task->priority <= 0)
-			task->priority = priorityEvaluator->evaluate(goal);
+		for(size_t i = r.begin(); i != r.end(); i++)
+		{
+			Goals::TTask task = Goals::taskptr(*elementarGoals[i]);
 
-		tasks.push_back(task);
-	}
+			if(task->priority <= 0)
+				task->priority = evaluator->evaluate(elementarGoals[i]);
+
+			tasks[i] = task;
+		}
+	});
 
 	if(tasks.empty())
 	{
@@ -136,7 +187,6 @@ void Nullkiller::updateAiState(int pass, bool fast)
 	activeHero = nullptr;
 	setTargetObject(-1);
 
-	decomposer->reset();
 	buildAnalyzer->update();
 
 	if(!fast)
@@ -228,8 +278,6 @@ HeroLockedReason Nullkiller::getHeroLockedReason(const CGHeroInstance * hero) co
 
 void Nullkiller::makeTurn()
 {
-	boost::lock_guard<boost::mutex> sharedStorageLock(AISharedStorage::locker);
-
 	const int MAX_DEPTH = 10;
 	const float FAST_TASK_MINIMAL_PRIORITY = 0.7f;
 
@@ -243,10 +291,10 @@ void Nullkiller::makeTurn()
 
 		for(;i <= MAXPASS; i++)
 		{
-			Goals::TTaskVec fastTasks = {
-				choseBestTask(sptr(BuyArmyBehavior()), 1),
-				choseBestTask(sptr(BuildingBehavior()), 1)
-			};
+			Goals::TTaskVec fastTasks = choseBestTasks({
+				{sptr(BuyArmyBehavior()), 1},
+				{sptr(BuildingBehavior()), 1}
+			});
 
 			bestTask = choseBestTask(fastTasks);
 
@@ -261,21 +309,24 @@ void Nullkiller::makeTurn()
 			}
 		}
 
-		Goals::TTaskVec bestTasks = {
-			bestTask,
-			choseBestTask(sptr(RecruitHeroBehavior()), 1),
-			choseBestTask(sptr(CaptureObjectsBehavior()), 1),
-			choseBestTask(sptr(ClusterBehavior()), MAX_DEPTH),
-			choseBestTask(sptr(DefenceBehavior()), MAX_DEPTH),
-			choseBestTask(sptr(GatherArmyBehavior()), MAX_DEPTH),
-			choseBestTask(sptr(StayAtTownBehavior()), MAX_DEPTH)
+		std::vector<std::pair<Goals::TSubgoal, int>> behaviors = {
+			{sptr(RecruitHeroBehavior()), 1},
+			{sptr(CaptureObjectsBehavior()), 1},
+			{sptr(ClusterBehavior()), MAX_DEPTH},
+			{sptr(DefenceBehavior()), MAX_DEPTH},
+			{sptr(GatherArmyBehavior()), MAX_DEPTH},
+			{sptr(StayAtTownBehavior()), MAX_DEPTH}
 		};
 
 		if(cb->getDate(Date::DAY) == 1)
 		{
-			bestTasks.push_back(choseBestTask(sptr(StartupBehavior()), 1));
+			behaviors.push_back({sptr(StartupBehavior()), 1});
 		}
 
+		// fast task goes first so it still wins ties as before
+		Goals::TTaskVec bestTasks = choseBestTasks(behaviors);
+		bestTasks.insert(bestTasks.begin(), bestTask);
+
 		bestTask = choseBestTask(bestTasks);
 
 		std::string taskDescription = bestTask->toString();
@@ -69,7 +69,6 @@ public:
 	std::unique_ptr<ArmyManager> armyManager;
 	std::unique_ptr<AIMemory> memory;
 	std::unique_ptr<FuzzyHelper> dangerEvaluator;
-	std::unique_ptr<DeepDecomposer> decomposer;
 	std::unique_ptr<ArmyFormation> armyFormation;
 	PlayerColor playerID;
 	std::shared_ptr<CCallback> cb;
@@ -98,7 +97,10 @@ public:
 private:
 	void resetAiState();
 	void updateAiState(int pass, bool fast = false);
-	Goals::TTask choseBestTask(Goals::TSubgoal behavior, int decompositionMaxDepth) const;
+	/// Evaluates behaviors concurrently. Each behavior is paired with its decomposition depth limit
+	/// Result contains best task of each behavior in the same order as behaviors
+	Goals::TTaskVec choseBestTasks(const std::vector<std::pair<Goals::TSubgoal, int>> & behaviors) const;
+	Goals::TTask choseBestTask(Goals::TSubgoal behavior, int decompositionMaxDepth, DeepDecomposer & decomposer) const;
 	Goals::TTask choseBestTask(Goals::TTaskVec & tasks) const;
 	void executeTask(Goals::TTask task);
 };
@@ -36,6 +36,8 @@ namespace NKAI
 #define MIN_AI_STRENGHT (0.5f) //lower when combat AI gets smarter
 #define UNGUARDED_OBJECT (100.0f) //we consider unguarded objects 100 times weaker than us
 const float MIN_CRITICAL_VALUE = 2.0f;
+const int COMPILED_ENGINE_CHECK_SAMPLES = 100;
+const double COMPILED_ENGINE_TOLERANCE = 1e-4;
 
 EvaluationContext::EvaluationContext(const Nullkiller * ai)
 	: movementCost(0.0),
@@ -89,6 +91,18 @@ void PriorityEvaluator::initVisitTile()
 	goldCostVariable = engine->getInputVariable("goldCost");
 	fearVariable = engine->getInputVariable("fear");
 	value = engine->getOutputVariable("Value");
+
+	compiledEngine = CompiledFuzzyEngine::compile(engine);
+
+	if(!compiledEngine)
+	{
+		logAi->debug("Priority rules use fuzzy logic features that can not be compiled, using interpreter");
+	}
+	else if(compiledEngine->compareWithInterpreter(COMPILED_ENGINE_CHECK_SAMPLES, 0) > COMPILED_ENGINE_TOLERANCE)
+	{
+		logAi->warn("Compiled priority rules do not match interpreter, using interpreter");
+		compiledEngine.reset();
+	}
 }
 
 bool isAnotherAi(const CGObjectInstance * obj, const CPlayerSpecificInfoCallback & cb)
@@ -1116,7 +1130,10 @@ float PriorityEvaluator::evaluate(Goals::TSubgoal task)
 		turnVariable->setValue(evaluationContext.turn);
 		fearVariable->setValue(evaluationContext.enemyHeroDangerRatio);
 
-		engine->process();
+		if(compiledEngine)
+			compiledEngine->process();
+		else
+			engine->process();
 
 		result = value->getValue();
 	}
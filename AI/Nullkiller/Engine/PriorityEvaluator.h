@@ -13,6 +13,7 @@
 #else
 #  include <fl/Headers.h>
 #endif
+#include "CompiledFuzzyEngine.h"
 #include "../Goals/CGoal.h"
 #include "../Pathfinding/AIPathfinder.h"
 
@@ -113,6 +114,7 @@ private:
 	fl::InputVariable * goldCostVariable;
 	fl::InputVariable * fearVariable;
 	fl::OutputVariable * value;
+	std::unique_ptr<CompiledFuzzyEngine> compiledEngine;
 	std::vector<std::shared_ptr<IEvaluationContextBuilder>> evaluationContextBuilders;
 
 	EvaluationContext buildEvaluationContext(Goals::TSubgoal goal) const;
@@ -24,12 +24,6 @@
 namespace NKAI
 {
 
-std::shared_ptr<boost::multi_array<AIPathNode, 5>> AISharedStorage::shared;
-boost::mutex AISharedStorage::locker;
-std::set<int3> commitedTiles;
-std::set<int3> commitedTilesInitial;
-
-
 const uint64_t FirstActorMask = 1;
 const uint64_t MIN_ARMY_STRENGTH_FOR_CHAIN = 5000;
 const uint64_t MIN_ARMY_STRENGTH_FOR_NEXT_ACTOR = 1000;
@@ -37,25 +31,6 @@ const uint64_t CHAIN_MAX_DEPTH = 4;
 
 const bool DO_NOT_SAVE_TO_COMMITED_TILES = false;
 
-AISharedStorage::AISharedStorage(int3 sizes)
-{
-	if(!shared){
-		shared.reset(new boost::multi_array<AIPathNode, 5>(
-			boost::extents[EPathfindingLayer::NUM_LAYERS][sizes.z][sizes.x][sizes.y][AIPathfinding::NUM_CHAINS]));
-	}
-
-	nodes = shared;
-}
-
-AISharedStorage::~AISharedStorage()
-{
-	nodes.reset();
-	if(shared && shared.use_count() == 1)
-	{
-		shared.reset();
-	}
-}
-
 void AIPathNode::addSpecialAction(std::shared_ptr<const SpecialAction> action)
 {
 	if(!specialAction)
@@ -78,7 +53,7 @@ void AIPathNode::addSpecialAction(std::shared_ptr<const SpecialAction> action)
 }
 
 AINodeStorage::AINodeStorage(const Nullkiller * ai, const int3 & Sizes)
-	: sizes(Sizes), ai(ai), cb(ai->cb.get()), nodes(Sizes)
+	: sizes(Sizes), ai(ai), cb(ai->cb.get()), nodes(AISharedStorage::lease(Sizes))
 {
 	dangerEvaluator.reset(new FuzzyHelper(ai));
 }
@@ -95,6 +70,8 @@ void AINodeStorage::initialize(const PathfinderOptions & options, const CGameSta
 	const auto & fow = static_cast<const CGameInfoCallback *>(gs)->getPlayerTeam(fowPlayer)->fogOfWarMap;
 	const int3 sizes = gs->getMapSize();
 
+	nodes->reset();
+
 	//Each thread gets different x, but an array of y located next to each other in memory
 
 	parallel_for(blocked_range<size_t>(0, sizes.x), [&](const blocked_range<size_t>& r)
@@ -152,9 +129,9 @@ std::optional<AIPathNode *> AINodeStorage::getOrCreateNode(
 {
 	int bucketIndex = ((uintptr_t)actor) % AIPathfinding::BUCKET_COUNT;
 	int bucketOffset = bucketIndex * AIPathfinding::BUCKET_SIZE;
-	auto chains = nodes.get(pos, layer);
+	auto chains = nodes->getOrCreate(pos, layer);
 
-	if(chains[0].blocked())
+	if(chains.empty())
 	{
 		return std::nullopt;
 	}
@@ -228,17 +205,7 @@ std::vector<CGPathNode *> AINodeStorage::getInitialNodes()
 
 void AINodeStorage::resetTile(const int3 & coord, EPathfindingLayer layer, EPathAccessibility accessibility)
 {
-	for(AIPathNode & heroNode : nodes.get(coord, layer))
-{
-		heroNode.actor = nullptr;
-		heroNode.danger = 0;
-		heroNode.manaCost = 0;
-		heroNode.specialAction.reset();
-		heroNode.armyLoss = 0;
-		heroNode.chainOther = nullptr;
-		heroNode.dayFlags = DayFlags::NONE;
-		heroNode.update(coord, layer, accessibility);
-	}
+	nodes->resetTile(coord, layer, accessibility);
 }
 
 void AINodeStorage::commit(CDestinationNodeInfo & destination, const PathNodeInfo & source)
@@ -346,9 +313,9 @@ bool AINodeStorage::increaseHeroChainTurnLimit()
 	{
 		foreach_tile_pos([&](const int3 & pos)
 		{
-			auto chains = nodes.get(pos, layer);
+			auto chains = nodes->get(pos, layer);
 
-			if(!chains[0].blocked())
+			if(!chains.empty())
 			{
 				for(AIPathNode & node : chains)
 				{
@@ -374,9 +341,9 @@ bool AINodeStorage::calculateHeroChainFinal()
 	{
 		foreach_tile_pos([&](const int3 & pos)
 		{
-			auto chains = nodes.get(pos, layer);
+			auto chains = nodes->get(pos, layer);
 
-			if(!chains[0].blocked())
+			if(!chains.empty())
 			{
 				for(AIPathNode & node : chains)
 				{
@@ -446,7 +413,7 @@ public:
 				auto chains = nodes.get(pos, layer);
 
 				// fast cut inactive nodes
-				if(chains[0].blocked())
+				if(chains.empty())
 					continue;
 
 				existingChains.clear();
@@ -533,7 +500,7 @@ bool AINodeStorage::calculateHeroChain()
 		parallel_for(blocked_range<size_t>(0, data.size()), [&](const blocked_range<size_t>& r)
 		{
 			//auto r = blocked_range<size_t>(0, data.size());
-			HeroChainCalculationTask task(*this, nodes, data, chainMask, heroChainTurn);
+			HeroChainCalculationTask task(*this, *nodes, data, chainMask, heroChainTurn);
 
 			task.execute(r);
 
@@ -547,7 +514,7 @@ bool AINodeStorage::calculateHeroChain()
 	else
 	{
 		auto r = blocked_range<size_t>(0, data.size());
-		HeroChainCalculationTask task(*this, nodes, data, chainMask, heroChainTurn);
+		HeroChainCalculationTask task(*this, *nodes, data, chainMask, heroChainTurn);
 
 		task.execute(r);
 		task.flushResult(heroChain);
@@ -1196,7 +1163,7 @@ void AINodeStorage::calculateTownPortalTeleportations(std::vector<CGPathNode *>
 bool AINodeStorage::hasBetterChain(const PathNodeInfo & source, CDestinationNodeInfo & destination) const
 {
 	auto pos = destination.coord;
-	auto chains = nodes.get(pos, EPathfindingLayer::LAND);
+	auto chains = nodes->get(pos, EPathfindingLayer::LAND);
 
 	return hasBetterChain(source.node, getAINode(destination.node), chains);
 }
@@ -1292,7 +1259,7 @@ bool AINodeStorage::hasBetterChain(
 
 bool AINodeStorage::isTileAccessible(const HeroPtr & hero, const int3 & pos, const EPathfindingLayer layer) const
 {
-	auto chains = nodes.get(pos, layer);
+	auto chains = nodes->get(pos, layer);
 
 	for(const AIPathNode & node : chains)
 	{
@@ -1312,31 +1279,36 @@ std::vector<AIPath> AINodeStorage::getChainInfo(const int3 & pos, bool isOnLand)
 
 	paths.reserve(AIPathfinding::NUM_CHAINS / 4);
 
-	auto chains = nodes.get(pos, isOnLand ? EPathfindingLayer::LAND : EPathfindingLayer::SAIL);
-
-	for(const AIPathNode & node : chains)
+	forEachPathSummary(pos, isOnLand, [&](const AIPathSummary & summary)
 	{
-		if(node.action == EPathNodeAction::UNKNOWN || !node.actor || !node.actor->hero)
-		{
-			continue;
-		}
+		paths.push_back(getChainInfo(summary.node));
+	});
 
-		AIPath path;
+	return paths;
+}
 
-		path.targetHero = node.actor->hero;
-		path.heroArmy = node.actor->creatureSet;
-		path.armyLoss = node.armyLoss;
-		path.targetObjectDanger = evaluateDanger(pos, path.targetHero, !node.actor->allowBattle);
-		path.targetObjectArmyLoss = evaluateArmyLoss(path.targetHero, path.heroArmy->getArmyStrength(), path.targetObjectDanger);
-		path.chainMask = node.actor->chainMask;
-		path.exchangeCount = node.actor->actorExchangeCount;
-		
-		fillChainInfo(&node, path, -1);
+AIPath AINodeStorage::getChainInfo(const AIPathNode * node) const
+{
+	AIPath path;
 
-		paths.push_back(path);
-	}
+	path.targetHero = node->actor->hero;
+	path.heroArmy = node->actor->creatureSet;
+	path.armyLoss = node->armyLoss;
+	path.targetObjectDanger = evaluateDanger(node->coord, path.targetHero, !node->actor->allowBattle);
+	path.targetObjectArmyLoss = evaluateArmyLoss(path.targetHero, path.heroArmy->getArmyStrength(), path.targetObjectDanger);
+	path.chainMask = node->actor->chainMask;
+	path.exchangeCount = node->actor->actorExchangeCount;
 
-	return paths;
+	fillChainInfo(node, path, -1);
+
+	return path;
+}
+
+bool AINodeStorage::isActionBlocked(const AIPathNode * node) const
+{
+	auto targetNode = node->theNodeBefore ? getAINode(node->theNodeBefore) : node;
+
+	return !node->specialAction->canAct(targetNode);
 }
 
 void AINodeStorage::fillChainInfo(const AIPathNode * node, AIPath & path, int parentIndex) const
@@ -1366,9 +1338,7 @@ void AINodeStorage::fillChainInfo(const AIPathNode * node, AIPath & path, int pa
 
 			if(pathNode.specialAction)
 			{
-				auto targetNode =node->theNodeBefore ?  getAINode(node->theNodeBefore) : node;
-
-				pathNode.actionIsBlocked = !pathNode.specialAction->canAct(targetNode);
+				pathNode.actionIsBlocked = isActionBlocked(node);
 			}
 
 			parentIndex = path.nodes.size();
@@ -1385,6 +1355,79 @@ AIPath::AIPath()
 {
 }
 
+AIPathSummary::AIPathSummary(const AINodeStorage * storage, const AIPathNode * node)
+	: storage(storage),
+	node(node),
+	targetHero(node->actor->hero),
+	heroArmy(node->actor->creatureSet)
+{
+}
+
+const AIPathNode * AIPathSummary::targetNode() const
+{
+	if(!node->chainOther)
+		return node;
+
+	// chained path starts with nodes of other hero, see AIPath::targetNode
+	const AIPathNode * first = nullptr;
+	const AIPathNode * second = nullptr;
+
+	storage->forEachChainNode(node, [&](const AIPathNode * chainNode) -> bool
+	{
+		if(first)
+		{
+			second = chainNode;
+			return true;
+		}
+
+		first = chainNode;
+		return false;
+	});
+
+	return first->actor->hero == targetHero || !second ? first : second;
+}
+
+float AIPathSummary::movementCost() const
+{
+	return targetNode()->getCost();
+}
+
+uint8_t AIPathSummary::turn() const
+{
+	return targetNode()->turns;
+}
+
+uint64_t AIPathSummary::getPathDanger() const
+{
+	return targetNode()->danger;
+}
+
+uint64_t AIPathSummary::getHeroStrength() const
+{
+	return targetHero->getFightingStrength() * heroArmy->getArmyStrength();
+}
+
+std::shared_ptr<const SpecialAction> AIPathSummary::getFirstBlockedAction() const
+{
+	// AIPath::getFirstBlockedAction looks from the path start which is the last stored node
+	std::shared_ptr<const SpecialAction> result;
+
+	storage->forEachChainNode(node, [&](const AIPathNode * chainNode) -> bool
+	{
+		if(chainNode->specialAction && storage->isActionBlocked(chainNode))
+			result = chainNode->specialAction;
+
+		return false;
+	});
+
+	return result;
+}
+
+AIPath AIPathSummary::toPath() const
+{
+	return storage->getChainInfo(node);
+}
+
 std::shared_ptr<const SpecialAction> AIPath::getFirstBlockedAction() const
 {
 	for(auto node = nodes.rbegin(); node != nodes.rend(); node++)
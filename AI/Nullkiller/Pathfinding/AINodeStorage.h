@@ -16,6 +16,8 @@
 #include "../../../lib/pathfinder/CGPathNode.h"
 #include "../../../lib/pathfinder/INodeStorage.h"
 #include "../../../lib/mapObjects/CGHeroInstance.h"
+#include <boost/range/iterator_range.hpp>
+#include <deque>
 #include "../AIUtility.h"
 #include "../Engine/FuzzyHelper.h"
 #include "../Goals/AbstractGoal.h"
@@ -124,6 +126,37 @@ struct AIPath
 	bool containsHero(const CGHeroInstance * hero) const;
 };
 
+class AINodeStorage;
+
+/// Lightweight view of path that reads node storage directly instead of copying path nodes.
+/// Answers the same questions as AIPath for the path summary, full path is built by toPath() only when needed.
+/// Valid only until next update of pathfinder storage
+struct AIPathSummary
+{
+	const AINodeStorage * storage;
+	const AIPathNode * node;
+	const CGHeroInstance * targetHero;
+	const CCreatureSet * heroArmy;
+
+	AIPathSummary(const AINodeStorage * storage, const AIPathNode * node);
+
+	/// Same node as AIPath::targetNode() of materialized path
+	const AIPathNode * targetNode() const;
+
+	float movementCost() const;
+
+	uint8_t turn() const;
+
+	/// Gets danger of path excluding danger of visiting the target object like creature bank
+	uint64_t getPathDanger() const;
+
+	uint64_t getHeroStrength() const;
+
+	std::shared_ptr<const SpecialAction> getFirstBlockedAction() const;
+
+	AIPath toPath() const;
+};
+
 struct ExchangeCandidate : public AIPathNode
 {
 	AIPathNode * carrierParent;
@@ -139,23 +172,77 @@ enum EHeroChainPass
 	FINAL // same as SINGLE but for heroes from CHAIN pass
 };
 
-class AISharedStorage
+/// Path nodes of single AI pathfinder.
+/// Chain slots are allocated only for tiles actually reached by some actor, so storage size depends on explored area
+/// rather than on map size. Storages are leased from process-wide pool, each AI owns its storage while leased,
+/// so several AI players can calculate paths at the same time. Memory of released storage is reused by next lease.
+class AISharedStorage : boost::noncopyable
 {
-	// 1 - layer (air, water, land)
-	// 2-4 - position on map[z][x][y]
-	// 5 - chain (normal, battle, spellcast and combinations)
-	static std::shared_ptr<boost::multi_array<AIPathNode, 5>> shared;
-	std::shared_ptr<boost::multi_array<AIPathNode, 5>> nodes;
 public:
-	static boost::mutex locker;
+	using ChainRange = boost::iterator_range<AIPathNode *>;
+
+	/// Returns storage for exclusive use of caller, storage is returned to pool when last pointer is destroyed
+	static std::shared_ptr<AISharedStorage> lease(const int3 & mapSize);
 
-	AISharedStorage(int3 mapSize);
-	~AISharedStorage();
+	/// Starts new version of storage: all chains are released and all tiles become blocked until reset
+	void reset();
+	void resetTile(const int3 & tile, EPathfindingLayer layer, EPathAccessibility accessibility);
+
+	bool isBlocked(const int3 & tile, EPathfindingLayer layer) const
+	{
+		const TileChains & chains = tiles[getTileIndex(tile, layer)];
 
+		return chains.version != version
+			|| chains.accessibility == EPathAccessibility::NOT_SET
+			|| chains.accessibility == EPathAccessibility::BLOCKED;
+	}
+
+	/// Chains of tile, empty if no actor has reached this tile yet
 	STRONG_INLINE
-	boost::detail::multi_array::sub_array<AIPathNode, 1> get(int3 tile, EPathfindingLayer layer) const
+	ChainRange get(const int3 & tile, EPathfindingLayer layer) const
 	{
-		return (*nodes)[layer][tile.z][tile.x][tile.y];
+		const TileChains & chains = tiles[getTileIndex(tile, layer)];
+		AIPathNode * first = chains.version == version ? chains.nodes.load(std::memory_order_acquire) : nullptr;
+
+		return first ? ChainRange(first, first + AIPathfinding::NUM_CHAINS) : ChainRange();
+	}
+
+	/// Same as get but allocates chains for reachable tile. Returns empty range for blocked tile
+	/// Thread-safe for concurrent calls on the same tile
+	ChainRange getOrCreate(const int3 & tile, EPathfindingLayer layer);
+
+private:
+	using ChainBlock = std::array<AIPathNode, AIPathfinding::NUM_CHAINS>;
+
+	struct TileChains
+	{
+		std::atomic<AIPathNode *> nodes;
+		uint32_t version;
+		EPathAccessibility accessibility;
+	};
+
+	static boost::mutex poolLocker;
+	static std::vector<std::unique_ptr<AISharedStorage>> pool;
+
+	int3 sizes;
+	/// tiles with other version are treated as never reset, this allows to skip clearing whole map on every reset
+	uint32_t version;
+	// layer, z, x, y
+	std::unique_ptr<TileChains[]> tiles;
+
+	boost::mutex blocksLocker;
+	/// deque never moves its elements, so node pointers stay valid while storage grows
+	std::deque<ChainBlock> blocks;
+	size_t usedBlocks;
+
+	AISharedStorage();
+
+	static void release(AISharedStorage * storage);
+
+	STRONG_INLINE
+	size_t getTileIndex(const int3 & tile, EPathfindingLayer layer) const
+	{
+		return ((static_cast<size_t>(layer) * sizes.z + tile.z) * sizes.x + tile.x) * sizes.y + tile.y;
 	}
 };
 
@@ -167,8 +254,11 @@ private:
 	const CPlayerSpecificInfoCallback * cb;
 	const Nullkiller * ai;
 	std::unique_ptr<FuzzyHelper> dangerEvaluator;
-	AISharedStorage nodes;
+	std::shared_ptr<AISharedStorage> nodes;
 	std::vector<std::shared_ptr<ChainActor>> actors;
+	/// tiles reached within current hero chain turn, input of next hero chain pass. Filled by const commit
+	mutable std::set<int3> commitedTiles;
+	std::set<int3> commitedTilesInitial;
 	std::vector<CGPathNode *> heroChain;
 	EHeroChainPass heroChainPass; // true if we need to calculate hero chain
 	uint64_t chainMask;
@@ -247,6 +337,48 @@ public:
 
 	std::optional<AIPathNode *> getOrCreateNode(const int3 & coord, const EPathfindingLayer layer, const ChainActor * actor);
 	std::vector<AIPath> getChainInfo(const int3 & pos, bool isOnLand) const;
+	AIPath getChainInfo(const AIPathNode * node) const;
+
+	/// Calls fn with AIPathSummary of each path to pos, does not allocate
+	template<typename Fn>
+	void forEachPathSummary(const int3 & pos, bool isOnLand, Fn && fn) const
+	{
+		auto chains = nodes->get(pos, isOnLand ? EPathfindingLayer::LAND : EPathfindingLayer::SAIL);
+
+		for(const AIPathNode & node : chains)
+		{
+			if(node.action == EPathNodeAction::UNKNOWN || !node.actor || !node.actor->hero)
+			{
+				continue;
+			}
+
+			fn(AIPathSummary(this, &node));
+		}
+	}
+
+	/// Visits nodes of path ending in node in the same order as fillChainInfo stores them in AIPath::nodes
+	/// Stops and returns true as soon as fn returns true
+	template<typename Fn>
+	bool forEachChainNode(const AIPathNode * node, Fn && fn) const
+	{
+		while(node != nullptr)
+		{
+			if(!node->actor->hero)
+				return false;
+
+			if(node->chainOther && forEachChainNode(node->chainOther, fn))
+				return true;
+
+			if(fn(node))
+				return true;
+
+			node = getAINode(node->theNodeBefore);
+		}
+
+		return false;
+	}
+
+	bool isActionBlocked(const AIPathNode * node) const;
 	bool isTileAccessible(const HeroPtr & hero, const int3 & pos, const EPathfindingLayer layer) const;
 	void setHeroes(std::map<const CGHeroInstance *, HeroRole> heroes);
 	void setScoutTurnDistanceLimit(uint8_t distanceLimit) { turnDistanceLimit[HeroRole::SCOUT] = distanceLimit; }
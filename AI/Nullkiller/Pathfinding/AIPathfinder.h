@@ -12,6 +12,7 @@
 
 #include "AINodeStorage.h"
 #include "../AIUtility.h"
+#include "../../../lib/mapping/CMapDefines.h"
 
 namespace NKAI
 {
@@ -41,6 +42,17 @@ private:
 public:
 	AIPathfinder(CPlayerSpecificInfoCallback * cb, Nullkiller * ai);
 	std::vector<AIPath> getPathInfo(const int3 & tile) const;
+
+	/// Calls fn with AIPathSummary of each path to tile. Much cheaper than getPathInfo when only path summary is needed
+	template<typename Fn>
+	void forEachPathSummary(const int3 & tile, Fn && fn) const
+	{
+		const TerrainTile * tileInfo = cb->getTile(tile, false);
+
+		if(tileInfo)
+			storage->forEachPathSummary(tile, !tileInfo->isWater(), fn);
+	}
+
 	bool isTileAccessible(const HeroPtr & hero, const int3 & tile) const;
 	void updatePaths(std::map<const CGHeroInstance *, HeroRole> heroes, PathfinderSettings pathfinderSettings);
 	void init();
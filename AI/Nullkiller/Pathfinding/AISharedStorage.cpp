@@ -0,0 +1,129 @@
+/*
+* AISharedStorage.cpp, part of VCMI engine
+*
+* Authors: listed in file AUTHORS in main folder
+*
+* License: GNU General Public License v2.0 or later
+* Full text of license available in license.txt file, in main folder
+*
+*/
+#include "StdInc.h"
+#include "AINodeStorage.h"
+
+namespace NKAI
+{
+
+boost::mutex AISharedStorage::poolLocker;
+std::vector<std::unique_ptr<AISharedStorage>> AISharedStorage::pool;
+
+AISharedStorage::AISharedStorage()
+	: sizes(0, 0, 0), version(0), usedBlocks(0)
+{
+}
+
+std::shared_ptr<AISharedStorage> AISharedStorage::lease(const int3 & mapSize)
+{
+	std::unique_ptr<AISharedStorage> storage;
+
+	{
+		boost::lock_guard<boost::mutex> poolLock(poolLocker);
+
+		if(!pool.empty())
+		{
+			storage = std::move(pool.back());
+			pool.pop_back();
+		}
+	}
+
+	if(!storage)
+		storage.reset(new AISharedStorage());
+
+	if(storage->sizes != mapSize)
+	{
+		// tile table is allocated on first reset
+		storage->sizes = mapSize;
+		storage->tiles.reset();
+		storage->blocks.clear();
+	}
+
+	storage->usedBlocks = 0;
+
+	return std::shared_ptr<AISharedStorage>(storage.release(), &AISharedStorage::release);
+}
+
+void AISharedStorage::release(AISharedStorage * storage)
+{
+	boost::lock_guard<boost::mutex> poolLock(poolLocker);
+
+	pool.emplace_back(storage);
+}
+
+void AISharedStorage::reset()
+{
+	if(!tiles)
+	{
+		tiles.reset(new TileChains[static_cast<size_t>(EPathfindingLayer::NUM_LAYERS) * sizes.z * sizes.x * sizes.y]());
+		version = 0;
+	}
+
+	version++;
+	usedBlocks = 0;
+}
+
+void AISharedStorage::resetTile(const int3 & tile, EPathfindingLayer layer, EPathAccessibility accessibility)
+{
+	TileChains & chains = tiles[getTileIndex(tile, layer)];
+
+	chains.nodes.store(nullptr, std::memory_order_relaxed);
+	chains.accessibility = accessibility;
+	chains.version = version;
+}
+
+AISharedStorage::ChainRange AISharedStorage::getOrCreate(const int3 & tile, EPathfindingLayer layer)
+{
+	auto existing = get(tile, layer);
+
+	if(!existing.empty())
+		return existing;
+
+	if(isBlocked(tile, layer))
+		return ChainRange();
+
+	TileChains & chains = tiles[getTileIndex(tile, layer)];
+	ChainBlock * block;
+
+	{
+		boost::lock_guard<boost::mutex> blocksLock(blocksLocker);
+
+		if(usedBlocks == blocks.size())
+			blocks.emplace_back();
+
+		block = &blocks[usedBlocks++];
+	}
+
+	for(AIPathNode & node : *block)
+	{
+		node.actor = nullptr;
+		node.danger = 0;
+		node.manaCost = 0;
+		node.specialAction.reset();
+		node.armyLoss = 0;
+		node.chainOther = nullptr;
+		node.dayFlags = DayFlags::NONE;
+		// block may be used by another tile before reset, so coordinates have to be set explicitly
+		node.reset();
+		node.coord = tile;
+		node.layer = layer;
+		node.accessible = chains.accessibility;
+	}
+
+	AIPathNode * expected = nullptr;
+
+	// another thread allocated chains for this tile first, our block stays unused until next reset
+	if(!chains.nodes.compare_exchange_strong(expected, block->data(), std::memory_order_acq_rel))
+		return ChainRange(expected, expected + AIPathfinding::NUM_CHAINS);
+
+	return ChainRange(block->data(), block->data() + AIPathfinding::NUM_CHAINS);
+}
+
+}
@@ -53,14 +53,14 @@ namespace Goals
 		{
 			int3 tile = int3(0, 0, ourPos.z);
 
-			const auto & slice = (*(ts->fogOfWarMap))[ourPos.z];
+			const auto & fow = *ts->fogOfWarMap;
 
 			for(tile.x = ourPos.x - scanRadius; tile.x <= ourPos.x + scanRadius; tile.x++)
 			{
 				for(tile.y = ourPos.y - scanRadius; tile.y <= ourPos.y + scanRadius; tile.y++)
 				{
 
-					if(cbp->isInTheMap(tile) && slice[tile.x][tile.y])
+					if(cbp->isInTheMap(tile) && fow.test(tile))
 					{
 						scanTile(tile);
 					}
@@ -81,13 +81,13 @@ namespace Goals
 
 			foreach_tile_pos([&](const int3 & pos)
 			{
-				if((*(ts->fogOfWarMap))[pos.z][pos.x][pos.y])
+				if(ts->fogOfWarMap->test(pos))
 				{
 					bool hasInvisibleNeighbor = false;
 
 					foreach_neighbour(cbp, pos, [&](CCallback * cbp, int3 neighbour)
 					{
-						if(!(*(ts->fogOfWarMap))[neighbour.z][neighbour.x][neighbour.y])
+						if(!ts->fogOfWarMap->test(neighbour))
 						{
 							hasInvisibleNeighbor = true;
 						}
@@ -171,7 +171,7 @@ namespace Goals
 			{
 				foreach_neighbour(cbp, tile, [&](CCallback * cbp, int3 neighbour)
 				{
-					if((*(ts->fogOfWarMap))[neighbour.z][neighbour.x][neighbour.y])
+					if(ts->fogOfWarMap->test(neighbour))
 					{
 						out.push_back(neighbour);
 					}
@@ -184,7 +184,7 @@ namespace Goals
 			int ret = 0;
 			int3 npos = int3(0, 0, pos.z);
 
-			const auto & slice = (*(ts->fogOfWarMap))[pos.z];
+			const auto & fow = *ts->fogOfWarMap;
 
 			for(npos.x = pos.x - sightRadius; npos.x <= pos.x + sightRadius; npos.x++)
 			{
@@ -192,7 +192,7 @@ namespace Goals
 				{
 					if(cbp->isInTheMap(npos)
 						&& pos.dist2d(npos) - 0.5 < sightRadius
-						&& !slice[npos.x][npos.y])
+						&& !fow.test(npos))
 					{
 						if(allowDeadEndCancellation
 							&& !hasReachableNeighbor(npos))
@@ -416,23 +416,17 @@ TSubgoal Explore::exploreNearestNeighbour(HeroPtr h) const
 	const float COST_LIMIT = .2f; //todo: fine tune
 
 	std::vector<const CGObjectInstance *> nearbyVisitableObjs;
-	for(int x = hpos.x - DIST_LIMIT; x <= hpos.x + DIST_LIMIT; ++x) //get only local objects instead of all possible objects on the map
+	//get only local objects instead of all possible objects on the map
+	for(auto obj : cb->getVisitableObjsInRect(hpos - int3(DIST_LIMIT, DIST_LIMIT, 0), hpos + int3(DIST_LIMIT, DIST_LIMIT, 0)))
 	{
-		for(int y = hpos.y - DIST_LIMIT; y <= hpos.y + DIST_LIMIT; ++y)
+		if(ai->isGoodForVisit(obj, h, COST_LIMIT))
 		{
-			for(auto obj : cb->getVisitableObjs(int3(x, y, hpos.z), false))
-			{
-				if(ai->isGoodForVisit(obj, h, COST_LIMIT))
-				{
-					nearbyVisitableObjs.push_back(obj);
-				}
-			}
+			nearbyVisitableObjs.push_back(obj);
 		}
 	}
 
 	if(nearbyVisitableObjs.size())
 	{
-		vstd::removeDuplicates(nearbyVisitableObjs); //one object may occupy multiple tiles
 		boost::sort(nearbyVisitableObjs, CDistanceSorter(h.get()));
 
 		TSubgoal pickupNearestObj = fh->chooseSolution(ai->ah->howToVisitObj(h, nearbyVisitableObjs.back(), false));
@@ -1715,14 +1715,16 @@ void VCAI::retrieveVisitableObjs(std::vector<const CGObjectInstance *> & out, bo
 
 void VCAI::retrieveVisitableObjs()
 {
-	foreach_tile_pos([&](const int3 & pos)
+	int3 mapSize = myCb->getMapSize();
+
+	for(int z = 0; z < mapSize.z; z++)
 	{
-		for(const CGObjectInstance * obj : myCb->getVisitableObjs(pos, false))
+		for(const CGObjectInstance * obj : myCb->getVisitableObjsInRect(int3(0, 0, z), int3(mapSize.x - 1, mapSize.y - 1, z)))
 		{
 			if(obj->tempOwner != playerID)
 				addVisitableObj(obj);
 		}
-	});
+	}
 }
 
 std::vector<const CGObjectInstance *> VCAI::getFlaggedObjects() const
@@ -338,7 +338,7 @@ int3 CCallback::getGuardingCreaturePosition(int3 tile)
 	if (!gs->map->isInTheMap(tile))
 		return int3(-1,-1,-1);
 
-	return gs->map->guardingCreaturePositions[tile.z][tile.x][tile.y];
+	return gs->map->guardingCreaturePosition(tile);
 }
 
 void CCallback::dig( const CGObjectInstance *hero )
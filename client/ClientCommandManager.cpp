@@ -11,6 +11,7 @@
 #include "ClientCommandManager.h"
 
 #include "Client.h"
+#include "adventureMap/AdventureMapInterface.h"
 #include "adventureMap/CInGameConsole.h"
 #include "CPlayerInterface.h"
 #include "PlayerLocalState.h"
@@ -427,6 +428,59 @@ void ClientCommandManager::handleCrashCommand()
 	//disaster!
 }
 
+void ClientCommandManager::handleBenchmarkCommand(std::istringstream& singleWordBuffer)
+{
+	std::string what;
+	int frames = 100;
+	singleWordBuffer >> what >> frames;
+
+	if(what != "map" || frames <= 0)
+	{
+		printCommandMessage("Usage: benchmark map <frames count>", ELogLevel::ERROR);
+		return;
+	}
+
+	boost::mutex::scoped_lock interfaceLock(GH.interfaceMutex);
+
+	if(!LOCPLINT || !adventureInt)
+	{
+		printCommandMessage("Adventure map is not active!", ELogLevel::ERROR);
+		return;
+	}
+
+	int3 mapSize = LOCPLINT->cb->getMapSize();
+	int64_t configuredThreads = settings["adventure"]["renderThreads"].Integer();
+
+	for(int64_t threads : {static_cast<int64_t>(1), configuredThreads})
+	{
+		{
+			Settings config = settings.write["adventure"]["renderThreads"];
+			config->Integer() = threads;
+		}
+
+		std::vector<double> frameTimes;
+		for(int frame = 0; frame < frames; ++frame)
+		{
+			// jump far enough so that every frame has to render all visible tiles again
+			adventureInt->centerOnTile(int3(frame * 37 % mapSize.x, frame * 23 % mapSize.y, 0));
+
+			auto timeStart = std::chrono::steady_clock::now();
+			GH.windows().totalRedraw();
+			GH.windows().simpleRedraw();
+			frameTimes.push_back(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - timeStart).count());
+		}
+
+		std::sort(frameTimes.begin(), frameTimes.end());
+		double average = std::accumulate(frameTimes.begin(), frameTimes.end(), 0.0) / frameTimes.size();
+
+		printCommandMessage(boost::str(boost::format("Map redraw, renderThreads = %d: average %.2f ms, median %.2f ms, worst %.2f ms\n")
+			% threads % average % frameTimes[frameTimes.size() / 2] % frameTimes.back()));
+	}
+
+	Settings config = settings.write["adventure"]["renderThreads"];
+	config->Integer() = configuredThreads;
+}
+
 void ClientCommandManager::printCommandMessage(const std::string &commandMessage, ELogLevel::ELogLevel messageType)
 {
 	switch(messageType)
@@ -546,6 +600,9 @@ void ClientCommandManager::processCommand(const std::string & message, bool call
 	else if(commandName == "crash")
 		handleCrashCommand();
 
+	else if(commandName == "benchmark")
+		handleBenchmarkCommand(singleWordBuffer);
+
 	else
 	{
 		if (!commandName.empty() && !vstd::iswithin(commandName[0], 0, ' ')) // filter-out debugger/IDE noise
@@ -81,6 +81,9 @@ class ClientCommandManager //take mantis #2292 issue about account if thinking a
 	// Crashes the game forcing an exception
 	void handleCrashCommand();
 
+	// Measures time of full adventure map redraws, with and without parallel tile rendering
+	void handleBenchmarkCommand(std::istringstream& singleWordBuffer);
+
 	// Prints in Chat the given message
 	void printCommandMessage(const std::string &commandMessage, ELogLevel::ELogLevel messageType = ELogLevel::NOT_SET);
 	void giveTurn(const PlayerColor &color);
@@ -173,6 +173,9 @@ void ApplyClientNetPackVisitor::visitSetMovePoints(SetMovePoints & pack)
 
 void ApplyClientNetPackVisitor::visitFoWChange(FoWChange & pack)
 {
+	// interfaces expect explicit list of tiles, expand bitmask only once for all of them
+	std::optional<std::unordered_set<int3>> tiles;
+
 	for(auto &i : cl.playerint)
 	{
 		if(cl.getPlayerRelations(i.first, pack.player) == PlayerRelations::SAME_PLAYER && pack.waitForDialogs && LOCPLINT == i.second.get())
@@ -181,10 +184,13 @@ void ApplyClientNetPackVisitor::visitFoWChange(FoWChange & pack)
 		}
 		if(cl.getPlayerRelations(i.first, pack.player) != PlayerRelations::ENEMIES)
 		{
+			if(!tiles)
+				tiles = pack.tiles.toSet();
+
 			if(pack.mode == ETileVisibility::REVEALED)
-				i.second->tileRevealed(pack.tiles);
+				i.second->tileRevealed(*tiles);
 			else
-				i.second->tileHidden(pack.tiles);
+				i.second->tileHidden(*tiles);
 		}
 	}
 	cl.invalidatePaths();
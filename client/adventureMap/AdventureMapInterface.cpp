@@ -352,6 +352,8 @@ void AdventureMapInterface::onMapTilesChanged(boost::optional<std::unordered_set
 		widget->getMinimap()->updateTiles(*positions);
 	else
 		widget->getMinimap()->update();
+
+	widget->getMapView()->onMapTilesChanged(positions);
 }
 
 void AdventureMapInterface::onHotseatWaitStarted(PlayerColor playerID)
@@ -398,6 +400,7 @@ void AdventureMapInterface::onCurrentPlayerChanged(PlayerColor playerID)
 
 	currentPlayerID = playerID;
 	widget->setPlayer(playerID);
+	widget->getMapView()->onMapTilesChanged(boost::none);
 }
 
 void AdventureMapInterface::onPlayerTurnStarted(PlayerColor playerID)
@@ -63,6 +63,12 @@ void GlobalLobbyClient::onPacketReceived(const std::shared_ptr<INetworkConnectio
 	if(json["type"].String() == "activeGameRooms")
 		return receiveActiveGameRooms(json);
 
+	if(json["type"].String() == "activeAccountsChanged")
+		return receiveActiveAccountsChanged(json);
+
+	if(json["type"].String() == "activeGameRoomsChanged")
+		return receiveActiveGameRoomsChanged(json);
+
 	if(json["type"].String() == "joinRoomSuccess")
 		return receiveJoinRoomSuccess(json);
 
@@ -148,20 +154,37 @@ void GlobalLobbyClient::receiveChatMessage(const JsonNode & json)
 		lobbyWindowPtr->onGameChatMessage(displayName, messageText, timeFormatted);
 }
 
+static GlobalLobbyAccount parseAccount(const JsonNode & jsonEntry)
+{
+	GlobalLobbyAccount account;
+
+	account.accountID = jsonEntry["accountID"].String();
+	account.displayName = jsonEntry["displayName"].String();
+	account.status = jsonEntry["status"].String();
+
+	return account;
+}
+
+static GlobalLobbyRoom parseRoom(const JsonNode & jsonEntry)
+{
+	GlobalLobbyRoom room;
+
+	room.gameRoomID = jsonEntry["gameRoomID"].String();
+	room.hostAccountID = jsonEntry["hostAccountID"].String();
+	room.hostAccountDisplayName = jsonEntry["hostAccountDisplayName"].String();
+	room.description = jsonEntry["description"].String();
+	room.playersCount = jsonEntry["playersCount"].Integer();
+	room.playersLimit = jsonEntry["playersLimit"].Integer();
+
+	return room;
+}
+
 void GlobalLobbyClient::receiveActiveAccounts(const JsonNode & json)
 {
 	activeAccounts.clear();
 
 	for (auto const & jsonEntry : json["accounts"].Vector())
-	{
-		GlobalLobbyAccount account;
-
-		account.accountID = jsonEntry["accountID"].String();
-		account.displayName = jsonEntry["displayName"].String();
-		account.status = jsonEntry["status"].String();
-
-		activeAccounts.push_back(account);
-	}
+		activeAccounts.push_back(parseAccount(jsonEntry));
 
 	auto lobbyWindowPtr = lobbyWindow.lock();
 	if(lobbyWindowPtr)
@@ -173,17 +196,64 @@ void GlobalLobbyClient::receiveActiveGameRooms(const JsonNode & json)
 	activeRooms.clear();
 
 	for (auto const & jsonEntry : json["gameRooms"].Vector())
+		activeRooms.push_back(parseRoom(jsonEntry));
+
+	auto lobbyWindowPtr = lobbyWindow.lock();
+	if(lobbyWindowPtr)
+		lobbyWindowPtr->onActiveRooms(activeRooms);
+}
+
+void GlobalLobbyClient::receiveActiveAccountsChanged(const JsonNode & json)
+{
+	for (auto const & jsonEntry : json["removed"].Vector())
 	{
-		GlobalLobbyRoom room;
+		vstd::erase_if(activeAccounts, [&jsonEntry](const GlobalLobbyAccount & account)
+		{
+			return account.accountID == jsonEntry.String();
+		});
+	}
 
-		room.gameRoomID = jsonEntry["gameRoomID"].String();
-		room.hostAccountID = jsonEntry["hostAccountID"].String();
-		room.hostAccountDisplayName = jsonEntry["hostAccountDisplayName"].String();
-		room.description = jsonEntry["description"].String();
-		room.playersCount = jsonEntry["playersCount"].Integer();
-		room.playersLimit = jsonEntry["playersLimit"].Integer();
+	for (auto const & jsonEntry : json["accounts"].Vector())
+	{
+		auto account = parseAccount(jsonEntry);
+		auto it = boost::range::find_if(activeAccounts, [&account](const GlobalLobbyAccount & entry)
+		{
+			return entry.accountID == account.accountID;
+		});
+
+		if (it != activeAccounts.end())
+			*it = account;
+		else
+			activeAccounts.push_back(account);
+	}
 
-		activeRooms.push_back(room);
+	auto lobbyWindowPtr = lobbyWindow.lock();
+	if(lobbyWindowPtr)
+		lobbyWindowPtr->onActiveAccounts(activeAccounts);
+}
+
+void GlobalLobbyClient::receiveActiveGameRoomsChanged(const JsonNode & json)
+{
+	for (auto const & jsonEntry : json["removed"].Vector())
+	{
+		vstd::erase_if(activeRooms, [&jsonEntry](const GlobalLobbyRoom & room)
+		{
+			return room.gameRoomID == jsonEntry.String();
+		});
+	}
+
+	for (auto const & jsonEntry : json["gameRooms"].Vector())
+	{
+		auto room = parseRoom(jsonEntry);
+		auto it = boost::range::find_if(activeRooms, [&room](const GlobalLobbyRoom & entry)
+		{
+			return entry.gameRoomID == room.gameRoomID;
+		});
+
+		if (it != activeRooms.end())
+			*it = room;
+		else
+			activeRooms.push_back(room);
 	}
 
 	auto lobbyWindowPtr = lobbyWindow.lock();
@@ -42,6 +42,8 @@ class GlobalLobbyClient final : public INetworkClientListener, boost::noncopyabl
 	void receiveChatMessage(const JsonNode & json);
 	void receiveActiveAccounts(const JsonNode & json);
 	void receiveActiveGameRooms(const JsonNode & json);
+	void receiveActiveAccountsChanged(const JsonNode & json);
+	void receiveActiveGameRoomsChanged(const JsonNode & json);
 	void receiveJoinRoomSuccess(const JsonNode & json);
 	void receiveInviteReceived(const JsonNode & json);
 
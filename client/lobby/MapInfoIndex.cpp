@@ -0,0 +1,158 @@
+/*
+ * MapInfoIndex.cpp, part of VCMI engine
+ *
+ * Authors: listed in file AUTHORS in main folder
+ *
+ * License: GNU General Public License v2.0 or later
+ * Full text of license available in license.txt file, in main folder
+ *
+ */
+#include "StdInc.h"
+
+#include "MapInfoIndex.h"
+
+#include "../../lib/StartInfo.h"
+#include "../../lib/VCMIDirs.h"
+#include "../../lib/campaign/CampaignState.h"
+#include "../../lib/filesystem/Filesystem.h"
+#include "../../lib/mapping/CMapHeader.h"
+#include "../../lib/rmg/CMapGenOptions.h"
+#include "../../lib/serializer/CLoadFile.h"
+#include "../../lib/serializer/CMemorySerializer.h"
+#include "../../lib/serializer/CSaveFile.h"
+
+static const std::string MAP_INDEX_MAGIC = "VCMIMAPIDX";
+
+static std::optional<boost::filesystem::path> getPhysicalPath(const ResourcePath & resource)
+{
+	return CResourceHandler::get()->getResourceName(resource);
+}
+
+static void copyMapInfo(const CMapInfo & source, CMapInfo & target)
+{
+	CMemorySerializer mem;
+	mem.oser & source;
+	mem.iser & target;
+}
+
+MapInfoIndex::MapInfoIndex(const boost::filesystem::path & indexFile)
+	: indexFile(indexFile)
+{
+}
+
+MapInfoIndex & MapInfoIndex::get()
+{
+	static MapInfoIndex index(VCMIDirs::get().userCachePath() / "mapIndex.bin");
+	static std::once_flag loaded;
+
+	std::call_once(loaded, [](){ index.load(); });
+	return index;
+}
+
+void MapInfoIndex::load()
+{
+	boost::mutex::scoped_lock lock(mutex);
+
+	entries.clear();
+	modified = false;
+
+	if(!boost::filesystem::exists(indexFile))
+		return;
+
+	try
+	{
+		CLoadFile file(indexFile);
+		file.checkMagicBytes(MAP_INDEX_MAGIC);
+		file >> entries;
+		logGlobal->debug("Loaded index of %d maps and saves", entries.size());
+	}
+	catch(const std::exception & e)
+	{
+		logGlobal->warn("Map index %s is outdated or damaged and will be rebuilt: %s", indexFile.string(), e.what());
+		entries.clear();
+	}
+}
+
+void MapInfoIndex::save()
+{
+	boost::mutex::scoped_lock lock(mutex);
+
+	if(!modified)
+		return;
+
+	vstd::erase_if(entries, [](const auto & entry)
+	{
+		return !boost::filesystem::exists(entry.first);
+	});
+
+	try
+	{
+		CSaveFile file(indexFile);
+		file.putMagicBytes(MAP_INDEX_MAGIC);
+		file << entries;
+		modified = false;
+	}
+	catch(const std::exception & e)
+	{
+		logGlobal->warn("Failed to write map index %s: %s", indexFile.string(), e.what());
+	}
+}
+
+bool MapInfoIndex::restore(const ResourcePath & resource, CMapInfo & info)
+{
+	auto path = getPhysicalPath(resource);
+	if(!path)
+		return false;
+
+	boost::system::error_code ec;
+	uintmax_t fileSize = boost::filesystem::file_size(*path, ec);
+	std::time_t lastWrite = boost::filesystem::last_write_time(*path, ec);
+	if(ec)
+		return false;
+
+	std::shared_ptr<CMapInfo> cached;
+	{
+		boost::mutex::scoped_lock lock(mutex);
+		auto it = entries.find(path->string());
+		if(it == entries.end() || it->second.fileSize != fileSize || it->second.lastWrite != lastWrite)
+			return false;
+		cached = it->second.info;
+	}
+
+	try
+	{
+		copyMapInfo(*cached, info);
+	}
+	catch(const std::exception & e)
+	{
+		logGlobal->warn("Failed to restore indexed header of %s: %s", resource.getName(), e.what());
+		return false;
+	}
+
+	// fields that are not serialized, same as in CMapInfo::mapInit / saveInit
+	info.originalFileURI = resource.getOriginalName();
+	info.fullFileURI = boost::filesystem::canonical(*path).string();
+	info.lastWrite = lastWrite;
+	return true;
+}
+
+void MapInfoIndex::store(const ResourcePath & resource, const CMapInfo & info)
+{
+	auto path = getPhysicalPath(resource);
+	if(!path)
+		return;
+
+	boost::system::error_code ec;
+	Entry entry;
+	entry.fileSize = boost::filesystem::file_size(*path, ec);
+	entry.lastWrite = boost::filesystem::last_write_time(*path, ec);
+	if(ec)
+		return;
+
+	entry.info = std::make_shared<CMapInfo>();
+	copyMapInfo(info, *entry.info);
+
+	boost::mutex::scoped_lock lock(mutex);
+	entries[path->string()] = entry;
+	modified = true;
+}
@@ -0,0 +1,60 @@
+/*
+ * MapInfoIndex.h, part of VCMI engine
+ *
+ * Authors: listed in file AUTHORS in main folder
+ *
+ * License: GNU General Public License v2.0 or later
+ * Full text of license available in license.txt file, in main folder
+ *
+ */
+#pragma once
+
+#include "../../lib/mapping/CMapInfo.h"
+
+VCMI_LIB_NAMESPACE_BEGIN
+class ResourcePath;
+VCMI_LIB_NAMESPACE_END
+
+/// Persistent cache of map and save headers shown in scenario selection lists
+/// Entries are keyed by physical file path and remain valid only while file size and modification time stay the same
+/// All methods are thread-safe
+class MapInfoIndex : boost::noncopyable
+{
+	struct Entry
+	{
+		uintmax_t fileSize = 0;
+		std::time_t lastWrite = 0;
+		std::shared_ptr<CMapInfo> info;
+
+		template <typename Handler> void serialize(Handler & h)
+		{
+			h & fileSize;
+			h & lastWrite;
+			if (!h.saving)
+				info = std::make_shared<CMapInfo>();
+			h & *info;
+		}
+	};
+
+	boost::filesystem::path indexFile;
+	std::map<std::string, Entry> entries;
+	boost::mutex mutex;
+	bool modified = false;
+
+public:
+	explicit MapInfoIndex(const boost::filesystem::path & indexFile);
+
+	/// Global index stored in user cache directory, loaded on first access
+	static MapInfoIndex & get();
+
+	/// Replaces content of index with data from disk. Outdated or damaged index is discarded
+	void load();
+	/// Writes index to disk if it was changed, dropping entries for files that no longer exist
+	void save();
+
+	/// Loads cached header of given resource into info
+	/// Returns false if resource was not indexed or was modified since then
+	bool restore(const ResourcePath & resource, CMapInfo & info);
+	/// Stores header of given resource, info must be initialized via mapInit or saveInit
+	void store(const ResourcePath & resource, const CMapInfo & info);
+};
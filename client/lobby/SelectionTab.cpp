@@ -12,6 +12,7 @@
 #include "SelectionTab.h"
 #include "CSelectionBase.h"
 #include "CLobbyScreen.h"
+#include "MapInfoIndex.h"
 
 #include "../CGameInfo.h"
 #include "../CPlayerInterface.h"
@@ -35,6 +36,7 @@
 #include "../../CCallback.h"
 
 #include "../../lib/CGeneralTextHandler.h"
+#include "../../lib/CThreadHelper.h"
 #include "../../lib/CConfigHandler.h"
 #include "../../lib/GameSettings.h"
 #include "../../lib/filesystem/Filesystem.h"
@@ -132,6 +134,81 @@ bool mapSorter::operator()(const std::shared_ptr<ElementInfo> aaa, const std::sh
 	}
 }
 
+MapInfoScanner::MapInfoScanner(std::vector<ResourcePath> files, Parser parser, Receiver receiver)
+	: files(std::move(files))
+	, parser(std::move(parser))
+	, receiver(std::move(receiver))
+	, nextFile(0)
+	, activeWorkers(0)
+	, cancelled(false)
+	, lastDispatch(std::chrono::steady_clock::now())
+	, aliveToken(std::make_shared<bool>(true))
+{
+	if(this->files.empty())
+		return;
+
+	size_t threadsCount = std::clamp<size_t>(boost::thread::hardware_concurrency(), 1, this->files.size());
+	activeWorkers = threadsCount;
+
+	for(size_t i = 0; i < threadsCount; ++i)
+		workers.emplace_back(&MapInfoScanner::processFiles, this);
+}
+
+MapInfoScanner::~MapInfoScanner()
+{
+	cancelled = true;
+	for(auto & worker : workers)
+		worker.join();
+}
+
+void MapInfoScanner::processFiles()
+{
+	setThreadName("MapInfoScanner");
+
+	// how often scanned entries are passed to the list. Less often means less resorting of the list
+	constexpr auto dispatchInterval = std::chrono::milliseconds(250);
+
+	while(!cancelled)
+	{
+		size_t index = nextFile++;
+		if(index >= files.size())
+			break;
+
+		auto info = parser(files[index]);
+
+		boost::mutex::scoped_lock lock(pendingMutex);
+		if(info)
+			pending.push_back(info);
+
+		if(!pending.empty() && std::chrono::steady_clock::now() - lastDispatch > dispatchInterval)
+			dispatchPending(false);
+	}
+
+	if(--activeWorkers == 0)
+	{
+		MapInfoIndex::get().save();
+
+		boost::mutex::scoped_lock lock(pendingMutex);
+		dispatchPending(true);
+	}
+}
+
+void MapInfoScanner::dispatchPending(bool finished)
+{
+	Items items;
+	std::swap(items, pending);
+	lastDispatch = std::chrono::steady_clock::now();
+
+	std::weak_ptr<bool> token = aliveToken;
+	auto callback = receiver;
+
+	GH.dispatchMainThread([token, callback, items, finished]()
+	{
+		if(token.lock())
+			callback(items, finished);
+	});
+}
+
 // pick sorting order based on selection
 static ESortBy getSortBySelectionScreen(ESelectionScreen Type)
 {
@@ -238,6 +315,8 @@ SelectionTab::SelectionTab(ESelectionScreen Type)
 
 void SelectionTab::toggleMode()
 {
+	scanner.reset();
+
 	if(CSH->isGuest())
 	{
 		allItems.clear();
@@ -703,18 +782,31 @@ void SelectionTab::rememberCurrentSelection()
 
 void SelectionTab::restoreLastSelection()
 {
+	std::string lastSelection;
 	switch(tabType)
 	{
 	case ESelectionScreen::newGame:
-		selectFileName(settings["general"]["lastMap"].String());
+		lastSelection = settings["general"]["lastMap"].String();
 		break;
 	case ESelectionScreen::campaignList:
-		selectFileName(settings["general"]["lastCampaign"].String());
+		lastSelection = settings["general"]["lastCampaign"].String();
 		break;
 	case ESelectionScreen::loadGame:
 	case ESelectionScreen::saveGame:
-		selectFileName(settings["general"]["lastSave"].String());
+		lastSelection = settings["general"]["lastSave"].String();
 	}
+
+	// selected file may be not scanned yet, do not replace it with first available file
+	if(scanner && !hasItem(lastSelection))
+		return;
+
+	selectFileName(lastSelection);
+}
+
+bool SelectionTab::hasItem(std::string fname) const
+{
+	boost::to_upper(fname);
+	return boost::range::find_if(allItems, [&fname](std::shared_ptr<ElementInfo> e) { return e->fileURI == fname; }) != allItems.end();
 }
 
 bool SelectionTab::isMapSupported(const CMapInfo & info)
@@ -741,62 +833,134 @@ void SelectionTab::parseMaps(const std::unordered_set<ResourcePath> & files)
 {
 	logGlobal->debug("Parsing %d maps", files.size());
 	allItems.clear();
+
+	std::vector<ResourcePath> filesToScan;
 	for(auto & file : files)
+	{
+		auto mapInfo = std::make_shared<ElementInfo>();
+		if(MapInfoIndex::get().restore(file, *mapInfo))
+			addItem(mapInfo);
+		else
+			filesToScan.push_back(file);
+	}
+
+	logGlobal->debug("%d maps are not indexed and will be parsed in background", filesToScan.size());
+	if(filesToScan.empty())
+		return;
+
+	auto parser = [](const ResourcePath & file) -> std::shared_ptr<ElementInfo>
 	{
 		try
 		{
 			auto mapInfo = std::make_shared<ElementInfo>();
 			mapInfo->mapInit(file.getName());
-
-			if (isMapSupported(*mapInfo))
-				allItems.push_back(mapInfo);
+			MapInfoIndex::get().store(file, *mapInfo);
+			return mapInfo;
 		}
 		catch(std::exception & e)
 		{
 			logGlobal->error("Map %s is invalid. Message: %s", file.getName(), e.what());
+			return nullptr;
 		}
-	}
+	};
+
+	scanner = std::make_unique<MapInfoScanner>(filesToScan, parser, std::bind(&SelectionTab::addScannedItems, this, _1, _2));
 }
 
 void SelectionTab::parseSaves(const std::unordered_set<ResourcePath> & files)
 {
+	std::vector<ResourcePath> filesToScan;
 	for(auto & file : files)
+	{
+		auto mapInfo = std::make_shared<ElementInfo>();
+		if(MapInfoIndex::get().restore(file, *mapInfo))
+			addItem(mapInfo);
+		else
+			filesToScan.push_back(file);
+	}
+
+	if(filesToScan.empty())
+		return;
+
+	auto parser = [](const ResourcePath & file) -> std::shared_ptr<ElementInfo>
 	{
 		try
 		{
 			auto mapInfo = std::make_shared<ElementInfo>();
 			mapInfo->saveInit(file);
-
-			// Filter out other game modes
-			bool isCampaign = mapInfo->scenarioOptionsOfSave->mode == EStartMode::CAMPAIGN;
-			bool isMultiplayer = mapInfo->amountOfHumanPlayersInSave > 1;
-			bool isTutorial = boost::to_upper_copy(mapInfo->scenarioOptionsOfSave->mapname) == "MAPS/TUTORIAL";
-			switch(CSH->getLoadMode())
-			{
-			case ELoadMode::SINGLE:
-				if(isMultiplayer || isCampaign || isTutorial)
-					mapInfo->mapHeader.reset();
-				break;
-			case ELoadMode::CAMPAIGN:
-				if(!isCampaign)
-					mapInfo->mapHeader.reset();
-				break;
-			case ELoadMode::TUTORIAL:
-				if(!isTutorial)
-					mapInfo->mapHeader.reset();
-				break;
-			default:
-				if(!isMultiplayer)
-					mapInfo->mapHeader.reset();
-				break;
-			}
-
-			allItems.push_back(mapInfo);
+			MapInfoIndex::get().store(file, *mapInfo);
+			return mapInfo;
 		}
 		catch(const std::exception & e)
 		{
 			logGlobal->error("Error: Failed to process %s: %s", file.getName(), e.what());
+			return nullptr;
 		}
+	};
+
+	scanner = std::make_unique<MapInfoScanner>(filesToScan, parser, std::bind(&SelectionTab::addScannedItems, this, _1, _2));
+}
+
+void SelectionTab::addItem(std::shared_ptr<ElementInfo> mapInfo)
+{
+	if(tabType == ESelectionScreen::newGame)
+	{
+		if (isMapSupported(*mapInfo))
+			allItems.push_back(mapInfo);
+		return;
+	}
+
+	// Filter out other game modes
+	bool isCampaign = mapInfo->scenarioOptionsOfSave->mode == EStartMode::CAMPAIGN;
+	bool isMultiplayer = mapInfo->amountOfHumanPlayersInSave > 1;
+	bool isTutorial = boost::to_upper_copy(mapInfo->scenarioOptionsOfSave->mapname) == "MAPS/TUTORIAL";
+	switch(CSH->getLoadMode())
+	{
+	case ELoadMode::SINGLE:
+		if(isMultiplayer || isCampaign || isTutorial)
+			mapInfo->mapHeader.reset();
+		break;
+	case ELoadMode::CAMPAIGN:
+		if(!isCampaign)
+			mapInfo->mapHeader.reset();
+		break;
+	case ELoadMode::TUTORIAL:
+		if(!isTutorial)
+			mapInfo->mapHeader.reset();
+		break;
+	default:
+		if(!isMultiplayer)
+			mapInfo->mapHeader.reset();
+		break;
+	}
+
+	allItems.push_back(mapInfo);
+}
+
+void SelectionTab::addScannedItems(const MapInfoScanner::Items & items, bool finished)
+{
+	if(finished)
+		scanner.reset();
+
+	auto selected = getSelectedMapInfo();
+
+	for(const auto & item : items)
+		addItem(item);
+
+	filter(-1);
+
+	if(selected)
+	{
+		// keep selection on the same entry after list was resorted
+		auto it = boost::range::find(curItems, selected);
+		if(it != curItems.end())
+			selectionPos = it - curItems.begin();
+		updateListItems();
+		redraw();
+	}
+	else
+	{
+		restoreLastSelection();
 	}
 }
 
@@ -35,6 +35,40 @@ public:
 	bool isFolder = false;
 };
 
+/// Reads headers of maps or saves on background threads and passes them to the main thread in batches
+class MapInfoScanner : boost::noncopyable
+{
+public:
+	using Items = std::vector<std::shared_ptr<ElementInfo>>;
+	/// Called on worker thread, returns nullptr if file is not valid
+	using Parser = std::function<std::shared_ptr<ElementInfo>(const ResourcePath &)>;
+	/// Called on main thread
+	using Receiver = std::function<void(const Items & items, bool finished)>;
+
+	MapInfoScanner(std::vector<ResourcePath> files, Parser parser, Receiver receiver);
+	~MapInfoScanner();
+
+private:
+	std::vector<ResourcePath> files;
+	Parser parser;
+	Receiver receiver;
+
+	std::atomic<size_t> nextFile;
+	std::atomic<size_t> activeWorkers;
+	std::atomic<bool> cancelled;
+
+	boost::mutex pendingMutex;
+	Items pending;
+	std::chrono::steady_clock::time_point lastDispatch;
+
+	/// Receiver calls that were queued on main thread are dropped once scanner is destroyed
+	std::shared_ptr<bool> aliveToken;
+	std::vector<boost::thread> workers;
+
+	void processFiles();
+	void dispatchPending(bool finished);
+};
+
 /// Class which handles map sorting by different criteria
 class mapSorter
 {
@@ -113,6 +147,7 @@ private:
 	std::shared_ptr<CLabel> labelMapSizes;
 	ESelectionScreen tabType;
 	Rect inputNameRect;
+	std::unique_ptr<MapInfoScanner> scanner;
 
 	auto checkSubfolder(std::string path);
 
@@ -120,5 +155,8 @@ private:
 	void parseMaps(const std::unordered_set<ResourcePath> & files);
 	void parseSaves(const std::unordered_set<ResourcePath> & files);
 	void parseCampaigns(const std::unordered_set<ResourcePath> & files);
+	void addItem(std::shared_ptr<ElementInfo> info);
+	void addScannedItems(const MapInfoScanner::Items & items, bool finished);
+	bool hasItem(std::string fname) const;
 	std::unordered_set<ResourcePath> getFiles(std::string dirURI, EResType resType);
 };
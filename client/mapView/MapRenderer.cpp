@@ -172,6 +172,11 @@ uint8_t MapRendererTerrain::checksum(IMapRendererContext & context, const int3 &
 	return 0xff - 1;
 }
 
+bool MapRendererTerrain::animated(IMapRendererContext & context, const int3 & coordinates)
+{
+	return !context.getMapTile(coordinates).terType->paletteAnimation.empty();
+}
+
 MapRendererRiver::MapRendererRiver()
 	: storage(VLC->riverTypeHandler->objects.size())
 {
@@ -209,6 +214,11 @@ uint8_t MapRendererRiver::checksum(IMapRendererContext & context, const int3 & c
 	return 0xff-1;
 }
 
+bool MapRendererRiver::animated(IMapRendererContext & context, const int3 & coordinates)
+{
+	return !context.getMapTile(coordinates).riverType->paletteAnimation.empty();
+}
+
 MapRendererRoad::MapRendererRoad()
 	: storage(VLC->roadTypeHandler->objects.size())
 {
@@ -526,6 +536,41 @@ void MapRendererObjects::renderTile(IMapRendererContext & context, Canvas & targ
 	}
 }
 
+bool MapRendererObjects::animated(IMapRendererContext & context, const int3 & coordinates)
+{
+	for(const auto & objectID : context.getObjects(coordinates))
+	{
+		const auto * objectInstance = context.getObject(objectID);
+
+		if(!objectInstance)
+			continue;
+
+		size_t groupIndex = context.objectGroupIndex(objectInstance->id);
+
+		for(const auto & animation : {getBaseAnimation(objectInstance), getFlagAnimation(objectInstance), getOverlayAnimation(objectInstance)})
+		{
+			if(animation && animation->size(groupIndex) > 1)
+				return true;
+		}
+	}
+	return false;
+}
+
+void MapRendererObjects::preloadTile(IMapRendererContext & context, const int3 & coordinates)
+{
+	for(const auto & objectID : context.getObjects(coordinates))
+	{
+		const auto * objectInstance = context.getObject(objectID);
+
+		if(!objectInstance)
+			continue;
+
+		getBaseAnimation(objectInstance);
+		getFlagAnimation(objectInstance);
+		getOverlayAnimation(objectInstance);
+	}
+}
+
 uint8_t MapRendererObjects::checksum(IMapRendererContext & context, const int3 & coordinates)
 {
 	for(const auto & objectID : context.getObjects(coordinates))
@@ -761,6 +806,31 @@ MapRenderer::TileChecksum MapRenderer::getTileChecksum(IMapRendererContext & con
 	return result;
 }
 
+bool MapRenderer::tileAnimated(IMapRendererContext & context, const int3 & coordinates)
+{
+	if(!context.isInMap(coordinates))
+		return false;
+
+	const NeighborTilesInfo neighborInfo(context, coordinates);
+
+	if(!context.isVisible(coordinates) && neighborInfo.areAllHidden())
+		return false;
+
+	if(rendererTerrain.animated(context, coordinates))
+		return true;
+
+	if(context.showRivers() && rendererRiver.animated(context, coordinates))
+		return true;
+
+	return rendererObjects.animated(context, coordinates);
+}
+
+void MapRenderer::preloadTile(IMapRendererContext & context, const int3 & coordinates)
+{
+	if(context.isInMap(coordinates))
+		rendererObjects.preloadTile(context, coordinates);
+}
+
 void MapRenderer::renderTile(IMapRendererContext & context, Canvas & target, const int3 & coordinates)
 {
 	if(!context.isInMap(coordinates))
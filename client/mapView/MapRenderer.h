@@ -44,6 +44,7 @@ public:
 	MapRendererTerrain();
 
 	uint8_t checksum(IMapRendererContext & context, const int3 & coordinates);
+	bool animated(IMapRendererContext & context, const int3 & coordinates);
 	void renderTile(IMapRendererContext & context, Canvas & target, const int3 & coordinates);
 };
 
@@ -55,6 +56,7 @@ public:
 	MapRendererRiver();
 
 	uint8_t checksum(IMapRendererContext & context, const int3 & coordinates);
+	bool animated(IMapRendererContext & context, const int3 & coordinates);
 	void renderTile(IMapRendererContext & context, Canvas & target, const int3 & coordinates);
 };
 
@@ -86,6 +88,8 @@ class MapRendererObjects
 
 public:
 	uint8_t checksum(IMapRendererContext & context, const int3 & coordinates);
+	bool animated(IMapRendererContext & context, const int3 & coordinates);
+	void preloadTile(IMapRendererContext & context, const int3 & coordinates);
 	void renderTile(IMapRendererContext & context, Canvas & target, const int3 & coordinates);
 };
 
@@ -159,5 +163,12 @@ public:
 
 	TileChecksum getTileChecksum(IMapRendererContext & context, const int3 & coordinates);
 
+	/// returns true if tile contains animated images, so its checksum may change without any changes to map or context settings
+	bool tileAnimated(IMapRendererContext & context, const int3 & coordinates);
+
+	/// loads all animations that are required to render this tile
+	/// after this call renderTile will not modify renderer state and can be called in parallel with other renderers
+	void preloadTile(IMapRendererContext & context, const int3 & coordinates);
+
 	void renderTile(IMapRendererContext & context, Canvas & target, const int3 & coordinates);
 };
@@ -209,6 +209,26 @@ void MapView::onViewMapActivated()
 	controller->setTileSize(Point(32, 32));
 }
 
+void MapView::onMapTilesChanged(boost::optional<std::unordered_set<int3>> positions)
+{
+	if(!positions)
+	{
+		tilesCache->invalidateAll();
+		return;
+	}
+
+	for(const auto & tile : *positions)
+	{
+		if(tile.z != model->getLevel())
+			continue;
+
+		// fog of war on tile depends on visibility of its neighbours
+		for(int dy = -1; dy <= 1; ++dy)
+			for(int dx = -1; dx <= 1; ++dx)
+				tilesCache->invalidate(tile + int3(dx, dy, 0));
+	}
+}
+
 PuzzleMapView::PuzzleMapView(const Point & offset, const Point & dimensions, const int3 & tileToCenter)
 	: BasicMapView(offset, dimensions)
 {
@@ -91,6 +91,9 @@ public:
 
 	/// Switches view from View World mode back to standard view
 	void onViewMapActivated();
+
+	/// Invalidates cached images of specified tiles, or of entire map if no tiles are specified
+	void onMapTilesChanged(boost::optional<std::unordered_set<int3>> positions);
 };
 
 /// Main class that represents map view for puzzle map
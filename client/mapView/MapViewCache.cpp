@@ -22,10 +22,26 @@
 
 #include "../gui/CGuiHandler.h"
 
+#include "../../lib/CConfigHandler.h"
+
 #include "../../lib/mapObjects/CObjectHandler.h"
+#include "../../lib/pathfinder/CGPathNode.h"
 #include "../../lib/int3.h"
 
-MapViewCache::~MapViewCache() = default;
+/// Tiles rendered by additional threads are placed into staging canvas in rows of this size
+static constexpr size_t stagingColumns = 16;
+
+MapViewCache::~MapViewCache()
+{
+	{
+		boost::lock_guard<boost::mutex> lock(renderWorkersMutex);
+		renderWorkersStopping = true;
+	}
+	renderWorkersCondition.notify_all();
+
+	for(auto & worker : renderWorkers)
+		worker.join();
+}
 
 MapViewCache::MapViewCache(const std::shared_ptr<MapViewModel> & model)
 	: model(model)
@@ -43,6 +59,7 @@ MapViewCache::MapViewCache(const std::shared_ptr<MapViewModel> & model)
 	Point visibleSize = model->getTilesVisibleDimensions();
 	terrainChecksum.resize(boost::extents[visibleSize.x][visibleSize.y]);
 	tilesUpToDate.resize(boost::extents[visibleSize.x][visibleSize.y]);
+	tilesChecked.resize(boost::extents[visibleSize.x][visibleSize.y]);
 }
 
 Canvas MapViewCache::getTile(const int3 & coordinates)
@@ -70,12 +87,66 @@ void MapViewCache::invalidate(const std::shared_ptr<IMapRendererContext> & conte
 			int3 tile(entry.tileX, entry.tileY, cachedLevel);
 
 			if(context->isInMap(tile) && vstd::contains(context->getObjects(tile), object))
+			{
 				entry = TileChecksum{};
+				tilesChecked[cacheX][cacheY] = false;
+			}
 		}
 	}
 }
 
-void MapViewCache::updateTile(const std::shared_ptr<IMapRendererContext> & context, const int3 & coordinates)
+void MapViewCache::invalidate(const int3 & tile)
+{
+	int cacheX = (terrainChecksum.shape()[0] + tile.x) % terrainChecksum.shape()[0];
+	int cacheY = (terrainChecksum.shape()[1] + tile.y) % terrainChecksum.shape()[1];
+
+	terrainChecksum[cacheX][cacheY] = TileChecksum{};
+	tilesChecked[cacheX][cacheY] = false;
+}
+
+void MapViewCache::invalidateAll()
+{
+	std::fill(tilesChecked.data(), tilesChecked.data() + tilesChecked.num_elements(), false);
+}
+
+bool MapViewCache::updateContextState(const std::shared_ptr<IMapRendererContext> & context)
+{
+	std::array<bool, 7> contextFlags = {
+		context->filterGrayscale(),
+		context->showRoads(),
+		context->showRivers(),
+		context->showBorder(),
+		context->showGrid(),
+		context->showVisitable(),
+		context->showBlocked()
+	};
+
+	std::vector<std::tuple<int3, int, int>> path;
+	if(const auto * currentPath = context->currentPath())
+	{
+		for(const auto & node : currentPath->nodes)
+			path.emplace_back(node.coord, node.turns, static_cast<int>(node.action));
+	}
+
+	// expired pointer means that context was replaced, even if new one was allocated at same address
+	bool contextChanged = cachedContext.lock() != context || contextFlags != cachedContextFlags;
+
+	if(!contextChanged && path != cachedPath)
+	{
+		for(const auto & node : cachedPath)
+			invalidate(std::get<0>(node));
+		for(const auto & node : path)
+			invalidate(std::get<0>(node));
+	}
+
+	cachedContext = context;
+	cachedContextFlags = contextFlags;
+	cachedPath = std::move(path);
+
+	return contextChanged || settings["session"]["checksumMapTiles"].Bool();
+}
+
+bool MapViewCache::checkTile(const std::shared_ptr<IMapRendererContext> & context, const int3 & coordinates)
 {
 	int cacheX = (terrainChecksum.shape()[0] + coordinates.x) % terrainChecksum.shape()[0];
 	int cacheY = (terrainChecksum.shape()[1] + coordinates.y) % terrainChecksum.shape()[1];
@@ -87,26 +158,150 @@ void MapViewCache::updateTile(const std::shared_ptr<IMapRendererContext> & conte
 	newCacheEntry.tileY = coordinates.y;
 	newCacheEntry.checksum = mapRenderer->getTileChecksum(*context, coordinates);
 
-	if(cachedLevel == coordinates.z && oldCacheEntry == newCacheEntry && !context->tileAnimated(coordinates))
-		return;
+	bool tileAnimated = context->tileAnimated(coordinates);
+	tilesChecked[cacheX][cacheY] = !tileAnimated && !mapRenderer->tileAnimated(*context, coordinates);
+
+	if(cachedLevel == coordinates.z && oldCacheEntry == newCacheEntry && !tileAnimated)
+		return false;
 
-	Canvas target = getTile(coordinates);
+	oldCacheEntry = newCacheEntry;
+	tilesUpToDate[cacheX][cacheY] = false;
+	return true;
+}
 
+void MapViewCache::renderTile(MapRenderer & renderer, Canvas & intermediateCanvas, IMapRendererContext & context, const int3 & coordinates, Canvas & target)
+{
 	if(model->getSingleTileSize() == Point(32, 32))
 	{
-		mapRenderer->renderTile(*context, target, coordinates);
+		renderer.renderTile(context, target, coordinates);
 	}
 	else
 	{
-		mapRenderer->renderTile(*context, *intermediate, coordinates);
-		target.drawScaled(*intermediate, Point(0, 0), model->getSingleTileSize());
+		renderer.renderTile(context, intermediateCanvas, coordinates);
+		target.drawScaled(intermediateCanvas, Point(0, 0), model->getSingleTileSize());
 	}
 
-	if(context->filterGrayscale())
+	if(context.filterGrayscale())
 		target.applyGrayscale();
+}
 
-	oldCacheEntry = newCacheEntry;
-	tilesUpToDate[cacheX][cacheY] = false;
+size_t MapViewCache::getRenderBandsCount(size_t tilesCount) const
+{
+	// below this amount of tiles per thread, overhead of waking up threads is larger than gain from them
+	static constexpr size_t minTilesPerBand = 64;
+	// each band keeps its own copy of all map images, should match maximum of renderThreads in settings schema
+	static constexpr size_t maxBands = 4;
+
+	int64_t configuredThreads = settings["adventure"]["renderThreads"].Integer();
+	size_t threadsCount;
+	if(configuredThreads > 0)
+		threadsCount = std::min<size_t>(configuredThreads, maxBands);
+	else
+		threadsCount = std::clamp<size_t>(boost::thread::hardware_concurrency(), 1, maxBands);
+
+	return std::clamp<size_t>(tilesCount / minTilesPerBand, 1, threadsCount);
+}
+
+Rect MapViewCache::getStagingTileArea(size_t index) const
+{
+	Point tileSize = model->getSingleTileSize();
+	return Rect(Point(index % stagingColumns * tileSize.x, index / stagingColumns * tileSize.y), tileSize);
+}
+
+void MapViewCache::renderTilesParallel(const std::shared_ptr<IMapRendererContext> & context, const std::vector<int3> & tiles, size_t bandsCount)
+{
+	// first band is rendered by calling thread directly into cache, using main renderer
+	// remaining bands are prepared here, since loading of images must be done on main thread
+	if(renderBands.size() < bandsCount - 1)
+		renderBands.resize(bandsCount - 1);
+
+	for(size_t band = 1; band < bandsCount; ++band)
+	{
+		auto & entry = renderBands[band - 1];
+		entry.tiles.assign(tiles.begin() + tiles.size() * band / bandsCount, tiles.begin() + tiles.size() * (band + 1) / bandsCount);
+
+		if(!entry.renderer)
+		{
+			entry.renderer = std::make_unique<MapRenderer>();
+			entry.intermediate = std::make_unique<Canvas>(Point(32, 32));
+		}
+
+		Point stagingSize(model->getSingleTileSize().x * stagingColumns, getStagingTileArea(entry.tiles.size() - 1).bottom());
+		if(!entry.staging || entry.staging->getRenderArea().w < stagingSize.x || entry.staging->getRenderArea().h < stagingSize.y)
+			entry.staging = std::make_unique<Canvas>(stagingSize);
+
+		for(const auto & tile : entry.tiles)
+			entry.renderer->preloadTile(*context, tile);
+	}
+
+	while(renderWorkers.size() < bandsCount - 1)
+	{
+		size_t band = renderWorkers.size() + 1;
+		renderWorkers.emplace_back([this, band]()
+		{
+			renderWorkerLoop(band);
+		});
+	}
+
+	{
+		boost::lock_guard<boost::mutex> lock(renderWorkersMutex);
+		renderContext = context.get();
+		renderBandsActive = bandsCount;
+		renderBandsPending = bandsCount - 1;
+		++renderGeneration;
+	}
+	renderWorkersCondition.notify_all();
+
+	for(size_t i = 0; i < tiles.size() / bandsCount; ++i)
+	{
+		Canvas target = getTile(tiles[i]);
+		renderTile(*mapRenderer, *intermediate, *context, tiles[i], target);
+	}
+
+	{
+		boost::unique_lock<boost::mutex> lock(renderWorkersMutex);
+		renderWorkersCondition.wait(lock, [this](){ return renderBandsPending == 0; });
+		renderContext = nullptr;
+	}
+
+	for(size_t band = 1; band < bandsCount; ++band)
+	{
+		const auto & entry = renderBands[band - 1];
+		for(size_t i = 0; i < entry.tiles.size(); ++i)
+			getTile(entry.tiles[i]).draw(Canvas(*entry.staging, getStagingTileArea(i)), Point(0, 0));
+	}
+}
+
+void MapViewCache::renderWorkerLoop(size_t band)
+{
+	uint64_t lastGeneration = 0;
+
+	boost::unique_lock<boost::mutex> lock(renderWorkersMutex);
+	while(true)
+	{
+		renderWorkersCondition.wait(lock, [&](){ return renderWorkersStopping || renderGeneration != lastGeneration; });
+
+		if(renderWorkersStopping)
+			return;
+
+		lastGeneration = renderGeneration;
+		if(band >= renderBandsActive)
+			continue;
+
+		IMapRendererContext & context = *renderContext;
+		auto & entry = renderBands[band - 1];
+
+		lock.unlock();
+		for(size_t i = 0; i < entry.tiles.size(); ++i)
+		{
+			Canvas target(*entry.staging, getStagingTileArea(i));
+			renderTile(*entry.renderer, *entry.intermediate, context, entry.tiles[i], target);
+		}
+		lock.lock();
+
+		if(--renderBandsPending == 0)
+			renderWorkersCondition.notify_all();
+	}
 }
 
 void MapViewCache::update(const std::shared_ptr<IMapRendererContext> & context)
@@ -130,9 +325,51 @@ void MapViewCache::update(const std::shared_ptr<IMapRendererContext> & context)
 		tilesUpToDate = newCache;
 	}
 
+	if(mapResized || dimensions.w != tilesChecked.shape()[0] || dimensions.h != tilesChecked.shape()[1])
+	{
+		boost::multi_array<bool, 2> newCache;
+		newCache.resize(boost::extents[dimensions.w][dimensions.h]);
+		tilesChecked.resize(boost::extents[dimensions.w][dimensions.h]);
+		tilesChecked = newCache;
+	}
+
+	if(updateContextState(context))
+		invalidateAll();
+
+	std::vector<int3> dirtyTiles;
+
 	for(int y = dimensions.top(); y < dimensions.bottom(); ++y)
+	{
 		for(int x = dimensions.left(); x < dimensions.right(); ++x)
-			updateTile(context, {x, y, model->getLevel()});
+		{
+			int cacheX = (terrainChecksum.shape()[0] + x) % terrainChecksum.shape()[0];
+			int cacheY = (terrainChecksum.shape()[1] + y) % terrainChecksum.shape()[1];
+			const auto & cacheEntry = terrainChecksum[cacheX][cacheY];
+
+			// tile is still unchanged since last check, skip computation of its checksum
+			if(tilesChecked[cacheX][cacheY] && cachedLevel == model->getLevel() && cacheEntry.tileX == x && cacheEntry.tileY == y)
+				continue;
+
+			int3 tile(x, y, model->getLevel());
+			if(checkTile(context, tile))
+				dirtyTiles.push_back(tile);
+		}
+	}
+
+	size_t bandsCount = getRenderBandsCount(dirtyTiles.size());
+
+	if(bandsCount > 1)
+	{
+		renderTilesParallel(context, dirtyTiles, bandsCount);
+	}
+	else
+	{
+		for(const auto & tile : dirtyTiles)
+		{
+			Canvas target = getTile(tile);
+			renderTile(*mapRenderer, *intermediate, *context, tile, target);
+		}
+	}
 
 	cachedSize = model->getSingleTileSize();
 	cachedLevel = model->getLevel();
@@ -145,8 +382,15 @@ void MapViewCache::render(const std::shared_ptr<IMapRendererContext> & context,
 
 	Rect dimensions = model->getTilesTotalRect();
 
+	// Tiles that are adjacent both in cache and on screen are copied using single blit
+	// Full redraw needs at most 4 blits, one for each part of the view split by wrap-around of cache
+	std::vector<std::pair<Rect, Point>> blits;
+	std::vector<size_t> previousRowBlits;
+
 	for(int y = dimensions.top(); y < dimensions.bottom(); ++y)
 	{
+		std::vector<std::pair<Rect, Point>> rowBlits;
+
 		for(int x = dimensions.left(); x < dimensions.right(); ++x)
 		{
 			int cacheX = (terrainChecksum.shape()[0] + x) % terrainChecksum.shape()[0];
@@ -156,15 +400,51 @@ void MapViewCache::render(const std::shared_ptr<IMapRendererContext> & context,
 			if(lazyUpdate && tilesUpToDate[cacheX][cacheY])
 				continue;
 
-			Canvas source = getTile(tile);
-			Rect targetRect = model->getTargetTileArea(tile);
-			target.draw(source, targetRect.topLeft());
+			Rect sourceRect = model->getCacheTileArea(tile);
+			Point targetPosition = model->getTargetTileArea(tile).topLeft();
 
 			if (!fullRedraw)
 				tilesUpToDate[cacheX][cacheY] = true;
+
+			if(!rowBlits.empty())
+			{
+				auto & last = rowBlits.back();
+				if(last.first.right() == sourceRect.left() && last.first.top() == sourceRect.top() && last.second.x + last.first.w == targetPosition.x)
+				{
+					last.first.w += sourceRect.w;
+					continue;
+				}
+			}
+			rowBlits.emplace_back(sourceRect, targetPosition);
 		}
+
+		std::vector<size_t> currentRowBlits;
+		for(const auto & blit : rowBlits)
+		{
+			auto above = boost::range::find_if(previousRowBlits, [&](size_t index)
+			{
+				const auto & candidate = blits[index];
+				return candidate.first.left() == blit.first.left() && candidate.first.w == blit.first.w && candidate.first.bottom() == blit.first.top()
+					&& candidate.second.x == blit.second.x && candidate.second.y + candidate.first.h == blit.second.y;
+			});
+
+			if(above != previousRowBlits.end())
+			{
+				blits[*above].first.h += blit.first.h;
+				currentRowBlits.push_back(*above);
+			}
+			else
+			{
+				currentRowBlits.push_back(blits.size());
+				blits.push_back(blit);
+			}
+		}
+		previousRowBlits = std::move(currentRowBlits);
 	}
 
+	for(const auto & blit : blits)
+		target.draw(Canvas(*terrain, blit.first), blit.second);
+
 	if(context->showOverlay())
 	{
 		for(int y = dimensions.top(); y < dimensions.bottom(); ++y)
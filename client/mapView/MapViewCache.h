@@ -9,7 +9,9 @@
  */
 #pragma once
 
-#include "../../lib/Point.h"
+#include "../../lib/Rect.h"
+
+#include <boost/thread/condition_variable.hpp>
 
 VCMI_LIB_NAMESPACE_BEGIN
 class ObjectInstanceID;
@@ -41,10 +43,21 @@ class MapViewCache
 	boost::multi_array<TileChecksum, 2> terrainChecksum;
 	boost::multi_array<bool, 2> tilesUpToDate;
 
+	/// true if tile was checked after its last invalidation and has no animations
+	/// such tiles are not checked again until they are invalidated by change to the map or to the context
+	boost::multi_array<bool, 2> tilesChecked;
+
 	Point cachedSize;
 	Point cachedPosition;
 	int cachedLevel;
 
+	/// state of context used on last update, to detect changes that affect all tiles
+	std::weak_ptr<IMapRendererContext> cachedContext;
+	std::array<bool, 7> cachedContextFlags{};
+
+	/// coordinates, turns and action of each node of displayed path
+	std::vector<std::tuple<int3, int, int>> cachedPath;
+
 	std::shared_ptr<MapViewModel> model;
 
 	std::unique_ptr<Canvas> terrain;
@@ -52,10 +65,52 @@ class MapViewCache
 	std::unique_ptr<Canvas> intermediate;
 	std::unique_ptr<MapRenderer> mapRenderer;
 
+	/// Additional renderers used by parallel update, each renders contiguous band of dirty tiles on its own thread
+	/// SDL surfaces, including images owned by renderer, can not be used by several threads at once,
+	/// so each band has its own copy of all images and renders into its own staging canvas
+	struct RenderBand
+	{
+		std::unique_ptr<MapRenderer> renderer;
+		std::unique_ptr<Canvas> intermediate;
+		std::unique_ptr<Canvas> staging;
+		std::vector<int3> tiles;
+	};
+
+	std::vector<RenderBand> renderBands;
+
+	/// Threads that render additional bands, started on first parallel update and kept waiting between frames
+	/// Thread N renders band N + 1, since first band is always rendered by calling thread
+	std::vector<boost::thread> renderWorkers;
+	boost::mutex renderWorkersMutex;
+	boost::condition_variable renderWorkersCondition;
+	/// incremented on every parallel update to wake up workers
+	uint64_t renderGeneration = 0;
+	/// number of bands used by current update, workers of remaining bands stay idle
+	size_t renderBandsActive = 0;
+	/// number of bands of current update that are not rendered yet
+	size_t renderBandsPending = 0;
+	/// context of current update, only valid while update is in progress
+	IMapRendererContext * renderContext = nullptr;
+	bool renderWorkersStopping = false;
+
+	void renderWorkerLoop(size_t band);
+
 	std::shared_ptr<CAnimation> iconsStorage;
 
 	Canvas getTile(const int3 & coordinates);
-	void updateTile(const std::shared_ptr<IMapRendererContext> & context, const int3 & coordinates);
+
+	/// compares context with one used on last update and invalidates affected tiles
+	/// returns true if all visible tiles must be checked again
+	bool updateContextState(const std::shared_ptr<IMapRendererContext> & context);
+
+	/// updates checksum of tile, returns true if tile needs to be rendered again
+	bool checkTile(const std::shared_ptr<IMapRendererContext> & context, const int3 & coordinates);
+	void renderTile(MapRenderer & renderer, Canvas & intermediateCanvas, IMapRendererContext & context, const int3 & coordinates, Canvas & target);
+
+	/// returns number of threads that should be used to render specified number of tiles
+	size_t getRenderBandsCount(size_t tilesCount) const;
+	void renderTilesParallel(const std::shared_ptr<IMapRendererContext> & context, const std::vector<int3> & tiles, size_t bandsCount);
+	Rect getStagingTileArea(size_t index) const;
 
 	std::shared_ptr<IImage> getOverlayImageForTile(const std::shared_ptr<IMapRendererContext> & context, const int3 & coordinates);
 
@@ -66,6 +121,12 @@ public:
 	/// invalidates cache of specified object
 	void invalidate(const std::shared_ptr<IMapRendererContext> & context, const ObjectInstanceID & object);
 
+	/// invalidates cache of specified tile
+	void invalidate(const int3 & tile);
+
+	/// forces check of all visible tiles on next update
+	void invalidateAll();
+
 	/// updates internal terrain cache according to provided time delta
 	void update(const std::shared_ptr<IMapRendererContext> & context);
 
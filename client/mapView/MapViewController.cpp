@@ -17,6 +17,7 @@
 #include "MapViewModel.h"
 
 #include "../CPlayerInterface.h"
+#include "../PlayerLocalState.h"
 #include "../adventureMap/AdventureMapInterface.h"
 #include "../gui/CGuiHandler.h"
 #include "../gui/WindowHandler.h"
@@ -211,6 +212,14 @@ void MapViewController::updateState()
 {
 	if(adventureContext)
 	{
+		// these changes are not visible to view cache through context state
+		const auto * currentHero = LOCPLINT ? LOCPLINT->localState->getCurrentHero() : nullptr;
+		if(currentHero != selectedHero
+			|| adventureContext->settingSpellRange != settings["session"]["showSpellRange"].Bool()
+			|| adventureContext->settingsSessionSpectate != settings["session"]["spectate"].Bool())
+			view->invalidateAll();
+		selectedHero = currentHero;
+
 		adventureContext->settingsSessionSpectate = settings["session"]["spectate"].Bool();
 		adventureContext->settingsAdventureObjectAnimation = settings["adventure"]["objectAnimation"].Bool();
 		adventureContext->settingsAdventureTerrainAnimation = settings["adventure"]["terrainAnimation"].Bool();
@@ -633,6 +642,7 @@ void MapViewController::setTerrainVisibility(bool showAllTerrain)
 {
 	assert(spellViewContext);
 	spellViewContext->showAllTerrain = showAllTerrain;
+	view->invalidateAll();
 }
 
 void MapViewController::setOverlayVisibility(const std::vector<ObjectPosInfo> & objectPositions)
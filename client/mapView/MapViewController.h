@@ -14,6 +14,7 @@
 
 VCMI_LIB_NAMESPACE_BEGIN
 struct ObjectPosInfo;
+class CGHeroInstance;
 class PlayerColor;
 VCMI_LIB_NAMESPACE_END
 
@@ -50,6 +51,9 @@ class MapViewController : public IMapObjectObserver
 	std::shared_ptr<MapRendererSpellViewContext> spellViewContext;
 	std::shared_ptr<MapRendererPuzzleMapContext> puzzleMapContext;
 
+	/// currently selected hero, highlighting of its tiles and spell range overlay depend on it
+	const CGHeroInstance * selectedHero = nullptr;
+
 private:
 	const int defaultTileSize = 32;
 	const int zoomTileDeadArea = 5;
@@ -10,6 +10,8 @@
 #include "StdInc.h"
 #include "ColorFilter.h"
 
+#include "../renderSDL/PixelKernels.h"
+
 #include "../../lib/Color.h"
 #include "../../lib/json/JsonNode.h"
 
@@ -33,6 +35,20 @@ ColorRGBA ColorFilter::shiftColor(const ColorRGBA & in) const
 	};
 }
 
+void ColorFilter::shiftColors(const ColorRGBA * in, ColorRGBA * out, size_t count) const
+{
+	static_assert(sizeof(ColorRGBA) == 4, "Colors must be passed to kernel as arrays of RGBA bytes");
+
+	PixelKernels::ColorMatrix matrix = {
+		{r.r, r.g, r.b, r.a},
+		{g.r, g.g, g.b, g.a},
+		{b.r, b.g, b.b, b.a},
+		a
+	};
+
+	PixelKernels::getKernels().colorMatrix(reinterpret_cast<const uint8_t *>(in), reinterpret_cast<uint8_t *>(out), count, matrix);
+}
+
 bool ColorFilter::operator != (const ColorFilter & other) const
 {
 	return !(this->operator==(other));
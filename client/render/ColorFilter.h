@@ -33,6 +33,9 @@ class ColorFilter
 public:
 	ColorRGBA shiftColor(const ColorRGBA & in) const;
 
+	/// Applies filter to array of colors, with same results as shiftColor
+	void shiftColors(const ColorRGBA * in, ColorRGBA * out, size_t count) const;
+
 	bool operator == (const ColorFilter & other) const;
 	bool operator != (const ColorFilter & other) const;
 
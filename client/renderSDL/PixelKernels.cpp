@@ -0,0 +1,670 @@
+/*
+ * PixelKernels.cpp, part of VCMI engine
+ *
+ * Authors: listed in file AUTHORS in main folder
+ *
+ * License: GNU General Public License v2.0 or later
+ * Full text of license available in license.txt file, in main folder
+ *
+ */
+#include "StdInc.h"
+#include "PixelKernels.h"
+
+// Vectorized variants rely on little-endian layout of pixels in registers, which is the case for all supported x86 and ARM platforms
+#if defined(__x86_64__) || defined(_M_X64)
+#  define VCMI_PIXEL_KERNELS_X86
+#  include <immintrin.h>
+#  ifdef _MSC_VER
+#    include <intrin.h>
+#  endif
+#elif (defined(__aarch64__) || defined(_M_ARM64)) && !defined(VCMI_ENDIAN_BIG)
+#  define VCMI_PIXEL_KERNELS_NEON
+#  include <arm_neon.h>
+#endif
+
+#if defined(VCMI_PIXEL_KERNELS_X86) && (defined(__GNUC__) || defined(__clang__))
+#  define VCMI_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#  define VCMI_TARGET_AVX2
+#endif
+
+using namespace PixelKernels;
+
+namespace
+{
+
+constexpr uint32_t ALPHA_MASK = 0xFF000000;
+
+/// Converts RGBA palette entry into 32-bit pixel
+STRONG_INLINE uint32_t getPaletteColor(const uint8_t * palette, uint8_t index)
+{
+	const uint8_t * color = palette + index * 4;
+	return (uint32_t(color[3]) << 24) | (uint32_t(color[0]) << 16) | (uint32_t(color[1]) << 8) | uint32_t(color[2]);
+}
+
+STRONG_INLINE uint8_t clampChannel(int value)
+{
+	return static_cast<uint8_t>(std::clamp(value, 0, 255));
+}
+
+// Reference implementations. Each of them repeats arithmetic of original per-pixel code in CSDL_Ext and ColorFilter
+namespace KernelsScalar
+{
+	void blitPaletteAlphaRow(const uint8_t * source, uint32_t * target, size_t count, const uint8_t * palette)
+	{
+		for(size_t i = 0; i < count; ++i)
+		{
+			uint32_t color = getPaletteColor(palette, source[i]);
+			uint32_t alpha = color >> 24;
+
+			if(alpha == 0)
+				continue;
+
+			uint32_t result = ALPHA_MASK;
+			for(int shift : {16, 8, 0})
+			{
+				uint32_t src = (color >> shift) & 0xFF;
+				uint32_t dst = (target[i] >> shift) & 0xFF;
+				uint32_t value;
+
+				if(alpha == 255)
+					value = src;
+				else if(alpha == 128)
+					value = (src + dst) >> 1;
+				else
+					value = ((((src - dst) * alpha) >> 8) + dst) & 0xFF;
+
+				result |= value << shift;
+			}
+			target[i] = result;
+		}
+	}
+
+	void grayscaleRow(uint32_t * pixels, size_t count)
+	{
+		for(size_t i = 0; i < count; ++i)
+		{
+			int r = (pixels[i] >> 16) & 0xFF;
+			int g = (pixels[i] >> 8) & 0xFF;
+			int b = pixels[i] & 0xFF;
+
+			auto gray = static_cast<uint32_t>(static_cast<int>(0.299 * r + 0.587 * g + 0.114 * b));
+
+			pixels[i] = (pixels[i] & ALPHA_MASK) | (gray << 16) | (gray << 8) | gray;
+		}
+	}
+
+	void colorMatrix(const uint8_t * source, uint8_t * target, size_t count, const ColorMatrix & matrix)
+	{
+		for(size_t i = 0; i < count; ++i)
+		{
+			const uint8_t * in = source + i * 4;
+
+			int r = in[0] * matrix.r[0] + in[1] * matrix.r[1] + in[2] * matrix.r[2] + 255 * matrix.r[3];
+			int g = in[0] * matrix.g[0] + in[1] * matrix.g[1] + in[2] * matrix.g[2] + 255 * matrix.g[3];
+			int b = in[0] * matrix.b[0] + in[1] * matrix.b[1] + in[2] * matrix.b[2] + 255 * matrix.b[3];
+			int a = in[3] * matrix.alpha;
+
+			uint8_t * out = target + i * 4;
+			out[0] = clampChannel(r);
+			out[1] = clampChannel(g);
+			out[2] = clampChannel(b);
+			out[3] = clampChannel(a);
+		}
+	}
+
+	void scaleBilinearRow(const uint32_t * upperRow, const uint32_t * lowerRow, uint32_t * target, size_t count,
+		const int * columns, const float * columnDistances, float upperDistance, float lowerDistance)
+	{
+		for(size_t x = 0; x < count; ++x)
+		{
+			float w11 = columnDistances[x * 2] * upperDistance;
+			float w12 = columnDistances[x * 2] * lowerDistance;
+			float w21 = columnDistances[x * 2 + 1] * upperDistance;
+			float w22 = columnDistances[x * 2 + 1] * lowerDistance;
+
+			const auto * p11 = reinterpret_cast<const uint8_t *>(upperRow + columns[x]);
+			const auto * p12 = p11 + 4;
+			const auto * p21 = reinterpret_cast<const uint8_t *>(lowerRow + columns[x]);
+			const auto * p22 = p21 + 4;
+
+			auto * dest = reinterpret_cast<uint8_t *>(target + x);
+			for(int channel = 0; channel < 4; ++channel)
+				dest[channel] = static_cast<int>(p11[channel] * w11 + p12[channel] * w12 + p21[channel] * w21 + p22[channel] * w22);
+		}
+	}
+
+	void scaleNearestRow8(const uint8_t * source, uint8_t * target, size_t count, const int * columns)
+	{
+		for(size_t x = 0; x < count; ++x)
+			target[x] = source[columns[x]];
+	}
+
+	void scaleNearestRow32(const uint32_t * source, uint32_t * target, size_t count, const int * columns)
+	{
+		for(size_t x = 0; x < count; ++x)
+			target[x] = source[columns[x]];
+	}
+
+	const KernelSet kernels = {
+		blitPaletteAlphaRow,
+		grayscaleRow,
+		colorMatrix,
+		scaleBilinearRow,
+		scaleNearestRow8,
+		scaleNearestRow32
+	};
+}
+
+#ifdef VCMI_PIXEL_KERNELS_X86
+
+bool isAVX2Supported()
+{
+#ifdef _MSC_VER
+	int info[4];
+	__cpuid(info, 0);
+	if(info[0] < 7)
+		return false;
+
+	__cpuid(info, 1);
+	bool osUsesXSave = info[2] & (1 << 27);
+	bool hasAVX = info[2] & (1 << 28);
+	if(!osUsesXSave || !hasAVX || (_xgetbv(0) & 6) != 6)
+		return false;
+
+	__cpuidex(info, 7, 0);
+	return info[1] & (1 << 5);
+#else
+	return __builtin_cpu_supports("avx2");
+#endif
+}
+
+namespace KernelsSSE2
+{
+	/// Blends 4 pixels. Source pixels must have alpha in upper byte, same as target pixels
+	/// (src * weight + dst * (256 - weight)) >> 8 gives same result as scalar code, if weight of opaque pixels is 256
+	STRONG_INLINE __m128i blendPixels(__m128i colors, __m128i pixels)
+	{
+		const __m128i zero = _mm_setzero_si128();
+
+		__m128i alpha = _mm_srli_epi32(colors, 24);
+		__m128i weight = _mm_sub_epi32(alpha, _mm_cmpeq_epi32(alpha, _mm_set1_epi32(255)));
+		weight = _mm_or_si128(weight, _mm_slli_epi32(weight, 16));
+
+		__m128i weightLow = _mm_unpacklo_epi32(weight, weight);
+		__m128i weightHigh = _mm_unpackhi_epi32(weight, weight);
+		__m128i inverseLow = _mm_sub_epi16(_mm_set1_epi16(256), weightLow);
+		__m128i inverseHigh = _mm_sub_epi16(_mm_set1_epi16(256), weightHigh);
+
+		__m128i low = _mm_add_epi16(_mm_mullo_epi16(_mm_unpacklo_epi8(colors, zero), weightLow), _mm_mullo_epi16(_mm_unpacklo_epi8(pixels, zero), inverseLow));
+		__m128i high = _mm_add_epi16(_mm_mullo_epi16(_mm_unpackhi_epi8(colors, zero), weightHigh), _mm_mullo_epi16(_mm_unpackhi_epi8(pixels, zero), inverseHigh));
+		__m128i result = _mm_packus_epi16(_mm_srli_epi16(low, 8), _mm_srli_epi16(high, 8));
+
+		// transparent pixels are left as is, including alpha
+		__m128i transparent = _mm_cmpeq_epi32(alpha, zero);
+		return _mm_or_si128(result, _mm_andnot_si128(transparent, _mm_set1_epi32(static_cast<int>(ALPHA_MASK))));
+	}
+
+	void blitPaletteAlphaRow(const uint8_t * source, uint32_t * target, size_t count, const uint8_t * palette)
+	{
+		size_t i = 0;
+		for(; i + 4 <= count; i += 4)
+		{
+			__m128i colors = _mm_setr_epi32(
+				getPaletteColor(palette, source[i]),
+				getPaletteColor(palette, source[i + 1]),
+				getPaletteColor(palette, source[i + 2]),
+				getPaletteColor(palette, source[i + 3])
+			);
+
+			auto * pixels = reinterpret_cast<__m128i *>(target + i);
+			_mm_storeu_si128(pixels, blendPixels(colors, _mm_loadu_si128(pixels)));
+		}
+		KernelsScalar::blitPaletteAlphaRow(source + i, target + i, count - i, palette);
+	}
+
+	STRONG_INLINE __m128d grayscale(__m128i r, __m128i g, __m128i b)
+	{
+		return _mm_add_pd(
+			_mm_add_pd(
+				_mm_mul_pd(_mm_set1_pd(0.299), _mm_cvtepi32_pd(r)),
+				_mm_mul_pd(_mm_set1_pd(0.587), _mm_cvtepi32_pd(g))
+			),
+			_mm_mul_pd(_mm_set1_pd(0.114), _mm_cvtepi32_pd(b))
+		);
+	}
+
+	void grayscaleRow(uint32_t * pixels, size_t count)
+	{
+		const __m128i channelMask = _mm_set1_epi32(0xFF);
+
+		size_t i = 0;
+		for(; i + 4 <= count; i += 4)
+		{
+			auto * data = reinterpret_cast<__m128i *>(pixels + i);
+			__m128i values = _mm_loadu_si128(data);
+
+			__m128i r = _mm_and_si128(_mm_srli_epi32(values, 16), channelMask);
+			__m128i g = _mm_and_si128(_mm_srli_epi32(values, 8), channelMask);
+			__m128i b = _mm_and_si128(values, channelMask);
+
+			__m128i grayLow = _mm_cvttpd_epi32(grayscale(r, g, b));
+			__m128i grayHigh = _mm_cvttpd_epi32(grayscale(_mm_srli_si128(r, 8), _mm_srli_si128(g, 8), _mm_srli_si128(b, 8)));
+			__m128i gray = _mm_unpacklo_epi64(grayLow, grayHigh);
+
+			gray = _mm_or_si128(gray, _mm_or_si128(_mm_slli_epi32(gray, 8), _mm_slli_epi32(gray, 16)));
+			_mm_storeu_si128(data, _mm_or_si128(gray, _mm_and_si128(values, _mm_set1_epi32(static_cast<int>(ALPHA_MASK)))));
+		}
+		KernelsScalar::grayscaleRow(pixels + i, count - i);
+	}
+
+	STRONG_INLINE __m128i colorMatrixChannel(__m128 r, __m128 g, __m128 b, const float * row)
+	{
+		__m128 sum = _mm_add_ps(_mm_mul_ps(r, _mm_set1_ps(row[0])), _mm_mul_ps(g, _mm_set1_ps(row[1])));
+		sum = _mm_add_ps(sum, _mm_mul_ps(b, _mm_set1_ps(row[2])));
+		sum = _mm_add_ps(sum, _mm_set1_ps(255 * row[3]));
+		return _mm_cvttps_epi32(sum);
+	}
+
+	void colorMatrix(const uint8_t * source, uint8_t * target, size_t count, const ColorMatrix & matrix)
+	{
+		const __m128i channelMask = _mm_set1_epi32(0xFF);
+
+		size_t i = 0;
+		for(; i + 4 <= count; i += 4)
+		{
+			__m128i colors = _mm_loadu_si128(reinterpret_cast<const __m128i *>(source + i * 4));
+
+			__m128 r = _mm_cvtepi32_ps(_mm_and_si128(colors, channelMask));
+			__m128 g = _mm_cvtepi32_ps(_mm_and_si128(_mm_srli_epi32(colors, 8), channelMask));
+			__m128 b = _mm_cvtepi32_ps(_mm_and_si128(_mm_srli_epi32(colors, 16), channelMask));
+			__m128 a = _mm_cvtepi32_ps(_mm_srli_epi32(colors, 24));
+
+			__m128i outR = colorMatrixChannel(r, g, b, matrix.r);
+			__m128i outG = colorMatrixChannel(r, g, b, matrix.g);
+			__m128i outB = colorMatrixChannel(r, g, b, matrix.b);
+			__m128i outA = _mm_cvttps_epi32(_mm_mul_ps(a, _mm_set1_ps(matrix.alpha)));
+
+			// saturating packs clamp values to 0-255, giving r0-r3, g0-g3, b0-b3, a0-a3
+			__m128i planar = _mm_packus_epi16(_mm_packs_epi32(outR, outG), _mm_packs_epi32(outB, outA));
+			__m128i rg = _mm_unpacklo_epi8(planar, _mm_srli_si128(planar, 4));
+			__m128i ba = _mm_unpacklo_epi8(_mm_srli_si128(planar, 8), _mm_srli_si128(planar, 12));
+
+			_mm_storeu_si128(reinterpret_cast<__m128i *>(target + i * 4), _mm_unpacklo_epi16(rg, ba));
+		}
+		KernelsScalar::colorMatrix(source + i * 4, target + i * 4, count - i, matrix);
+	}
+
+	void scaleBilinearRow(const uint32_t * upperRow, const uint32_t * lowerRow, uint32_t * target, size_t count,
+		const int * columns, const float * columnDistances, float upperDistance, float lowerDistance)
+	{
+		const __m128i zero = _mm_setzero_si128();
+		const __m128i channelMask = _mm_set1_epi32(0xFF);
+
+		for(size_t x = 0; x < count; ++x)
+		{
+			float w11 = columnDistances[x * 2] * upperDistance;
+			float w12 = columnDistances[x * 2] * lowerDistance;
+			float w21 = columnDistances[x * 2 + 1] * upperDistance;
+			float w22 = columnDistances[x * 2 + 1] * lowerDistance;
+
+			__m128i upper = _mm_unpacklo_epi8(_mm_loadl_epi64(reinterpret_cast<const __m128i *>(upperRow + columns[x])), zero);
+			__m128i lower = _mm_unpacklo_epi8(_mm_loadl_epi64(reinterpret_cast<const __m128i *>(lowerRow + columns[x])), zero);
+
+			__m128 sum = _mm_add_ps(
+				_mm_mul_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(upper, zero)), _mm_set1_ps(w11)),
+				_mm_mul_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(upper, zero)), _mm_set1_ps(w12))
+			);
+			sum = _mm_add_ps(sum, _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(lower, zero)), _mm_set1_ps(w21)));
+			sum = _mm_add_ps(sum, _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(lower, zero)), _mm_set1_ps(w22)));
+
+			// total weight may exceed 1 due to rounding, in which case only lowest byte is kept, same as in scalar code
+			__m128i result = _mm_and_si128(_mm_cvttps_epi32(sum), channelMask);
+			result = _mm_packs_epi32(result, result);
+			target[x] = _mm_cvtsi128_si32(_mm_packus_epi16(result, result));
+		}
+	}
+
+	const KernelSet kernels = {
+		blitPaletteAlphaRow,
+		grayscaleRow,
+		colorMatrix,
+		scaleBilinearRow,
+		KernelsScalar::scaleNearestRow8,
+		KernelsScalar::scaleNearestRow32
+	};
+}
+
+namespace KernelsAVX2
+{
+	VCMI_TARGET_AVX2 void blitPaletteAlphaRow(const uint8_t * source, uint32_t * target, size_t count, const uint8_t * palette)
+	{
+		const __m256i zero = _mm256_setzero_si256();
+		const __m256i opaqueWeight = _mm256_set1_epi32(255);
+		// converts RGBA palette entries into pixels by swapping red and blue channels
+		const __m256i swapRedBlue = _mm256_setr_epi8(
+			2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15,
+			2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15
+		);
+
+		size_t i = 0;
+		for(; i + 8 <= count; i += 8)
+		{
+			__m256i indices = _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i *>(source + i)));
+			__m256i colors = _mm256_i32gather_epi32(reinterpret_cast<const int *>(palette), indices, 4);
+			colors = _mm256_shuffle_epi8(colors, swapRedBlue);
+
+			auto * data = reinterpret_cast<__m256i *>(target + i);
+			__m256i pixels = _mm256_loadu_si256(data);
+
+			__m256i alpha = _mm256_srli_epi32(colors, 24);
+			__m256i weight = _mm256_sub_epi32(alpha, _mm256_cmpeq_epi32(alpha, opaqueWeight));
+			weight = _mm256_or_si256(weight, _mm256_slli_epi32(weight, 16));
+
+			// unpack instructions work within 128-bit lanes, so pixels and their weights stay in same order
+			__m256i weightLow = _mm256_unpacklo_epi32(weight, weight);
+			__m256i weightHigh = _mm256_unpackhi_epi32(weight, weight);
+			__m256i inverseLow = _mm256_sub_epi16(_mm256_set1_epi16(256), weightLow);
+			__m256i inverseHigh = _mm256_sub_epi16(_mm256_set1_epi16(256), weightHigh);
+
+			__m256i low = _mm256_add_epi16(_mm256_mullo_epi16(_mm256_unpacklo_epi8(colors, zero), weightLow), _mm256_mullo_epi16(_mm256_unpacklo_epi8(pixels, zero), inverseLow));
+			__m256i high = _mm256_add_epi16(_mm256_mullo_epi16(_mm256_unpackhi_epi8(colors, zero), weightHigh), _mm256_mullo_epi16(_mm256_unpackhi_epi8(pixels, zero), inverseHigh));
+			__m256i result = _mm256_packus_epi16(_mm256_srli_epi16(low, 8), _mm256_srli_epi16(high, 8));
+
+			__m256i transparent = _mm256_cmpeq_epi32(alpha, zero);
+			result = _mm256_or_si256(result, _mm256_andnot_si256(transparent, _mm256_set1_epi32(static_cast<int>(ALPHA_MASK))));
+			_mm256_storeu_si256(data, result);
+		}
+		KernelsSSE2::blitPaletteAlphaRow(source + i, target + i, count - i, palette);
+	}
+
+	VCMI_TARGET_AVX2 STRONG_INLINE __m256d grayscale(__m128i r, __m128i g, __m128i b)
+	{
+		return _mm256_add_pd(
+			_mm256_add_pd(
+				_mm256_mul_pd(_mm256_set1_pd(0.299), _mm256_cvtepi32_pd(r)),
+				_mm256_mul_pd(_mm256_set1_pd(0.587), _mm256_cvtepi32_pd(g))
+			),
+			_mm256_mul_pd(_mm256_set1_pd(0.114), _mm256_cvtepi32_pd(b))
+		);
+	}
+
+	VCMI_TARGET_AVX2 void grayscaleRow(uint32_t * pixels, size_t count)
+	{
+		const __m256i channelMask = _mm256_set1_epi32(0xFF);
+
+		size_t i = 0;
+		for(; i + 8 <= count; i += 8)
+		{
+			auto * data = reinterpret_cast<__m256i *>(pixels + i);
+			__m256i values = _mm256_loadu_si256(data);
+
+			__m256i r = _mm256_and_si256(_mm256_srli_epi32(values, 16), channelMask);
+			__m256i g = _mm256_and_si256(_mm256_srli_epi32(values, 8), channelMask);
+			__m256i b = _mm256_and_si256(values, channelMask);
+
+			__m128i grayLow = _mm256_cvttpd_epi32(grayscale(_mm256_castsi256_si128(r), _mm256_castsi256_si128(g), _mm256_castsi256_si128(b)));
+			__m128i grayHigh = _mm256_cvttpd_epi32(grayscale(_mm256_extracti128_si256(r, 1), _mm256_extracti128_si256(g, 1), _mm256_extracti128_si256(b, 1)));
+			__m256i gray = _mm256_inserti128_si256(_mm256_castsi128_si256(grayLow), grayHigh, 1);
+
+			gray = _mm256_or_si256(gray, _mm256_or_si256(_mm256_slli_epi32(gray, 8), _mm256_slli_epi32(gray, 16)));
+			_mm256_storeu_si256(data, _mm256_or_si256(gray, _mm256_and_si256(values, _mm256_set1_epi32(static_cast<int>(ALPHA_MASK)))));
+		}
+		KernelsSSE2::grayscaleRow(pixels + i, count - i);
+	}
+
+	VCMI_TARGET_AVX2 void scaleBilinearRow(const uint32_t * upperRow, const uint32_t * lowerRow, uint32_t * target, size_t count,
+		const int * columns, const float * columnDistances, float upperDistance, float lowerDistance)
+	{
+		const __m128i channelMask = _mm_set1_epi32(0xFF);
+
+		for(size_t x = 0; x < count; ++x)
+		{
+			float w11 = columnDistances[x * 2] * upperDistance;
+			float w12 = columnDistances[x * 2] * lowerDistance;
+			float w21 = columnDistances[x * 2 + 1] * upperDistance;
+			float w22 = columnDistances[x * 2 + 1] * lowerDistance;
+
+			// both source pixels of each row are converted at once
+			__m256 upper = _mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i *>(upperRow + columns[x]))));
+			__m256 lower = _mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i *>(lowerRow + columns[x]))));
+
+			upper = _mm256_mul_ps(upper, _mm256_setr_ps(w11, w11, w11, w11, w12, w12, w12, w12));
+			lower = _mm256_mul_ps(lower, _mm256_setr_ps(w21, w21, w21, w21, w22, w22, w22, w22));
+
+			__m128 sum = _mm_add_ps(_mm256_castps256_ps128(upper), _mm256_extractf128_ps(upper, 1));
+			sum = _mm_add_ps(sum, _mm256_castps256_ps128(lower));
+			sum = _mm_add_ps(sum, _mm256_extractf128_ps(lower, 1));
+
+			__m128i result = _mm_and_si128(_mm_cvttps_epi32(sum), channelMask);
+			result = _mm_packs_epi32(result, result);
+			target[x] = _mm_cvtsi128_si32(_mm_packus_epi16(result, result));
+		}
+	}
+
+	VCMI_TARGET_AVX2 void scaleNearestRow32(const uint32_t * source, uint32_t * target, size_t count, const int * columns)
+	{
+		size_t x = 0;
+		for(; x + 8 <= count; x += 8)
+		{
+			__m256i indices = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(columns + x));
+			__m256i pixels = _mm256_i32gather_epi32(reinterpret_cast<const int *>(source), indices, 4);
+			_mm256_storeu_si256(reinterpret_cast<__m256i *>(target + x), pixels);
+		}
+		KernelsScalar::scaleNearestRow32(source, target + x, count - x, columns + x);
+	}
+
+	// color matrix is applied to palettes of 256 colors, where wider registers give no measurable gain
+	const KernelSet kernels = {
+		blitPaletteAlphaRow,
+		grayscaleRow,
+		KernelsSSE2::colorMatrix,
+		scaleBilinearRow,
+		KernelsScalar::scaleNearestRow8,
+		scaleNearestRow32
+	};
+}
+
+#endif
+
+#ifdef VCMI_PIXEL_KERNELS_NEON
+
+namespace KernelsNEON
+{
+	void blitPaletteAlphaRow(const uint8_t * source, uint32_t * target, size_t count, const uint8_t * palette)
+	{
+		const uint16x8_t fullWeight = vdupq_n_u16(256);
+
+		size_t i = 0;
+		for(; i + 4 <= count; i += 4)
+		{
+			const uint32_t loadedColors[4] = {
+				getPaletteColor(palette, source[i]),
+				getPaletteColor(palette, source[i + 1]),
+				getPaletteColor(palette, source[i + 2]),
+				getPaletteColor(palette, source[i + 3])
+			};
+
+			uint32x4_t colors = vld1q_u32(loadedColors);
+			uint32x4_t pixels = vld1q_u32(target + i);
+
+			// same blending as in SSE2 version, weight of opaque pixels is 256
+			uint32x4_t alpha = vshrq_n_u32(colors, 24);
+			uint32x4_t weight = vsubq_u32(alpha, vceqq_u32(alpha, vdupq_n_u32(255)));
+			weight = vorrq_u32(weight, vshlq_n_u32(weight, 16));
+
+			uint16x8_t weightLow = vreinterpretq_u16_u32(vzip1q_u32(weight, weight));
+			uint16x8_t weightHigh = vreinterpretq_u16_u32(vzip2q_u32(weight, weight));
+
+			uint8x16_t colorBytes = vreinterpretq_u8_u32(colors);
+			uint8x16_t pixelBytes = vreinterpretq_u8_u32(pixels);
+
+			uint16x8_t low = vaddq_u16(vmulq_u16(vmovl_u8(vget_low_u8(colorBytes)), weightLow), vmulq_u16(vmovl_u8(vget_low_u8(pixelBytes)), vsubq_u16(fullWeight, weightLow)));
+			uint16x8_t high = vaddq_u16(vmulq_u16(vmovl_u8(vget_high_u8(colorBytes)), weightHigh), vmulq_u16(vmovl_u8(vget_high_u8(pixelBytes)), vsubq_u16(fullWeight, weightHigh)));
+			uint32x4_t result = vreinterpretq_u32_u8(vcombine_u8(vshrn_n_u16(low, 8), vshrn_n_u16(high, 8)));
+
+			uint32x4_t visible = vtstq_u32(alpha, alpha);
+			vst1q_u32(target + i, vorrq_u32(result, vandq_u32(visible, vdupq_n_u32(ALPHA_MASK))));
+		}
+		KernelsScalar::blitPaletteAlphaRow(source + i, target + i, count - i, palette);
+	}
+
+	STRONG_INLINE float64x2_t grayscale(uint32x2_t r, uint32x2_t g, uint32x2_t b)
+	{
+		return vaddq_f64(
+			vaddq_f64(
+				vmulq_f64(vdupq_n_f64(0.299), vcvtq_f64_u64(vmovl_u32(r))),
+				vmulq_f64(vdupq_n_f64(0.587), vcvtq_f64_u64(vmovl_u32(g)))
+			),
+			vmulq_f64(vdupq_n_f64(0.114), vcvtq_f64_u64(vmovl_u32(b)))
+		);
+	}
+
+	void grayscaleRow(uint32_t * pixels, size_t count)
+	{
+		const uint32x4_t channelMask = vdupq_n_u32(0xFF);
+
+		size_t i = 0;
+		for(; i + 4 <= count; i += 4)
+		{
+			uint32x4_t values = vld1q_u32(pixels + i);
+
+			uint32x4_t r = vandq_u32(vshrq_n_u32(values, 16), channelMask);
+			uint32x4_t g = vandq_u32(vshrq_n_u32(values, 8), channelMask);
+			uint32x4_t b = vandq_u32(values, channelMask);
+
+			uint32x2_t grayLow = vmovn_u64(vcvtq_u64_f64(grayscale(vget_low_u32(r), vget_low_u32(g), vget_low_u32(b))));
+			uint32x2_t grayHigh = vmovn_u64(vcvtq_u64_f64(grayscale(vget_high_u32(r), vget_high_u32(g), vget_high_u32(b))));
+			uint32x4_t gray = vcombine_u32(grayLow, grayHigh);
+
+			gray = vorrq_u32(gray, vorrq_u32(vshlq_n_u32(gray, 8), vshlq_n_u32(gray, 16)));
+			vst1q_u32(pixels + i, vorrq_u32(gray, vandq_u32(values, vdupq_n_u32(ALPHA_MASK))));
+		}
+		KernelsScalar::grayscaleRow(pixels + i, count - i);
+	}
+
+	STRONG_INLINE uint8x8_t colorMatrixChannel(const float32x4_t (&r)[2], const float32x4_t (&g)[2], const float32x4_t (&b)[2], const float * row)
+	{
+		int16x4_t halves[2];
+		for(int half = 0; half < 2; ++half)
+		{
+			float32x4_t sum = vaddq_f32(vmulq_n_f32(r[half], row[0]), vmulq_n_f32(g[half], row[1]));
+			sum = vaddq_f32(sum, vmulq_n_f32(b[half], row[2]));
+			sum = vaddq_f32(sum, vdupq_n_f32(255 * row[3]));
+			halves[half] = vqmovn_s32(vcvtq_s32_f32(sum));
+		}
+		return vqmovun_s16(vcombine_s16(halves[0], halves[1]));
+	}
+
+	STRONG_INLINE void toFloat(uint8x8_t channel, float32x4_t (&result)[2])
+	{
+		uint16x8_t wide = vmovl_u8(channel);
+		result[0] = vcvtq_f32_u32(vmovl_u16(vget_low_u16(wide)));
+		result[1] = vcvtq_f32_u32(vmovl_u16(vget_high_u16(wide)));
+	}
+
+	void colorMatrix(const uint8_t * source, uint8_t * target, size_t count, const ColorMatrix & matrix)
+	{
+		size_t i = 0;
+		for(; i + 8 <= count; i += 8)
+		{
+			uint8x8x4_t colors = vld4_u8(source + i * 4);
+
+			float32x4_t r[2];
+			float32x4_t g[2];
+			float32x4_t b[2];
+			float32x4_t a[2];
+			toFloat(colors.val[0], r);
+			toFloat(colors.val[1], g);
+			toFloat(colors.val[2], b);
+			toFloat(colors.val[3], a);
+
+			uint8x8x4_t result;
+			result.val[0] = colorMatrixChannel(r, g, b, matrix.r);
+			result.val[1] = colorMatrixChannel(r, g, b, matrix.g);
+			result.val[2] = colorMatrixChannel(r, g, b, matrix.b);
+			result.val[3] = vqmovun_s16(vcombine_s16(
+				vqmovn_s32(vcvtq_s32_f32(vmulq_n_f32(a[0], matrix.alpha))),
+				vqmovn_s32(vcvtq_s32_f32(vmulq_n_f32(a[1], matrix.alpha)))
+			));
+
+			vst4_u8(target + i * 4, result);
+		}
+		KernelsScalar::colorMatrix(source + i * 4, target + i * 4, count - i, matrix);
+	}
+
+	void scaleBilinearRow(const uint32_t * upperRow, const uint32_t * lowerRow, uint32_t * target, size_t count,
+		const int * columns, const float * columnDistances, float upperDistance, float lowerDistance)
+	{
+		for(size_t x = 0; x < count; ++x)
+		{
+			float w11 = columnDistances[x * 2] * upperDistance;
+			float w12 = columnDistances[x * 2] * lowerDistance;
+			float w21 = columnDistances[x * 2 + 1] * upperDistance;
+			float w22 = columnDistances[x * 2 + 1] * lowerDistance;
+
+			uint16x8_t upper = vmovl_u8(vld1_u8(reinterpret_cast<const uint8_t *>(upperRow + columns[x])));
+			uint16x8_t lower = vmovl_u8(vld1_u8(reinterpret_cast<const uint8_t *>(lowerRow + columns[x])));
+
+			float32x4_t sum = vaddq_f32(
+				vmulq_n_f32(vcvtq_f32_u32(vmovl_u16(vget_low_u16(upper))), w11),
+				vmulq_n_f32(vcvtq_f32_u32(vmovl_u16(vget_high_u16(upper))), w12)
+			);
+			sum = vaddq_f32(sum, vmulq_n_f32(vcvtq_f32_u32(vmovl_u16(vget_low_u16(lower))), w21));
+			sum = vaddq_f32(sum, vmulq_n_f32(vcvtq_f32_u32(vmovl_u16(vget_high_u16(lower))), w22));
+
+			// non-saturating narrowing keeps lowest byte, same as scalar code
+			uint16x4_t result = vmovn_u32(vcvtq_u32_f32(sum));
+			target[x] = vget_lane_u32(vreinterpret_u32_u8(vmovn_u16(vcombine_u16(result, result))), 0);
+		}
+	}
+
+	const KernelSet kernels = {
+		blitPaletteAlphaRow,
+		grayscaleRow,
+		colorMatrix,
+		scaleBilinearRow,
+		KernelsScalar::scaleNearestRow8,
+		KernelsScalar::scaleNearestRow32
+	};
+}
+
+#endif
+
+}
+
+const KernelSet * PixelKernels::getKernels(EInstructionSet instructionSet)
+{
+	switch(instructionSet)
+	{
+		case EInstructionSet::SCALAR:
+			return &KernelsScalar::kernels;
+#ifdef VCMI_PIXEL_KERNELS_X86
+		case EInstructionSet::SSE2:
+			return &KernelsSSE2::kernels;
+		case EInstructionSet::AVX2:
+			return isAVX2Supported() ? &KernelsAVX2::kernels : nullptr;
+#endif
+#ifdef VCMI_PIXEL_KERNELS_NEON
+		case EInstructionSet::NEON:
+			return &KernelsNEON::kernels;
+#endif
+		default:
+			return nullptr;
+	}
+}
+
+const KernelSet & PixelKernels::getKernels()
+{
+	static const KernelSet * fastest = []()
+	{
+		for(auto instructionSet : {EInstructionSet::AVX2, EInstructionSet::SSE2, EInstructionSet::NEON})
+		{
+			if(const auto * kernels = getKernels(instructionSet))
+				return kernels;
+		}
+		return getKernels(EInstructionSet::SCALAR);
+	}();
+
+	return *fastest;
+}
@@ -0,0 +1,64 @@
+/*
+ * PixelKernels.h, part of VCMI engine
+ *
+ * Authors: listed in file AUTHORS in main folder
+ *
+ * License: GNU General Public License v2.0 or later
+ * Full text of license available in license.txt file, in main folder
+ *
+ */
+#pragma once
+
+/// Row-level pixel operations used by CSDL_Ext and SDLImage, with vectorized variants selected at runtime
+/// 32-bit pixels are in same format as used by Channels::px<4>, e.g. 0xAARRGGBB when read as native uint32_t
+/// Palettes and colors are arrays of 4-byte RGBA entries, with same layout as SDL_Color and ColorRGBA
+/// All variants produce results identical to scalar implementation
+namespace PixelKernels
+{
+	enum class EInstructionSet
+	{
+		SCALAR,
+		SSE2,
+		AVX2,
+		NEON
+	};
+
+	/// Coefficients of ColorFilter. Each output channel is r * input.r + g * input.g + b * input.b + a * 255,
+	/// output alpha is input.a * alpha. Results are truncated and clamped to 0-255 range
+	struct ColorMatrix
+	{
+		float r[4];
+		float g[4];
+		float b[4];
+		float alpha;
+	};
+
+	struct KernelSet
+	{
+		/// Blends row of palette-indexed pixels into row of 32-bit pixels, using alpha of palette entries
+		/// Fully transparent pixels are skipped, alpha of all other target pixels is set to 255
+		void (*blitPaletteAlphaRow)(const uint8_t * source, uint32_t * target, size_t count, const uint8_t * palette);
+
+		/// Converts color channels of row of 32-bit pixels to grayscale, alpha is kept as is
+		void (*grayscaleRow)(uint32_t * pixels, size_t count);
+
+		/// Applies color matrix to array of RGBA colors
+		void (*colorMatrix)(const uint8_t * source, uint8_t * target, size_t count, const ColorMatrix & matrix);
+
+		/// Writes row of bilinear-scaled image, using 2 source pixels from upper and lower rows for each target pixel
+		/// columns contains index of left source pixel of each target pixel
+		/// columnDistances contains 2 values per target pixel: distance to left and to right source pixel
+		void (*scaleBilinearRow)(const uint32_t * upperRow, const uint32_t * lowerRow, uint32_t * target, size_t count,
+			const int * columns, const float * columnDistances, float upperDistance, float lowerDistance);
+
+		/// Writes row of nearest-neighbour scaled image, columns contains index of source pixel of each target pixel
+		void (*scaleNearestRow8)(const uint8_t * source, uint8_t * target, size_t count, const int * columns);
+		void (*scaleNearestRow32)(const uint32_t * source, uint32_t * target, size_t count, const int * columns);
+	};
+
+	/// Returns implementation using specified instruction set, or nullptr if not supported by this build or CPU
+	const KernelSet * getKernels(EInstructionSet instructionSet);
+
+	/// Returns fastest implementation supported on this CPU
+	const KernelSet & getKernels();
+}
@@ -292,6 +292,12 @@ void SDLImage::shiftPalette(uint32_t firstColorID, uint32_t colorsToMove, uint32
 		{
 			shifterColors[(i+distanceToMove)%colorsToMove] = originalPalette->colors[firstColorID + i];
 		}
+
+		// palette is shifted before each draw, but changes only on next animation frame
+		// changing palette forces SDL to rebuild color mapping on next blit, so avoid it when possible
+		if(std::memcmp(surf->format->palette->colors + firstColorID, shifterColors.data(), colorsToMove * sizeof(SDL_Color)) == 0)
+			return;
+
 		CSDL_Ext::setColors(surf, shifterColors.data(), firstColorID, colorsToMove);
 	}
 }
@@ -302,6 +308,11 @@ void SDLImage::adjustPalette(const ColorFilter & shifter, uint32_t colorsToSkipM
 		return;
 
 	SDL_Palette* palette = surf->format->palette;
+	assert(palette->ncolors <= DEFAULT_PALETTE_COLORS);
+
+	static_assert(sizeof(SDL_Color) == sizeof(ColorRGBA), "Palette colors are passed to filter as ColorRGBA");
+	std::array<SDL_Color, DEFAULT_PALETTE_COLORS> shiftedColors;
+	shifter.shiftColors(reinterpret_cast<const ColorRGBA *>(originalPalette->colors), reinterpret_cast<ColorRGBA *>(shiftedColors.data()), palette->ncolors);
 
 	// Note: here we skip first colors in the palette that are predefined in H3 images
 	for(int i = 0; i < palette->ncolors; i++)
@@ -309,7 +320,7 @@ void SDLImage::adjustPalette(const ColorFilter & shifter, uint32_t colorsToSkipM
 		if(i < std::numeric_limits<uint32_t>::digits && ((colorsToSkipMask >> i) & 1) == 1)
 			continue;
 
-		palette->colors[i] = CSDL_Ext::toSDL(shifter.shiftColor(CSDL_Ext::fromSDL(originalPalette->colors[i])));
+		palette->colors[i] = shiftedColors[i];
 	}
 }
 
@@ -11,6 +11,7 @@
 #include "SDL_Extensions.h"
 
 #include "SDL_PixelAccess.h"
+#include "PixelKernels.h"
 
 #include "../render/Graphics.h"
 #include "../render/Colors.h"
@@ -337,15 +338,32 @@ int CSDL_Ext::blit8bppAlphaTo24bppT(const SDL_Surface * src, const Rect & srcRec
 			uint8_t *colory = (uint8_t*)src->pixels + srcy*src->pitch + srcx;
 			uint8_t *py = (uint8_t*)dst->pixels + dstRect->y*dst->pitch + dstRect->x*bpp;
 
-			for(int y=h; y; y--, colory+=src->pitch, py+=dst->pitch)
+			if(bpp == 4)
 			{
-				uint8_t *color = colory;
-				uint8_t *p = py;
+				// vectorized kernels may read any of 256 palette entries
+				std::array<SDL_Color, 256> fullPalette{};
+				if(src->format->palette->ncolors < 256)
+				{
+					std::copy_n(colors, src->format->palette->ncolors, fullPalette.begin());
+					colors = fullPalette.data();
+				}
 
-				for(int x = w; x; x--)
+				const auto & kernels = PixelKernels::getKernels();
+				for(int y=h; y; y--, colory+=src->pitch, py+=dst->pitch)
+					kernels.blitPaletteAlphaRow(colory, reinterpret_cast<uint32_t *>(py), w, reinterpret_cast<const uint8_t *>(colors));
+			}
+			else
+			{
+				for(int y=h; y; y--, colory+=src->pitch, py+=dst->pitch)
 				{
-					const SDL_Color &tbc = colors[*color++]; //color to blit
-					ColorPutter<bpp, +1>::PutColorAlphaSwitch(p, tbc.r, tbc.g, tbc.b, tbc.a);
+					uint8_t *color = colory;
+					uint8_t *p = py;
+
+					for(int x = w; x; x--)
+					{
+						const SDL_Color &tbc = colors[*color++]; //color to blit
+						ColorPutter<bpp, +1>::PutColorAlphaSwitch(p, tbc.r, tbc.g, tbc.b, tbc.a);
+					}
 				}
 			}
 			SDL_UnlockSurface(dst);
@@ -636,6 +654,12 @@ void CSDL_Ext::convertToGrayscaleBpp(SDL_Surface * surf, const Rect & rect )
 		uint8_t * pixel_from = pixels + yp * surf->pitch + rect.left() * surf->format->BytesPerPixel;
 		uint8_t * pixel_dest = pixels + yp * surf->pitch + rect.right() * surf->format->BytesPerPixel;
 
+		if(bpp == 4)
+		{
+			PixelKernels::getKernels().grayscaleRow(reinterpret_cast<uint32_t *>(pixel_from), std::max(rect.w, 0));
+			continue;
+		}
+
 		for (uint8_t * pixel = pixel_from; pixel < pixel_dest; pixel += surf->format->BytesPerPixel)
 		{
 			int r = Channels::px<bpp>::r.get(pixel);
@@ -684,6 +708,32 @@ void scaleSurfaceFastInternal(SDL_Surface *surf, SDL_Surface *ret)
 	}
 }
 
+// same as scaleSurfaceFastInternal, but with horizontal coordinates computed once for all rows
+void scaleSurfaceFastKernel(SDL_Surface *surf, SDL_Surface *ret)
+{
+	const float factorX = static_cast<float>(surf->w) / static_cast<float>(ret->w);
+	const float factorY = static_cast<float>(surf->h) / static_cast<float>(ret->h);
+
+	std::vector<int> columns(ret->w);
+	for(int x = 0; x < ret->w; x++)
+		columns[x] = static_cast<int>(floor(factorX * x));
+
+	const auto & kernels = PixelKernels::getKernels();
+
+	for(int y = 0; y < ret->h; y++)
+	{
+		auto origY = static_cast<int>(floor(factorY * y));
+
+		uint8_t *srcPtr = (uint8_t*)surf->pixels + origY * surf->pitch;
+		uint8_t *destPtr = (uint8_t*)ret->pixels + y * ret->pitch;
+
+		if(surf->format->BytesPerPixel == 1)
+			kernels.scaleNearestRow8(srcPtr, destPtr, ret->w, columns.data());
+		else
+			kernels.scaleNearestRow32(reinterpret_cast<uint32_t *>(srcPtr), reinterpret_cast<uint32_t *>(destPtr), ret->w, columns.data());
+	}
+}
+
 SDL_Surface * CSDL_Ext::scaleSurfaceFast(SDL_Surface *surf, int width, int height)
 {
 	if (!surf || !width || !height)
@@ -697,10 +747,10 @@ SDL_Surface * CSDL_Ext::scaleSurfaceFast(SDL_Surface *surf, int width, int heigh
 
 	switch(surf->format->BytesPerPixel)
 	{
-		case 1: scaleSurfaceFastInternal<1>(surf, ret); break;
+		case 1: scaleSurfaceFastKernel(surf, ret); break;
 		case 2: scaleSurfaceFastInternal<2>(surf, ret); break;
 		case 3: scaleSurfaceFastInternal<3>(surf, ret); break;
-		case 4: scaleSurfaceFastInternal<4>(surf, ret); break;
+		case 4: scaleSurfaceFastKernel(surf, ret); break;
 	}
 	return ret;
 }
@@ -752,6 +802,41 @@ void scaleSurfaceInternal(SDL_Surface *surf, SDL_Surface *ret)
 	}
 }
 
+// same as scaleSurfaceInternal<4>, but with horizontal coordinates and weights computed once for all rows
+void scaleSurfaceKernel(SDL_Surface *surf, SDL_Surface *ret)
+{
+	const float factorX = float(surf->w - 1) / float(ret->w),
+				factorY = float(surf->h - 1) / float(ret->h);
+
+	std::vector<int> columns(ret->w);
+	std::vector<float> columnDistances(ret->w * 2);
+
+	for(int x = 0; x < ret->w; x++)
+	{
+		float origX = factorX * x;
+		float x1 = floor(origX), x2 = floor(origX+1);
+
+		columns[x] = int(x1);
+		columnDistances[x * 2] = origX - x1;
+		columnDistances[x * 2 + 1] = x2 - origX;
+	}
+
+	const auto & kernels = PixelKernels::getKernels();
+
+	for(int y = 0; y < ret->h; y++)
+	{
+		float origY = factorY * y;
+		float y1 = floor(origY), y2 = floor(origY+1);
+
+		uint8_t *upperRow = (uint8_t*)surf->pixels + int(y1) * surf->pitch;
+		uint8_t *lowerRow = upperRow + surf->pitch;
+		uint8_t *dest = (uint8_t*)ret->pixels + y * ret->pitch;
+
+		kernels.scaleBilinearRow(reinterpret_cast<uint32_t *>(upperRow), reinterpret_cast<uint32_t *>(lowerRow), reinterpret_cast<uint32_t *>(dest), ret->w,
+			columns.data(), columnDistances.data(), origY - y1, y2 - origY);
+	}
+}
+
 // scaling via bilinear interpolation algorithm.
 // NOTE: best results are for scaling in range 50%...200%.
 // And upscaling looks awful right now - should be fixed somehow
@@ -773,7 +858,7 @@ SDL_Surface * CSDL_Ext::scaleSurface(SDL_Surface *surf, int width, int height)
 	{
 	case 2: scaleSurfaceInternal<2>(surf, ret); break;
 	case 3: scaleSurfaceInternal<3>(surf, ret); break;
-	case 4: scaleSurfaceInternal<4>(surf, ret); break;
+	case 4: scaleSurfaceKernel(surf, ret); break;
 	}
 
 	return ret;
@@ -465,6 +465,27 @@ std::vector <const CGObjectInstance * > CGameInfoCallback::getVisitableObjs(int3
 
 	return ret;
 }
+
+std::vector <const CGObjectInstance * > CGameInfoCallback::getVisitableObjsInRect(const int3 & topLeft, const int3 & bottomRight) const
+{
+	std::vector<const CGObjectInstance *> ret;
+	std::set<const CGObjectInstance *> found;
+
+	gs->map->getObjectIndex().forEachInRect(topLeft, bottomRight, MapObjectIndex::ELayer::VISITABLE, [&](const CGObjectInstance * obj, const int3 & tile)
+	{
+		if(!isVisible(tile))
+			return;
+
+		if(!getPlayerID() && obj->ID == Obj::EVENT) //hide events from players
+			return;
+
+		if(found.insert(obj).second)
+			ret.push_back(obj);
+	});
+
+	return ret;
+}
+
 const CGObjectInstance * CGameInfoCallback::getTopObj (int3 pos) const
 {
 	return vstd::backOrNull(getVisitableObjs(pos));
@@ -540,7 +561,7 @@ std::shared_ptr<const boost::multi_array<TerrainTile*, 3>> CGameInfoCallback::ge
 		for(tile.x = 0; tile.x < width; tile.x++)
 			for(tile.y = 0; tile.y < height; tile.y++)
 			{
-				if ((*team->fogOfWarMap)[tile.z][tile.x][tile.y])
+				if (team->fogOfWarMap->test(tile))
 					(*ptr)[tile.z][tile.x][tile.y] = &gs->map->getTile(tile);
 				else
 					(*ptr)[tile.z][tile.x][tile.y] = nullptr;
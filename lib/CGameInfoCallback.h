@@ -186,6 +186,8 @@ public:
 	const CGObjectInstance * getObj(ObjectInstanceID objid, bool verbose = true) const override;
 	virtual std::vector <const CGObjectInstance * > getBlockingObjs(int3 pos)const;
 	std::vector <const CGObjectInstance * > getVisitableObjs(int3 pos, bool verbose = true) const override;
+	/// Objects with at least one visible visitable tile in rectangle between corners (inclusive) on level of first corner, each object is reported once
+	std::vector <const CGObjectInstance * > getVisitableObjsInRect(const int3 & topLeft, const int3 & bottomRight) const;
 	virtual std::vector <const CGObjectInstance * > getFlaggableObjects(int3 pos) const;
 	virtual const CGObjectInstance * getTopObj (int3 pos) const;
 	virtual PlayerColor getOwner(ObjectInstanceID heroID) const;
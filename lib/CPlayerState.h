@@ -17,6 +17,7 @@
 #include "ResourceSet.h"
 #include "TurnTimerInfo.h"
 #include "ConstTransitivePtr.h"
+#include "mapping/TileBitmask.h"
 
 VCMI_LIB_NAMESPACE_BEGIN
 
@@ -124,16 +125,28 @@ struct DLL_LINKAGE TeamState : public CBonusSystemNode
 public:
 	TeamID id; //position in gameState::teams
 	std::set<PlayerColor> players; // members of this team
-	//TODO: boost::array, bool if possible
-	std::unique_ptr<boost::multi_array<ui8, 3>> fogOfWarMap; //[z][x][y] true - visible, false - hidden
+	std::unique_ptr<TileBitmask> fogOfWarMap; //set - visible, cleared - hidden
 
 	TeamState();
 
+	/// Converts fog of war from old saves, stored as [z][x][y] array of bytes
+	void loadLegacyFogOfWar(const boost::multi_array<ui8, 3> & legacyFogOfWar);
+
 	template <typename Handler> void serialize(Handler &h)
 	{
 		h & id;
 		h & players;
-		h & fogOfWarMap;
+		if (h.version >= Handler::Version::FOG_OF_WAR_BITMASK)
+		{
+			h & fogOfWarMap;
+		}
+		else
+		{
+			std::unique_ptr<boost::multi_array<ui8, 3>> legacyFogOfWar;
+			h & legacyFogOfWar;
+			if (legacyFogOfWar)
+				loadLegacyFogOfWar(*legacyFogOfWar);
+		}
 		h & static_cast<CBonusSystemNode&>(*this);
 	}
 
@@ -59,10 +59,11 @@ static thread_local std::string threadNameForLogging;
 
 std::string getThreadName()
 {
-	if (!threadNameForLogging.empty())
-		return threadNameForLogging;
+	// thread without name is identified by its id, converted to string only once
+	if (threadNameForLogging.empty())
+		threadNameForLogging = boost::lexical_cast<std::string>(boost::this_thread::get_id());
 
-	return boost::lexical_cast<std::string>(boost::this_thread::get_id());
+	return threadNameForLogging;
 }
 
 void setThreadNameLoggingOnly(const std::string &name)
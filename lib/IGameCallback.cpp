@@ -103,8 +103,8 @@ void CPrivilegedInfoCallback::getTilesInRange(std::unordered_set<int3> & tiles,
 				if(distance <= radious)
 				{
 					if(!player
-						|| (mode == ETileVisibility::HIDDEN  && (*team->fogOfWarMap)[pos.z][xd][yd] == 0)
-						|| (mode == ETileVisibility::REVEALED && (*team->fogOfWarMap)[pos.z][xd][yd] == 1)
+						|| (mode == ETileVisibility::HIDDEN  && !team->fogOfWarMap->test(tilePos))
+						|| (mode == ETileVisibility::REVEALED && team->fogOfWarMap->test(tilePos))
 					)
 						tiles.insert(int3(xd,yd,pos.z));
 				}
@@ -113,6 +113,47 @@ void CPrivilegedInfoCallback::getTilesInRange(std::unordered_set<int3> & tiles,
 	}
 }
 
+void CPrivilegedInfoCallback::getTilesInRange(TileBitmask & tiles,
+											  const int3 & pos,
+											  int radious,
+											  ETileVisibility mode,
+											  std::optional<PlayerColor> player,
+											  int3::EDistanceFormula distanceFormula) const
+{
+	if(!!player && !player->isValidPlayer())
+	{
+		logGlobal->error("Illegal call to getTilesInRange!");
+		return;
+	}
+
+	const int3 mapSize = gs->getMapSize();
+	if(tiles.size() != mapSize)
+		tiles.resize(mapSize);
+
+	if(radious == CBuilding::HEIGHT_SKYSHIP) //reveal entire map
+	{
+		tiles.fill(true);
+		return;
+	}
+
+	if(!player)
+	{
+		tiles.setRange(pos, radious, distanceFormula);
+		return;
+	}
+
+	TileBitmask range(mapSize);
+	range.setRange(pos, radious, distanceFormula);
+
+	const TeamState * team = gs->getPlayerTeam(*player);
+	if(mode == ETileVisibility::HIDDEN)
+		range.subtract(*team->fogOfWarMap);
+	else
+		range &= *team->fogOfWarMap;
+
+	tiles |= range;
+}
+
 void CPrivilegedInfoCallback::getAllTiles(std::unordered_set<int3> & tiles, std::optional<PlayerColor> Player, int level, std::function<bool(const TerrainTile *)> filter) const
 {
 	if(!!Player && !Player->isValidPlayer())
@@ -26,6 +26,7 @@ class CRandomGenerator;
 class CCreatureSet;
 class CStackBasicDescriptor;
 class CGCreature;
+class TileBitmask;
 enum class EOpenWindowMode : uint8_t;
 
 namespace spells
@@ -57,6 +58,14 @@ public:
 						 std::optional<PlayerColor> player = std::optional<PlayerColor>(),
 						 int3::EDistanceFormula formula = int3::DIST_2D) const;
 
+	//same as above, but adds tiles to bit-packed mask. Empty mask will be resized to map size
+	void getTilesInRange(TileBitmask & tiles,
+						 const int3 & pos,
+						 int radius,
+						 ETileVisibility mode,
+						 std::optional<PlayerColor> player = std::optional<PlayerColor>(),
+						 int3::EDistanceFormula formula = int3::DIST_2D) const;
+
 	//returns all tiles on given level (-1 - both levels, otherwise number of level)
 	void getAllTiles(std::unordered_set<int3> &tiles, std::optional<PlayerColor> player, int level, std::function<bool(const TerrainTile *)> filter) const;
 
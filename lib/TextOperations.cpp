@@ -108,10 +108,24 @@ bool TextOperations::isValidUnicodeString(const std::string & text)
 
 bool TextOperations::isValidUnicodeString(const char * data, size_t size)
 {
-	for (size_t i=0; i<size; i += getUnicodeCharacterSize(data[i]))
+	size_t i = 0;
+	while (i < size)
 	{
+		// fast path - skip blocks of 8 ASCII characters, checked at once
+		if (i + sizeof(uint64_t) <= size)
+		{
+			uint64_t word;
+			std::memcpy(&word, data + i, sizeof(word));
+			if ((word & 0x8080808080808080ull) == 0)
+			{
+				i += sizeof(word);
+				continue;
+			}
+		}
+
 		if (!isValidUnicodeCharacter(data + i, size - i))
 			return false;
+		i += getUnicodeCharacterSize(data[i]);
 	}
 	return true;
 }
@@ -61,6 +61,26 @@ void BattleInfo::localInit()
 		s->localInit(this);
 
 	exportBonuses();
+	updateHexOccupants();
+}
+
+void BattleInfo::updateHexOccupants()
+{
+	hexOccupants.fill(nullptr);
+
+	for(const CStack * s : stacks)
+	{
+		if(s->isGhost() || !s->alive())
+			continue;
+
+		for(BattleHex hex : s->getHexes())
+		{
+			if(hex.isValid() && hexOccupants[hex.hex] == nullptr)
+				hexOccupants[hex.hex] = s;
+		}
+	}
+
+	hexOccupantsValid = true;
 }
 
 namespace CGH
@@ -579,6 +599,20 @@ battle::Units BattleInfo::getUnitsIf(const battle::UnitFilter & predicate) const
 	return ret;
 }
 
+const battle::Unit * BattleInfo::getUnitAtPos(BattleHex pos) const
+{
+	return getStackAtPos(pos);
+}
+
+const CStack * BattleInfo::getStackAtPos(BattleHex pos) const
+{
+	// turrets are placed on special off-field hexes that are not part of occupancy table
+	if(!hexOccupantsValid || !pos.isValid())
+		return IBattleInfo::getStackAtPos(pos);
+
+	return hexOccupants[pos.hex];
+}
+
 
 BattleField BattleInfo::getBattlefieldType() const
 {
@@ -710,6 +744,9 @@ void BattleInfo::nextRound()
 
 	for(auto & obst : obstacles)
 		obst->battleTurnPassed();
+
+	// clones expire at the start of new round
+	updateHexOccupants();
 }
 
 void BattleInfo::nextTurn(uint32_t unitId)
@@ -737,6 +774,7 @@ void BattleInfo::addUnit(uint32_t id, const JsonNode & data)
 	stacks.push_back(ret);
 	ret->localInit(this);
 	ret->summoned = info.summoned;
+	updateHexOccupants();
 }
 
 void BattleInfo::moveUnit(uint32_t id, BattleHex destination)
@@ -748,6 +786,7 @@ void BattleInfo::moveUnit(uint32_t id, BattleHex destination)
 		return;
 	}
 	sta->position = destination;
+	updateHexOccupants();
 	//Bonuses can be limited by unit placement, so, change tree version 
 	//to force updating a bonus. TODO: update version only when such bonuses are present
 	CBonusSystemNode::treeHasChanged();
@@ -818,6 +857,8 @@ void BattleInfo::setUnitState(uint32_t id, const JsonNode & data, int64_t health
 				s->cloneID = -1;
 		}
 	}
+
+	updateHexOccupants();
 }
 
 void BattleInfo::removeUnit(uint32_t id)
@@ -833,7 +874,7 @@ void BattleInfo::removeUnit(uint32_t id)
 		if(!toRemove)
 		{
 			logGlobal->error("Cannot find stack %d", toRemoveId);
-			return;
+			break;
 		}
 
 		if(!toRemove->ghost)
@@ -859,6 +900,8 @@ void BattleInfo::removeUnit(uint32_t id)
 
 		ids.erase(toRemoveId);
 	}
+
+	updateHexOccupants();
 }
 
 void BattleInfo::updateUnit(uint32_t id, const JsonNode & data)
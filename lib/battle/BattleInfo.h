@@ -87,6 +87,9 @@ public:
 
 	battle::Units getUnitsIf(const battle::UnitFilter & predicate) const override;
 
+	const battle::Unit * getUnitAtPos(BattleHex pos) const override;
+	const CStack * getStackAtPos(BattleHex pos) const override;
+
 	BattleField getBattlefieldType() const override;
 	TerrainId getTerrainType() const override;
 
@@ -162,6 +165,15 @@ protected:
 #if SCRIPTING_ENABLED
 	scripting::Pool * getContextPool() const override;
 #endif
+
+private:
+	/// Alive stack occupying each hex of battlefield, for O(1) lookup of units by position
+	/// Rebuilt by every operation that can move, spawn, kill or remove units. Not serialized
+	std::array<const CStack *, GameConstants::BFIELD_SIZE> hexOccupants{};
+	/// False until battle is initialized via localInit, lookups fall back to scanning all stacks
+	bool hexOccupantsValid = false;
+
+	void updateHexOccupants();
 };
 
 
@@ -50,6 +50,16 @@ battle::Units BattleProxy::getUnitsIf(const battle::UnitFilter & predicate) cons
 	return subject->battleGetUnitsIf(predicate);
 }
 
+const battle::Unit * BattleProxy::getUnitAtPos(BattleHex pos) const
+{
+	return subject->battleGetUnitByPos(pos, true);
+}
+
+const CStack * BattleProxy::getStackAtPos(BattleHex pos) const
+{
+	return subject->battleGetStackByPos(pos, true);
+}
+
 BattleField BattleProxy::getBattlefieldType() const
 {
 	return subject->battleGetBattlefieldType();
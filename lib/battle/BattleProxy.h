@@ -32,6 +32,8 @@ public:
 	TStacks getStacksIf(const TStackFilter & predicate) const override;
 
 	battle::Units getUnitsIf(const battle::UnitFilter & predicate) const override;
+	const battle::Unit * getUnitAtPos(BattleHex pos) const override;
+	const CStack * getStackAtPos(BattleHex pos) const override;
 
 	BattleField getBattlefieldType() const override;
 	TerrainId getTerrainType() const override;
@@ -0,0 +1,359 @@
+/*
+ * BattleTurnOrderCache.cpp, part of VCMI engine
+ *
+ * Authors: listed in file AUTHORS in main folder
+ *
+ * License: GNU General Public License v2.0 or later
+ * Full text of license available in license.txt file, in main folder
+ *
+ */
+#include "StdInc.h"
+#include "BattleTurnOrderCache.h"
+
+#include "CBattleInfoCallback.h"
+
+VCMI_LIB_NAMESPACE_BEGIN
+
+namespace
+{
+/// Unit with its ordering values for one turn, so sorting does not need to query bonuses
+struct TurnOrderCandidate
+{
+	const battle::Unit * unit;
+	int32_t initiative;
+	int32_t creatureIndex;
+	ui8 side;
+	SlotID slot;
+
+	int32_t getInitiative(int turn) const { return initiative; }
+	ui8 unitSide() const { return side; }
+	SlotID unitSlot() const { return slot; }
+};
+
+/// Same ordering as CMP_stack
+struct CandidateComparator
+{
+	int phase;
+	uint8_t side;
+
+	bool operator()(const TurnOrderCandidate * a, const TurnOrderCandidate * b) const
+	{
+		if(phase == battle::BattlePhases::SIEGE) //catapult moves after turrets
+			return a->creatureIndex > b->creatureIndex; //catapult is 145 and turrets are 149
+
+		if(a->initiative != b->initiative)
+			return a->initiative > b->initiative;
+
+		if(a->side == b->side)
+			return a->slot < b->slot;
+
+		return (a->side == side || b->side == side)
+			? a->side != side
+			: a->side < b->side;
+	}
+};
+
+//T is battle::Unit descendant
+template <typename T>
+const T * takeOneUnit(std::vector<const T*> & allUnits, const int turn, int8_t & sideThatLastMoved, int phase)
+{
+	const T * returnedUnit = nullptr;
+	size_t currentUnitIndex = 0;
+
+	for(size_t i = 0; i < allUnits.size(); i++)
+	{
+		int32_t currentUnitInitiative = -1;
+		int32_t returnedUnitInitiative = -1;
+
+		if(returnedUnit)
+			returnedUnitInitiative = returnedUnit->getInitiative(turn);
+
+		if(!allUnits[i])
+			continue;
+
+		auto currentUnit = allUnits[i];
+		currentUnitInitiative = currentUnit->getInitiative(turn);
+
+		switch(phase)
+		{
+		case battle::BattlePhases::NORMAL: // Faster first, attacker priority, higher slot first
+			if(returnedUnit == nullptr || currentUnitInitiative > returnedUnitInitiative)
+			{
+				returnedUnit = currentUnit;
+				currentUnitIndex = i;
+			}
+			else if(currentUnitInitiative == returnedUnitInitiative)
+			{
+				if(sideThatLastMoved == -1 && turn <= 0 && currentUnit->unitSide() == BattleSide::ATTACKER
+					&& !(returnedUnit->unitSide() == currentUnit->unitSide() && returnedUnit->unitSlot() < currentUnit->unitSlot())) // Turn 0 attacker priority
+				{
+					returnedUnit = currentUnit;
+					currentUnitIndex = i;
+				}
+				else if(sideThatLastMoved != -1 && currentUnit->unitSide() != sideThatLastMoved
+					&& !(returnedUnit->unitSide() == currentUnit->unitSide() && returnedUnit->unitSlot() < currentUnit->unitSlot())) // Alternate equal speeds units
+				{
+					returnedUnit = currentUnit;
+					currentUnitIndex = i;
+				}
+			}
+			break;
+		case battle::BattlePhases::WAIT_MORALE: // Slower first, higher slot first
+		case battle::BattlePhases::WAIT:
+			if(returnedUnit == nullptr || currentUnitInitiative < returnedUnitInitiative)
+			{
+				returnedUnit = currentUnit;
+				currentUnitIndex = i;
+			}
+			else if(currentUnitInitiative == returnedUnitInitiative && sideThatLastMoved != -1 && currentUnit->unitSide() != sideThatLastMoved
+				&& !(returnedUnit->unitSide() == currentUnit->unitSide() && returnedUnit->unitSlot() < currentUnit->unitSlot())) // Alternate equal speeds units
+			{
+				returnedUnit = currentUnit;
+				currentUnitIndex = i;
+			}
+			break;
+		default:
+			break;
+		}
+	}
+
+	if(!returnedUnit)
+		return nullptr;
+
+	allUnits[currentUnitIndex] = nullptr;
+
+	return returnedUnit;
+}
+}
+
+BattleTurnOrderCache::UnitState::UnitState(const battle::Unit * unit)
+	: unit(unit),
+	treeVersion(unit->getTreeVersion()),
+	phase(unit->battleQueuePhase(0)),
+	alive(unit->alive()),
+	defended(unit->defended()),
+	moved(unit->moved()),
+	waited(unit->waited())
+{
+}
+
+bool BattleTurnOrderCache::UnitState::operator==(const UnitState & other) const
+{
+	return unit == other.unit
+		&& treeVersion == other.treeVersion
+		&& phase == other.phase
+		&& alive == other.alive
+		&& defended == other.defended
+		&& moved == other.moved
+		&& waited == other.waited;
+}
+
+bool BattleTurnOrderCache::QueueRequest::operator==(const QueueRequest & other) const
+{
+	return activeUnit == other.activeUnit
+		&& maxUnits == other.maxUnits
+		&& maxTurns == other.maxTurns
+		&& turn == other.turn
+		&& sideThatLastMoved == other.sideThatLastMoved;
+}
+
+BattleTurnOrderCache::UnitEntry::UnitEntry(const UnitState & state)
+	: state(state),
+	willMove(state.unit->willMove()),
+	willEverMove(state.unit->willMove(100000)) //little evil, but 100000 should be enough for all effects to disappear
+{
+}
+
+const BattleTurnOrderCache::UnitTurn & BattleTurnOrderCache::UnitEntry::getTurn(int turn)
+{
+	auto found = turns.find(turn);
+
+	if(found != turns.end())
+		return found->second;
+
+	UnitTurn result;
+
+	result.initiative = state.unit->getInitiative(std::max(turn, 0));
+	result.phase = state.unit->battleQueuePhase(turn);
+	result.canMove = state.unit->canMove(turn);
+
+	return turns.emplace(turn, result).first->second;
+}
+
+BattleTurnOrderCache::BattleTurnOrderCache(const BattleTurnOrderCache &)
+{
+}
+
+BattleTurnOrderCache & BattleTurnOrderCache::operator=(const BattleTurnOrderCache &)
+{
+	boost::lock_guard<boost::mutex> lock(locker);
+
+	units.clear();
+	lastState.clear();
+	lastRequest.reset();
+	lastTurns.clear();
+
+	return *this;
+}
+
+void BattleTurnOrderCache::getTurnOrder(const CBattleInfoCallback & battle, std::vector<battle::Units> & turns, const size_t maxUnits, const int maxTurns, const int turn, int8_t sideThatLastMoved)
+{
+	auto allUnits = battle.battleGetUnitsIf([](const battle::Unit * unit)
+	{
+		return !unit->isGhost();
+	});
+
+	QueueRequest request{battle.battleActiveUnit(), maxUnits, maxTurns, turn, sideThatLastMoved};
+	std::vector<UnitState> state;
+
+	state.reserve(allUnits.size());
+
+	for(const auto * unit : allUnits)
+		state.emplace_back(unit);
+
+	boost::lock_guard<boost::mutex> lock(locker);
+
+	if(turns.empty() && lastRequest && *lastRequest == request && lastState == state)
+	{
+		turns = lastTurns;
+		return;
+	}
+
+	// entries of units with unchanged state are reused, entries of removed units are dropped
+	std::map<uint32_t, UnitEntry> updatedUnits;
+
+	for(const auto & unitState : state)
+	{
+		uint32_t unitId = unitState.unit->unitId();
+		auto existing = units.find(unitId);
+
+		if(existing != units.end() && existing->second.state == unitState)
+			updatedUnits.emplace(unitId, std::move(existing->second));
+		else
+			updatedUnits.emplace(unitId, UnitEntry(unitState));
+	}
+
+	units = std::move(updatedUnits);
+
+	std::vector<UnitEntry *> entries;
+
+	for(const auto & unitState : state)
+		entries.push_back(&units.at(unitState.unit->unitId()));
+
+	bool storeResult = turns.empty();
+
+	computeTurnOrder(turns, entries, request.activeUnit, maxUnits, maxTurns, turn, sideThatLastMoved);
+
+	if(storeResult)
+	{
+		lastState = std::move(state);
+		lastRequest = request;
+		lastTurns = turns;
+	}
+}
+
+void BattleTurnOrderCache::computeTurnOrder(std::vector<battle::Units> & turns, const std::vector<UnitEntry *> & entries, const battle::Unit * activeUnit, const size_t maxUnits, const int maxTurns, const int turn, int8_t sideThatLastMoved)
+{
+	auto actualTurn = turn > 0 ? turn : 0;
+
+	auto turnsIsFull = [&]() -> bool
+	{
+		if(maxUnits == 0)
+			return false;//no limit
+
+		size_t turnsSize = 0;
+		for(const auto & oneTurn : turns)
+			turnsSize += oneTurn.size();
+		return turnsSize >= maxUnits;
+	};
+
+	turns.emplace_back();
+
+	if(activeUnit)
+	{
+		//its first turn and active unit hasn't taken any action yet - must be placed at the beginning of queue, no matter what
+		if(turn == 0 && activeUnit->willMove() && !activeUnit->waited())
+		{
+			turns.back().push_back(activeUnit);
+			if(turnsIsFull())
+				return;
+		}
+
+		//its first or current turn, turn priority for active stack side
+		//TODO: what if active stack mind-controlled?
+		if(turn <= 0 && sideThatLastMoved < 0)
+			sideThatLastMoved = activeUnit->unitSide();
+	}
+
+	// If no unit will be EVER! able to move, battle is over.
+	if(!vstd::contains_if(entries, [](const UnitEntry * entry) { return entry->willEverMove; }))
+	{
+		turns.clear();
+		return;
+	}
+
+	std::vector<TurnOrderCandidate> candidates;
+
+	// phases refer to candidates by pointer, so candidates must not be reallocated
+	candidates.reserve(entries.size());
+
+	// We'll split creatures with remaining movement to 4 buckets (SIEGE, NORMAL, WAIT_MORALE, WAIT)
+	std::array<std::vector<const TurnOrderCandidate *>, battle::BattlePhases::NUMBER_OF_PHASES> phases; // Access using BattlePhases enum
+
+	for(auto * entry : entries)
+	{
+		const battle::Unit * unit = entry->state.unit;
+
+		if((actualTurn == 0 && !entry->willMove) //we are considering current round and unit won't move
+		|| (actualTurn > 0 && !entry->getTurn(turn).canMove) //unit won't be able to move in later rounds
+		|| (actualTurn == 0 && unit == activeUnit && !turns.at(0).empty() && unit == turns.front().front())) //it's active unit already added at the beginning of queue
+		{
+			continue;
+		}
+
+		const UnitTurn & unitTurn = entry->getTurn(turn);
+
+		candidates.push_back(TurnOrderCandidate{unit, unitTurn.initiative, unit->creatureIndex(), unit->unitSide(), unit->unitSlot()});
+		phases[unitTurn.phase].push_back(&candidates.back());
+	}
+
+	boost::sort(phases[battle::BattlePhases::SIEGE], CandidateComparator{battle::BattlePhases::SIEGE, static_cast<uint8_t>(sideThatLastMoved)});
+
+	for(const auto * candidate : phases[battle::BattlePhases::SIEGE])
+		turns.back().push_back(candidate->unit);
+
+	if(turnsIsFull())
+		return;
+
+	for(uint8_t phase = battle::BattlePhases::NORMAL; phase < battle::BattlePhases::NUMBER_OF_PHASES; phase++)
+		boost::sort(phases[phase], CandidateComparator{phase, static_cast<uint8_t>(sideThatLastMoved)});
+
+	uint8_t phase = battle::BattlePhases::NORMAL;
+	while(!turnsIsFull() && phase < battle::BattlePhases::NUMBER_OF_PHASES)
+	{
+		const TurnOrderCandidate * currentUnit = nullptr;
+		if(phases[phase].empty())
+			phase++;
+		else
+		{
+			currentUnit = takeOneUnit(phases[phase], actualTurn, sideThatLastMoved, phase);
+			if(!currentUnit)
+			{
+				phase++;
+			}
+			else
+			{
+				turns.back().push_back(currentUnit->unit);
+				sideThatLastMoved = currentUnit->side;
+			}
+		}
+	}
+
+	if(sideThatLastMoved < 0)
+		sideThatLastMoved = BattleSide::ATTACKER;
+
+	if(!turnsIsFull() && (maxTurns == 0 || turns.size() < maxTurns))
+		computeTurnOrder(turns, entries, activeUnit, maxUnits, maxTurns, actualTurn + 1, sideThatLastMoved);
+}
+
+VCMI_LIB_NAMESPACE_END
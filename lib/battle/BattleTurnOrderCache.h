@@ -0,0 +1,88 @@
+/*
+ * BattleTurnOrderCache.h, part of VCMI engine
+ *
+ * Authors: listed in file AUTHORS in main folder
+ *
+ * License: GNU General Public License v2.0 or later
+ * Full text of license available in license.txt file, in main folder
+ *
+ */
+#pragma once
+
+#include "IBattleInfoCallback.h"
+#include "Unit.h"
+
+VCMI_LIB_NAMESPACE_BEGIN
+
+class CBattleInfoCallback;
+
+/// Computes turn order of battle and keeps it until state of battle changes.
+/// Each unit is keyed by its bonus tree version and turn-related state (alive, waited, defended, moved),
+/// bonuses are queried again only for units which acted, waited, died or got their bonuses changed since previous call.
+/// Copies of cache start empty, since copied battle state may diverge from original
+class DLL_LINKAGE BattleTurnOrderCache
+{
+	/// State of unit that can affect its position in queue
+	struct UnitState
+	{
+		const battle::Unit * unit;
+		int64_t treeVersion;
+		battle::BattlePhases::Type phase;
+		bool alive;
+		bool defended;
+		bool moved;
+		bool waited;
+
+		explicit UnitState(const battle::Unit * unit);
+		bool operator==(const UnitState & other) const;
+	};
+
+	/// Values of unit that are used for ordering on specific turn
+	struct UnitTurn
+	{
+		int32_t initiative;
+		battle::BattlePhases::Type phase;
+		bool canMove;
+	};
+
+	struct UnitEntry
+	{
+		UnitState state;
+		bool willMove;
+		bool willEverMove;
+		std::map<int, UnitTurn> turns;
+
+		explicit UnitEntry(const UnitState & state);
+		const UnitTurn & getTurn(int turn);
+	};
+
+	struct QueueRequest
+	{
+		const battle::Unit * activeUnit;
+		size_t maxUnits;
+		int maxTurns;
+		int turn;
+		int8_t sideThatLastMoved;
+
+		bool operator==(const QueueRequest & other) const;
+	};
+
+	boost::mutex locker;
+	std::map<uint32_t, UnitEntry> units;
+
+	std::vector<UnitState> lastState;
+	std::optional<QueueRequest> lastRequest;
+	std::vector<battle::Units> lastTurns;
+
+	void computeTurnOrder(std::vector<battle::Units> & turns, const std::vector<UnitEntry *> & entries, const battle::Unit * activeUnit, const size_t maxUnits, const int maxTurns, const int turn, int8_t sideThatLastMoved);
+
+public:
+	BattleTurnOrderCache() = default;
+	BattleTurnOrderCache(const BattleTurnOrderCache & other);
+	BattleTurnOrderCache & operator=(const BattleTurnOrderCache & other);
+
+	/// Same as CBattleInfoCallback::battleGetTurnOrder
+	void getTurnOrder(const CBattleInfoCallback & battle, std::vector<battle::Units> & turns, const size_t maxUnits, const int maxTurns, const int turn, int8_t sideThatLastMoved);
+};
+
+VCMI_LIB_NAMESPACE_END
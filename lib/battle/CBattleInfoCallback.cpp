@@ -328,8 +328,13 @@ std::set<BattleHex> CBattleInfoCallback::battleGetAttackedHexes(const battle::Un
 const CStack* CBattleInfoCallback::battleGetStackByPos(BattleHex pos, bool onlyAlive) const
 {
 	RETURN_IF_NOT_BATTLE(nullptr);
+
+	const auto * alive = getBattle()->getStackAtPos(pos);
+	if(alive || onlyAlive)
+		return alive;
+
 	for(const auto * s : battleGetAllStacks(true))
-		if(vstd::contains(s->getHexes(), pos) && (!onlyAlive || s->alive()))
+		if(s->coversPos(pos))
 			return s;
 
 	return nullptr;
@@ -339,11 +344,14 @@ const battle::Unit * CBattleInfoCallback::battleGetUnitByPos(BattleHex pos, bool
 {
 	RETURN_IF_NOT_BATTLE(nullptr);
 
+	const auto * alive = getBattle()->getUnitAtPos(pos);
+	if(alive || onlyAlive)
+		return alive;
+
+	//no living unit on this hex, look for dead ones
 	auto ret = battleGetUnitsIf([=](const battle::Unit * unit)
 	{
-		return !unit->isGhost()
-			&& unit->coversPos(pos)
-			&& (!onlyAlive || unit->alive());
+		return !unit->isGhost() && unit->coversPos(pos);
 	});
 
 	if(!ret.empty())
@@ -370,78 +378,6 @@ battle::Units CBattleInfoCallback::battleAliveUnits(ui8 side) const
 
 using namespace battle;
 
-//T is battle::Unit descendant
-template <typename T>
-const T * takeOneUnit(std::vector<const T*> & allUnits, const int turn, int8_t & sideThatLastMoved, int phase)
-{
-	const T * returnedUnit = nullptr;
-	size_t currentUnitIndex = 0;
-
-	for(size_t i = 0; i < allUnits.size(); i++)
-	{
-		int32_t currentUnitInitiative = -1;
-		int32_t returnedUnitInitiative = -1;
-
-		if(returnedUnit)
-			returnedUnitInitiative = returnedUnit->getInitiative(turn);
-
-		if(!allUnits[i])
-			continue;
-
-		auto currentUnit = allUnits[i];
-		currentUnitInitiative = currentUnit->getInitiative(turn);
-
-		switch(phase)
-		{
-		case BattlePhases::NORMAL: // Faster first, attacker priority, higher slot first
-			if(returnedUnit == nullptr || currentUnitInitiative > returnedUnitInitiative)
-			{
-				returnedUnit = currentUnit;
-				currentUnitIndex = i;
-			}
-			else if(currentUnitInitiative == returnedUnitInitiative)
-			{
-				if(sideThatLastMoved == -1 && turn <= 0 && currentUnit->unitSide() == BattleSide::ATTACKER
-					&& !(returnedUnit->unitSide() == currentUnit->unitSide() && returnedUnit->unitSlot() < currentUnit->unitSlot())) // Turn 0 attacker priority
-				{
-					returnedUnit = currentUnit;
-					currentUnitIndex = i;
-				}
-				else if(sideThatLastMoved != -1 && currentUnit->unitSide() != sideThatLastMoved
-					&& !(returnedUnit->unitSide() == currentUnit->unitSide() && returnedUnit->unitSlot() < currentUnit->unitSlot())) // Alternate equal speeds units
-				{
-					returnedUnit = currentUnit;
-					currentUnitIndex = i;
-				}
-			}
-			break;
-		case BattlePhases::WAIT_MORALE: // Slower first, higher slot first
-		case BattlePhases::WAIT:
-			if(returnedUnit == nullptr || currentUnitInitiative < returnedUnitInitiative)
-			{
-				returnedUnit = currentUnit;
-				currentUnitIndex = i;
-			}
-			else if(currentUnitInitiative == returnedUnitInitiative && sideThatLastMoved != -1 && currentUnit->unitSide() != sideThatLastMoved
-				&& !(returnedUnit->unitSide() == currentUnit->unitSide() && returnedUnit->unitSlot() < currentUnit->unitSlot())) // Alternate equal speeds units
-			{
-				returnedUnit = currentUnit;
-				currentUnitIndex = i;
-			}
-			break;
-		default:
-			break;
-		}
-	}
-
-	if(!returnedUnit)
-		return nullptr;
-
-	allUnits[currentUnitIndex] = nullptr;
-
-	return returnedUnit;
-}
-
 void CBattleInfoCallback::battleGetTurnOrder(std::vector<battle::Units> & turns, const size_t maxUnits, const int maxTurns, const int turn, int8_t sideThatLastMoved) const
 {
 	RETURN_IF_NOT_BATTLE();
@@ -452,103 +388,7 @@ void CBattleInfoCallback::battleGetTurnOrder(std::vector<battle::Units> & turns,
 		return;
 	}
 
-	auto actualTurn = turn > 0 ? turn : 0;
-
-	auto turnsIsFull = [&]() -> bool
-	{
-		if(maxUnits == 0)
-			return false;//no limit
-
-		size_t turnsSize = 0;
-		for(const auto & oneTurn : turns)
-			turnsSize += oneTurn.size();
-		return turnsSize >= maxUnits;
-	};
-
-	turns.emplace_back();
-
-	// We'll split creatures with remaining movement to 4 buckets (SIEGE, NORMAL, WAIT_MORALE, WAIT)
-	std::array<battle::Units, BattlePhases::NUMBER_OF_PHASES> phases; // Access using BattlePhases enum
-
-	const battle::Unit * activeUnit = battleActiveUnit();
-
-	if(activeUnit)
-	{
-		//its first turn and active unit hasn't taken any action yet - must be placed at the beginning of queue, no matter what
-		if(turn == 0 && activeUnit->willMove() && !activeUnit->waited())
-		{
-			turns.back().push_back(activeUnit);
-			if(turnsIsFull())
-				return;
-		}
-
-		//its first or current turn, turn priority for active stack side
-		//TODO: what if active stack mind-controlled?
-		if(turn <= 0 && sideThatLastMoved < 0)
-			sideThatLastMoved = activeUnit->unitSide();
-	}
-
-	auto allUnits = battleGetUnitsIf([](const battle::Unit * unit)
-	{
-		return !unit->isGhost();
-	});
-
-	// If no unit will be EVER! able to move, battle is over.
-	if(!vstd::contains_if(allUnits, [](const battle::Unit * unit) { return unit->willMove(100000); })) //little evil, but 100000 should be enough for all effects to disappear
-	{
-		turns.clear();
-		return;
-	}
-
-	for(const auto * unit : allUnits)
-	{
-		if((actualTurn == 0 && !unit->willMove()) //we are considering current round and unit won't move
-		|| (actualTurn > 0 && !unit->canMove(turn)) //unit won't be able to move in later rounds
-		|| (actualTurn == 0 && unit == activeUnit && !turns.at(0).empty() && unit == turns.front().front())) //it's active unit already added at the beginning of queue
-		{
-			continue;
-		}
-
-		int unitPhase = unit->battleQueuePhase(turn);
-
-		phases[unitPhase].push_back(unit);
-	}
-
-	boost::sort(phases[BattlePhases::SIEGE], CMP_stack(BattlePhases::SIEGE, actualTurn, sideThatLastMoved));
-	std::copy(phases[BattlePhases::SIEGE].begin(), phases[BattlePhases::SIEGE].end(), std::back_inserter(turns.back()));
-
-	if(turnsIsFull())
-		return;
-
-	for(uint8_t phase = BattlePhases::NORMAL; phase < BattlePhases::NUMBER_OF_PHASES; phase++)
-		boost::sort(phases[phase], CMP_stack(phase, actualTurn, sideThatLastMoved));
-
-	uint8_t phase = BattlePhases::NORMAL;
-	while(!turnsIsFull() && phase < BattlePhases::NUMBER_OF_PHASES)
-	{
-		const battle::Unit * currentUnit = nullptr;
-		if(phases[phase].empty())
-			phase++;
-		else
-		{
-			currentUnit = takeOneUnit(phases[phase], actualTurn, sideThatLastMoved, phase);
-			if(!currentUnit)
-			{
-				phase++;
-			}
-			else
-			{
-				turns.back().push_back(currentUnit);
-				sideThatLastMoved = currentUnit->unitSide();
-			}
-		}
-	}
-
-	if(sideThatLastMoved < 0)
-		sideThatLastMoved = BattleSide::ATTACKER;
-
-	if(!turnsIsFull() && (maxTurns == 0 || turns.size() < maxTurns))
-		battleGetTurnOrder(turns, maxUnits, maxTurns, actualTurn + 1, sideThatLastMoved);
+	turnOrderCache.getTurnOrder(*this, turns, maxUnits, maxTurns, turn, sideThatLastMoved);
 }
 
 std::vector<BattleHex> CBattleInfoCallback::battleGetAvailableHexes(const battle::Unit * unit, bool obtainMovementRange) const
@@ -738,6 +578,13 @@ DamageEstimation CBattleInfoCallback::calculateDmgRange(const BattleAttackInfo &
 	return calculator.calculateDmgRange();
 }
 
+std::vector<DamageEstimation> CBattleInfoCallback::calculateDmgRanges(const std::vector<BattleAttackInfo> & attacks) const
+{
+	RETURN_IF_NOT_BATTLE({});
+
+	return DamageCalculator::calculateDmgRanges(*this, attacks);
+}
+
 DamageEstimation CBattleInfoCallback::battleEstimateDamage(const battle::Unit * attacker, const battle::Unit * defender, BattleHex attackerPosition, DamageEstimation * retaliationDmg) const
 {
 	RETURN_IF_NOT_BATTLE({});
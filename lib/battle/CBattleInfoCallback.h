@@ -13,6 +13,7 @@
 
 #include "ReachabilityInfo.h"
 #include "BattleAttackInfo.h"
+#include "BattleTurnOrderCache.h"
 
 VCMI_LIB_NAMESPACE_BEGIN
 
@@ -92,6 +93,8 @@ public:
 	std::set<const battle::Unit *> battleAdjacentUnits(const battle::Unit * unit) const;
 
 	DamageEstimation calculateDmgRange(const BattleAttackInfo & info) const;
+	/// same as calculateDmgRange for each attack, but evaluates bonuses of each unit only once
+	std::vector<DamageEstimation> calculateDmgRanges(const std::vector<BattleAttackInfo> & attacks) const;
 
 	/// estimates damage dealt by attacker to defender;
 	/// only non-random bonuses are considered in estimation
@@ -145,6 +148,9 @@ protected:
 	ReachabilityInfo makeBFS(const AccessibilityInfo & accessibility, const ReachabilityInfo::Parameters & params) const;
 	bool isInObstacle(BattleHex hex, const std::set<BattleHex> & obstacles, const ReachabilityInfo::Parameters & params) const;
 	std::set<BattleHex> getStoppers(BattlePerspective::BattlePerspective whichSidePerspective) const; //get hexes with stopping obstacles (quicksands)
+
+private:
+	mutable BattleTurnOrderCache turnOrderCache;
 };
 
 VCMI_LIB_NAMESPACE_END
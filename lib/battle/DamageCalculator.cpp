@@ -21,20 +21,59 @@
 
 VCMI_LIB_NAMESPACE_BEGIN
 
-DamageRange DamageCalculator::getBaseDamageSingle() const
+struct DamageCalculator::AttackerFactors
+{
+	DamageRange baseDamage;
+	int attack;
+	/// level of Slayer spell, -1 if attacker is not affected by Slayer
+	int slayerLevel;
+	int slayerAttackBonus;
+	int enemyDefenceReductionPercent;
+	int joustingPercent;
+	double offenseArcheryFactor;
+	double blessFactor;
+	double doubleDamageFactor;
+	double revengeFactor;
+	double blindParalysisFactor;
+	double forgetfulnessFactor;
+	bool meleePenalty;
+	bool magicElemental;
+	bool psychicElemental;
+	TConstBonusListPtr hateEffects;
+};
+
+struct DamageCalculator::DefenderFactors
+{
+	CreatureID creature;
+	int defense;
+	/// level of KING bonus, -1 if defender is not affected by Slayer
+	int kingLevel;
+	int enemyAttackReductionPercent;
+	double armorerFactor;
+	double magicShieldFactor;
+	double petrificationFactor;
+	int64_t firstHPleft;
+	int64_t maxHealth;
+	bool chargeImmunity;
+	bool advancedAirShield;
+	bool magicImmunity;
+	bool mindImmunity;
+};
+
+DamageRange DamageCalculator::getBaseDamageSingle(const CBattleInfoCallback & callback, const battle::Unit * attacker, bool shooting)
 {
 	int64_t minDmg = 0.0;
 	int64_t maxDmg = 0.0;
 
-	minDmg = info.attacker->getMinDamage(info.shooting);
-	maxDmg = info.attacker->getMaxDamage(info.shooting);
+	minDmg = attacker->getMinDamage(shooting);
+	maxDmg = attacker->getMaxDamage(shooting);
 
-	if(info.attacker->creatureIndex() == CreatureID::ARROW_TOWERS)
+	if(attacker->creatureIndex() == CreatureID::ARROW_TOWERS)
 	{
 		const auto * town = callback.battleGetDefendedTown();
 		assert(town);
 
-		switch(info.attacker->getPosition())
+		switch(attacker->getPosition())
 		{
 		case BattleHex::CASTLE_CENTRAL_TOWER:
 			return town->getKeepDamageRange();
@@ -49,11 +88,11 @@ DamageRange DamageCalculator::getBaseDamageSingle() const
 	const std::string cachingStrSiedgeWeapon = "type_SIEGE_WEAPON";
 	static const auto selectorSiedgeWeapon = Selector::type()(BonusType::SIEGE_WEAPON);
 
-	if(info.attacker->hasBonus(selectorSiedgeWeapon, cachingStrSiedgeWeapon) && info.attacker->creatureIndex() != CreatureID::ARROW_TOWERS)
+	if(attacker->hasBonus(selectorSiedgeWeapon, cachingStrSiedgeWeapon) && attacker->creatureIndex() != CreatureID::ARROW_TOWERS)
 	{
 		auto retrieveHeroPrimSkill = [&](PrimarySkill skill) -> int
 		{
-			std::shared_ptr<const Bonus> b = info.attacker->getBonus(Selector::sourceTypeSel(BonusSource::HERO_BASE_SKILL).And(Selector::typeSubtype(BonusType::PRIMARY_SKILL, BonusSubtypeID(skill))));
+			std::shared_ptr<const Bonus> b = attacker->getBonus(Selector::sourceTypeSel(BonusSource::HERO_BASE_SKILL).And(Selector::typeSubtype(BonusType::PRIMARY_SKILL, BonusSubtypeID(skill))));
 			return b ? b->val : 0;
 		};
 
@@ -64,7 +103,7 @@ DamageRange DamageCalculator::getBaseDamageSingle() const
 	return { minDmg, maxDmg };
 }
 
-DamageRange DamageCalculator::getBaseDamageBlessCurse() const
+DamageRange DamageCalculator::getBaseDamageBlessCurse(const CBattleInfoCallback & callback, const battle::Unit * attacker, bool shooting)
 {
 	const std::string cachingStrForcedMinDamage = "type_ALWAYS_MINIMUM_DAMAGE";
 	static const auto selectorForcedMinDamage = Selector::type()(BonusType::ALWAYS_MINIMUM_DAMAGE);
@@ -72,12 +111,12 @@ DamageRange DamageCalculator::getBaseDamageBlessCurse() const
 	const std::string cachingStrForcedMaxDamage = "type_ALWAYS_MAXIMUM_DAMAGE";
 	static const auto selectorForcedMaxDamage = Selector::type()(BonusType::ALWAYS_MAXIMUM_DAMAGE);
 
-	TConstBonusListPtr curseEffects = info.attacker->getBonuses(selectorForcedMinDamage, cachingStrForcedMinDamage);
-	TConstBonusListPtr blessEffects = info.attacker->getBonuses(selectorForcedMaxDamage, cachingStrForcedMaxDamage);
+	TConstBonusListPtr curseEffects = attacker->getBonuses(selectorForcedMinDamage, cachingStrForcedMinDamage);
+	TConstBonusListPtr blessEffects = attacker->getBonuses(selectorForcedMaxDamage, cachingStrForcedMaxDamage);
 
 	int curseBlessAdditiveModifier = blessEffects->totalValue() - curseEffects->totalValue();
 
-	DamageRange baseDamage = getBaseDamageSingle();
+	DamageRange baseDamage = getBaseDamageSingle(callback, attacker, shooting);
 	DamageRange modifiedDamage = {
 		std::max(static_cast<int64_t>(1), baseDamage.min + curseBlessAdditiveModifier),
 		std::max(static_cast<int64_t>(1), baseDamage.max + curseBlessAdditiveModifier)
@@ -108,237 +147,183 @@ DamageRange DamageCalculator::getBaseDamageBlessCurse() const
 	return modifiedDamage;
 }
 
-DamageRange DamageCalculator::getBaseDamageStack() const
+DamageRange DamageCalculator::getBaseDamageStack(const CBattleInfoCallback & callback, const battle::Unit * attacker, bool shooting)
 {
-	auto stackSize = info.attacker->getCount();
-	auto baseDamage = getBaseDamageBlessCurse();
+	auto stackSize = attacker->getCount();
+	auto baseDamage = getBaseDamageBlessCurse(callback, attacker, shooting);
 	return {
 		baseDamage.min * stackSize,
 		baseDamage.max * stackSize
 	};
 }
 
-int DamageCalculator::getActorAttackBase() const
-{
-	return info.attacker->getAttack(info.shooting);
-}
-
-int DamageCalculator::getActorAttackEffective() const
+DamageCalculator::AttackerFactors DamageCalculator::getAttackerFactors(const CBattleInfoCallback & callback, const battle::Unit * attacker, bool shooting)
 {
-	return getActorAttackBase() + getActorAttackSlayer() + getActorAttackIgnored();
-}
+	AttackerFactors result;
 
-int DamageCalculator::getActorAttackIgnored() const
-{
-	int multAttackReductionPercent = battleBonusValue(info.defender, Selector::type()(BonusType::ENEMY_ATTACK_REDUCTION));
+	result.baseDamage = getBaseDamageStack(callback, attacker, shooting);
+	result.attack = attacker->getAttack(shooting);
+	result.enemyDefenceReductionPercent = battleBonusValue(attacker, Selector::type()(BonusType::ENEMY_DEFENCE_REDUCTION), shooting);
 
-	if(multAttackReductionPercent > 0)
+	// slayer
 	{
-		int reduction = (getActorAttackBase() * multAttackReductionPercent + 49) / 100; //using ints so 1.5 for 5 attack is rounded down as in HotA / h3assist etc. (keep in mind h3assist 1.2 shows wrong value for 15 attack points and unupg. nix)
-		return -std::min(reduction, getActorAttackBase());
-	}
-	return 0;
-}
-
-int DamageCalculator::getActorAttackSlayer() const
-{
-	const std::string cachingStrSlayer = "type_SLAYER";
-	static const auto selectorSlayer = Selector::type()(BonusType::SLAYER);
-
-	if (!info.defender->hasBonusOfType(BonusType::KING))
-		return 0;
+		const std::string cachingStrSlayer = "type_SLAYER";
+		static const auto selectorSlayer = Selector::type()(BonusType::SLAYER);
 
-	auto slayerEffects = info.attacker->getBonuses(selectorSlayer, cachingStrSlayer);
-	auto slayerAffected = info.defender->unitType()->valOfBonuses(Selector::type()(BonusType::KING));
+		auto slayerEffects = attacker->getBonuses(selectorSlayer, cachingStrSlayer);
 
-	if(std::shared_ptr<const Bonus> slayerEffect = slayerEffects->getFirst(Selector::all))
-	{
-		const auto spLevel = slayerEffect->val;
-		bool isAffected = spLevel >= slayerAffected;
+		result.slayerLevel = -1;
+		result.slayerAttackBonus = 0;
 
-		if(isAffected)
+		if(std::shared_ptr<const Bonus> slayerEffect = slayerEffects->getFirst(Selector::all))
 		{
 			SpellID spell(SpellID::SLAYER);
-			int attackBonus = spell.toSpell()->getLevelPower(spLevel);
-			if(info.attacker->hasBonusOfType(BonusType::SPECIAL_PECULIAR_ENCHANT, BonusSubtypeID(spell)))
+
+			result.slayerLevel = slayerEffect->val;
+			result.slayerAttackBonus = spell.toSpell()->getLevelPower(result.slayerLevel);
+
+			if(attacker->hasBonusOfType(BonusType::SPECIAL_PECULIAR_ENCHANT, BonusSubtypeID(spell)))
 			{
-				ui8 attackerTier = info.attacker->unitType()->getLevel();
+				ui8 attackerTier = attacker->unitType()->getLevel();
 				ui8 specialtyBonus = std::max(5 - attackerTier, 0);
-				attackBonus += specialtyBonus;
+				result.slayerAttackBonus += specialtyBonus;
 			}
-			return attackBonus;
 		}
 	}
-	return 0;
-}
-
-int DamageCalculator::getTargetDefenseBase() const
-{
-	return info.defender->getDefense(info.shooting);
-}
-
-int DamageCalculator::getTargetDefenseEffective() const
-{
-	return getTargetDefenseBase() + getTargetDefenseIgnored();
-}
 
-int DamageCalculator::getTargetDefenseIgnored() const
-{
-	double multDefenceReduction = battleBonusValue(info.attacker, Selector::type()(BonusType::ENEMY_DEFENCE_REDUCTION)) / 100.0;
-
-	if(multDefenceReduction > 0)
+	// offense & archery
+	if(shooting)
 	{
-		int reduction = std::floor(multDefenceReduction * getTargetDefenseBase()) + 1;
-		return -std::min(reduction,getTargetDefenseBase());
+		const std::string cachingStrArchery = "type_PERCENTAGE_DAMAGE_BOOSTs_1";
+		static const auto selectorArchery = Selector::typeSubtype(BonusType::PERCENTAGE_DAMAGE_BOOST, BonusCustomSubtype::damageTypeRanged);
+		result.offenseArcheryFactor = attacker->valOfBonuses(selectorArchery, cachingStrArchery) / 100.0;
 	}
-	return 0;
-}
-
-double DamageCalculator::getAttackSkillFactor() const
-{
-	int attackAdvantage = getActorAttackEffective() - getTargetDefenseEffective();
-
-	if(attackAdvantage > 0)
+	else
 	{
-		const double attackMultiplier = VLC->settings()->getDouble(EGameSettings::COMBAT_ATTACK_POINT_DAMAGE_FACTOR);
-		const double attackMultiplierCap = VLC->settings()->getDouble(EGameSettings::COMBAT_ATTACK_POINT_DAMAGE_FACTOR_CAP);
-		const double attackFactor = std::min(attackMultiplier * attackAdvantage, attackMultiplierCap);
-
-		return attackFactor;
+		const std::string cachingStrOffence = "type_PERCENTAGE_DAMAGE_BOOSTs_0";
+		static const auto selectorOffence = Selector::typeSubtype(BonusType::PERCENTAGE_DAMAGE_BOOST, BonusCustomSubtype::damageTypeMelee);
+		result.offenseArcheryFactor = attacker->valOfBonuses(selectorOffence, cachingStrOffence) / 100.0;
 	}
-	return 0.f;
-}
-
-double DamageCalculator::getAttackBlessFactor() const
-{
-	const std::string cachingStrDamage = "type_GENERAL_DAMAGE_PREMY";
-	static const auto selectorDamage = Selector::type()(BonusType::GENERAL_DAMAGE_PREMY);
-	return info.attacker->valOfBonuses(selectorDamage, cachingStrDamage) / 100.0;
-}
 
-double DamageCalculator::getAttackOffenseArcheryFactor() const
-{
-	
-	if(info.shooting)
+	// bless
 	{
-		const std::string cachingStrArchery = "type_PERCENTAGE_DAMAGE_BOOSTs_1";
-		static const auto selectorArchery = Selector::typeSubtype(BonusType::PERCENTAGE_DAMAGE_BOOST, BonusCustomSubtype::damageTypeRanged);
-		return info.attacker->valOfBonuses(selectorArchery, cachingStrArchery) / 100.0;
+		const std::string cachingStrDamage = "type_GENERAL_DAMAGE_PREMY";
+		static const auto selectorDamage = Selector::type()(BonusType::GENERAL_DAMAGE_PREMY);
+		result.blessFactor = attacker->valOfBonuses(selectorDamage, cachingStrDamage) / 100.0;
 	}
-	const std::string cachingStrOffence = "type_PERCENTAGE_DAMAGE_BOOSTs_0";
-	static const auto selectorOffence = Selector::typeSubtype(BonusType::PERCENTAGE_DAMAGE_BOOST, BonusCustomSubtype::damageTypeMelee);
-	return info.attacker->valOfBonuses(selectorOffence, cachingStrOffence) / 100.0;
-}
-
-double DamageCalculator::getAttackLuckFactor() const
-{
-	if(info.luckyStrike)
-		return 1.0;
-	return 0.0;
-}
 
-double DamageCalculator::getAttackDeathBlowFactor() const
-{
-	if(info.deathBlow)
-		return 1.0;
-	return 0.0;
-}
-
-double DamageCalculator::getAttackDoubleDamageFactor() const
-{
-	if(info.doubleDamage) {
-		const auto cachingStr = "type_BONUS_DAMAGE_PERCENTAGEs_" + std::to_string(info.attacker->creatureIndex());
-		const auto selector = Selector::typeSubtype(BonusType::BONUS_DAMAGE_PERCENTAGE, BonusSubtypeID(info.attacker->creatureId()));
-		return info.attacker->valOfBonuses(selector, cachingStr) / 100.0;
+	// double damage, applied only to attacks with doubleDamage flag
+	{
+		const auto cachingStr = "type_BONUS_DAMAGE_PERCENTAGEs_" + std::to_string(attacker->creatureIndex());
+		const auto selector = Selector::typeSubtype(BonusType::BONUS_DAMAGE_PERCENTAGE, BonusSubtypeID(attacker->creatureId()));
+		result.doubleDamageFactor = attacker->valOfBonuses(selector, cachingStr) / 100.0;
 	}
-	return 0.0;
-}
 
-double DamageCalculator::getAttackJoustingFactor() const
-{
-	const std::string cachingStrJousting = "type_JOUSTING";
-	static const auto selectorJousting = Selector::type()(BonusType::JOUSTING);
+	// jousting
+	{
+		const std::string cachingStrJousting = "type_JOUSTING";
+		static const auto selectorJousting = Selector::type()(BonusType::JOUSTING);
 
-	const std::string cachingStrChargeImmunity = "type_CHARGE_IMMUNITY";
-	static const auto selectorChargeImmunity = Selector::type()(BonusType::CHARGE_IMMUNITY);
+		result.joustingPercent = attacker->hasBonus(selectorJousting, cachingStrJousting) ? attacker->valOfBonuses(selectorJousting) : 0;
+	}
 
-	//applying jousting bonus
-	if(info.chargeDistance > 0 && info.attacker->hasBonus(selectorJousting, cachingStrJousting) && !info.defender->hasBonus(selectorChargeImmunity, cachingStrChargeImmunity))
-		return info.chargeDistance * (info.attacker->valOfBonuses(selectorJousting))/100.0;
-	return 0.0;
-}
+	// hate
+	{
+		//assume that unit have only few HATE features and cache them all
+		const std::string cachingStrHate = "type_HATE";
+		static const auto selectorHate = Selector::type()(BonusType::HATE);
 
-double DamageCalculator::getAttackHateFactor() const
-{
-	//assume that unit have only few HATE features and cache them all
-	const std::string cachingStrHate = "type_HATE";
-	static const auto selectorHate = Selector::type()(BonusType::HATE);
+		result.hateEffects = attacker->getBonuses(selectorHate, cachingStrHate);
+	}
 
-	auto allHateEffects = info.attacker->getBonuses(selectorHate, cachingStrHate);
+	// revenge
+	result.revengeFactor = 0.0;
+	if(attacker->hasBonusOfType(BonusType::REVENGE)) //HotA Haspid ability
+	{
+		int totalStackCount = attacker->unitBaseAmount();
+		int currentStackHealth = attacker->getAvailableHealth();
+		int creatureHealth = attacker->getMaxHealth();
 
-	return allHateEffects->valOfBonuses(Selector::subtype()(BonusSubtypeID(info.defender->creatureId()))) / 100.0;
-}
+		result.revengeFactor = sqrt(static_cast<double>((totalStackCount + 1) * creatureHealth) / (currentStackHealth + creatureHealth) - 1);
+	}
 
-double DamageCalculator::getAttackRevengeFactor() const
-{
-	if(info.attacker->hasBonusOfType(BonusType::REVENGE)) //HotA Haspid ability
+	// melee penalty of shooters
 	{
-		int totalStackCount = info.attacker->unitBaseAmount();
-		int currentStackHealth = info.attacker->getAvailableHealth();
-		int creatureHealth = info.attacker->getMaxHealth();
+		const std::string cachingStrNoMeleePenalty = "type_NO_MELEE_PENALTY";
+		static const auto selectorNoMeleePenalty = Selector::type()(BonusType::NO_MELEE_PENALTY);
 
-		return sqrt(static_cast<double>((totalStackCount + 1) * creatureHealth) / (currentStackHealth + creatureHealth) - 1);
+		result.meleePenalty = !shooting && attacker->isShooter() && !attacker->hasBonus(selectorNoMeleePenalty, cachingStrNoMeleePenalty);
 	}
 
-	return 0.0;
-}
-
-double DamageCalculator::getDefenseSkillFactor() const
-{
-	int defenseAdvantage = getTargetDefenseEffective() - getActorAttackEffective();
+	// blind & paralysis
+	result.blindParalysisFactor = battleBonusValue(attacker, Selector::type()(BonusType::GENERAL_ATTACK_REDUCTION), shooting) / 100.0;
 
-	//bonus from attack/defense skills
-	if(defenseAdvantage > 0) //decreasing dmg
+	// forgetfulness
+	result.forgetfulnessFactor = 0.0;
+	if(shooting)
 	{
-		const double defenseMultiplier = VLC->settings()->getDouble(EGameSettings::COMBAT_DEFENSE_POINT_DAMAGE_FACTOR);
-		const double defenseMultiplierCap = VLC->settings()->getDouble(EGameSettings::COMBAT_DEFENSE_POINT_DAMAGE_FACTOR_CAP);
+		//todo: set actual percentage in spell bonus configuration instead of just level; requires non trivial backward compatibility handling
+		//get list first, total value of 0 also counts
+		TConstBonusListPtr forgetfulList = attacker->getBonuses(Selector::type()(BonusType::FORGETFULL),"type_FORGETFULL");
 
-		const double dec = std::min(defenseMultiplier * defenseAdvantage, defenseMultiplierCap);
-		return dec;
+		if(!forgetfulList->empty())
+		{
+			int forgetful = forgetfulList->valOfBonuses(Selector::all);
+
+			//none of basic level
+			if(forgetful == 0 || forgetful == 1)
+				result.forgetfulnessFactor = 0.5;
+			else
+				logGlobal->warn("Attempt to calculate shooting damage with adv+ FORGETFULL effect");
+		}
 	}
-	return 0.0;
-}
 
-double DamageCalculator::getDefenseArmorerFactor() const
-{
-	const std::string cachingStrArmorer = "type_GENERAL_DAMAGE_REDUCTIONs_N1_NsrcSPELL_EFFECT";
-	static const auto selectorArmorer = Selector::typeSubtype(BonusType::GENERAL_DAMAGE_REDUCTION, BonusCustomSubtype::damageTypeAll).And(Selector::sourceTypeSel(BonusSource::SPELL_EFFECT).Not());
-	return info.defender->valOfBonuses(selectorArmorer, cachingStrArmorer) / 100.0;
+	result.magicElemental = attacker->creatureIndex() == CreatureID::MAGIC_ELEMENTAL;
+	result.psychicElemental = attacker->creatureIndex() == CreatureID::PSYCHIC_ELEMENTAL;
 
+	return result;
 }
 
-double DamageCalculator::getDefenseMagicShieldFactor() const
+DamageCalculator::DefenderFactors DamageCalculator::getDefenderFactors(const battle::Unit * defender, bool shooting)
 {
-	const std::string cachingStrMeleeReduction = "type_GENERAL_DAMAGE_REDUCTIONs_0";
-	static const auto selectorMeleeReduction = Selector::typeSubtype(BonusType::GENERAL_DAMAGE_REDUCTION, BonusCustomSubtype::damageTypeMelee);
+	DefenderFactors result;
+
+	result.creature = defender->creatureId();
+	result.defense = defender->getDefense(shooting);
+	result.enemyAttackReductionPercent = battleBonusValue(defender, Selector::type()(BonusType::ENEMY_ATTACK_REDUCTION), shooting);
+	result.kingLevel = defender->hasBonusOfType(BonusType::KING) ? defender->unitType()->valOfBonuses(Selector::type()(BonusType::KING)) : -1;
+
+	{
+		const std::string cachingStrChargeImmunity = "type_CHARGE_IMMUNITY";
+		static const auto selectorChargeImmunity = Selector::type()(BonusType::CHARGE_IMMUNITY);
 
-	const std::string cachingStrRangedReduction = "type_GENERAL_DAMAGE_REDUCTIONs_1";
-	static const auto selectorRangedReduction = Selector::typeSubtype(BonusType::GENERAL_DAMAGE_REDUCTION, BonusCustomSubtype::damageTypeRanged);
+		result.chargeImmunity = defender->hasBonus(selectorChargeImmunity, cachingStrChargeImmunity);
+	}
+
+	// armorer
+	{
+		const std::string cachingStrArmorer = "type_GENERAL_DAMAGE_REDUCTIONs_N1_NsrcSPELL_EFFECT";
+		static const auto selectorArmorer = Selector::typeSubtype(BonusType::GENERAL_DAMAGE_REDUCTION, BonusCustomSubtype::damageTypeAll).And(Selector::sourceTypeSel(BonusSource::SPELL_EFFECT).Not());
+		result.armorerFactor = defender->valOfBonuses(selectorArmorer, cachingStrArmorer) / 100.0;
+	}
 
 	//handling spell effects - shield and air shield
-	if(info.shooting)
-		return info.defender->valOfBonuses(selectorRangedReduction, cachingStrRangedReduction) / 100.0;
+	if(shooting)
+	{
+		const std::string cachingStrRangedReduction = "type_GENERAL_DAMAGE_REDUCTIONs_1";
+		static const auto selectorRangedReduction = Selector::typeSubtype(BonusType::GENERAL_DAMAGE_REDUCTION, BonusCustomSubtype::damageTypeRanged);
+		result.magicShieldFactor = defender->valOfBonuses(selectorRangedReduction, cachingStrRangedReduction) / 100.0;
+	}
 	else
-		return info.defender->valOfBonuses(selectorMeleeReduction, cachingStrMeleeReduction) / 100.0;
-}
-
-double DamageCalculator::getDefenseRangePenaltiesFactor() const
-{
-	if(info.shooting)
 	{
-		BattleHex attackerPos = info.attackerPos.isValid() ? info.attackerPos : info.attacker->getPosition();
-		BattleHex defenderPos = info.defenderPos.isValid() ? info.defenderPos : info.defender->getPosition();
+		const std::string cachingStrMeleeReduction = "type_GENERAL_DAMAGE_REDUCTIONs_0";
+		static const auto selectorMeleeReduction = Selector::typeSubtype(BonusType::GENERAL_DAMAGE_REDUCTION, BonusCustomSubtype::damageTypeMelee);
+		result.magicShieldFactor = defender->valOfBonuses(selectorMeleeReduction, cachingStrMeleeReduction) / 100.0;
+	}
 
+	result.advancedAirShield = false;
+	if(shooting)
+	{
 		const std::string cachingStrAdvAirShield = "isAdvancedAirShield";
 		auto isAdvancedAirShield = [](const Bonus* bonus)
 		{
@@ -347,164 +332,158 @@ double DamageCalculator::getDefenseRangePenaltiesFactor() const
 					&& bonus->val >= MasteryLevel::ADVANCED;
 		};
 
-		const bool distPenalty = callback.battleHasDistancePenalty(info.attacker, attackerPos, defenderPos);
-
-		if(distPenalty || info.defender->hasBonus(isAdvancedAirShield, cachingStrAdvAirShield))
-			return 0.5;
-
+		result.advancedAirShield = defender->hasBonus(isAdvancedAirShield, cachingStrAdvAirShield);
 	}
-	else
-	{
-		const std::string cachingStrNoMeleePenalty = "type_NO_MELEE_PENALTY";
-		static const auto selectorNoMeleePenalty = Selector::type()(BonusType::NO_MELEE_PENALTY);
 
-		if(info.attacker->isShooter() && !info.attacker->hasBonus(selectorNoMeleePenalty, cachingStrNoMeleePenalty))
-			return 0.5;
+	// Creatures that are petrified by a Basilisk's Petrifying attack or a Medusa's Stone gaze take 50% damage (R8 = 0.50) from ranged and melee attacks. Taking damage also deactivates the effect.
+	{
+		const std::string cachingStrAllReduction = "type_GENERAL_DAMAGE_REDUCTIONs_N1_srcSPELL_EFFECT";
+		static const auto selectorAllReduction = Selector::typeSubtype(BonusType::GENERAL_DAMAGE_REDUCTION, BonusCustomSubtype::damageTypeAll).And(Selector::sourceTypeSel(BonusSource::SPELL_EFFECT));
+		result.petrificationFactor = defender->valOfBonuses(selectorAllReduction, cachingStrAllReduction) / 100.0;
 	}
-	return 0.0;
-}
 
-double DamageCalculator::getDefenseObstacleFactor() const
-{
-	if(info.shooting)
 	{
-		BattleHex attackerPos = info.attackerPos.isValid() ? info.attackerPos : info.attacker->getPosition();
-		BattleHex defenderPos = info.defenderPos.isValid() ? info.defenderPos : info.defender->getPosition();
+		const std::string cachingStrMagicImmunity = "type_LEVEL_SPELL_IMMUNITY";
+		static const auto selectorMagicImmunity = Selector::type()(BonusType::LEVEL_SPELL_IMMUNITY);
+		result.magicImmunity = defender->valOfBonuses(selectorMagicImmunity, cachingStrMagicImmunity) >= 5;
+	}
 
-		const bool obstaclePenalty = callback.battleHasWallPenalty(info.attacker, attackerPos, defenderPos);
-		if(obstaclePenalty)
-			return 0.5;
+	{
+		const std::string cachingStrMindImmunity = "type_MIND_IMMUNITY";
+		static const auto selectorMindImmunity = Selector::type()(BonusType::MIND_IMMUNITY);
+		result.mindImmunity = defender->hasBonus(selectorMindImmunity, cachingStrMindImmunity);
 	}
-	return 0.0;
-}
 
-double DamageCalculator::getDefenseUnluckyFactor() const
-{
-	if(info.unluckyStrike)
-		return 0.5;
-	return 0.0;
-}
+	result.firstHPleft = defender->getFirstHPleft();
+	result.maxHealth = defender->getMaxHealth();
 
-double DamageCalculator::getDefenseBlindParalysisFactor() const
-{
-	double multAttackReduction = battleBonusValue(info.attacker, Selector::type()(BonusType::GENERAL_ATTACK_REDUCTION)) / 100.0;
-	return multAttackReduction;
+	return result;
 }
 
-double DamageCalculator::getDefenseForgetfulnessFactor() const
+int DamageCalculator::getActorAttackEffective(const AttackerFactors & attacker, const DefenderFactors & defender)
 {
-	if(info.shooting)
-	{
-		//todo: set actual percentage in spell bonus configuration instead of just level; requires non trivial backward compatibility handling
-		//get list first, total value of 0 also counts
-		TConstBonusListPtr forgetfulList = info.attacker->getBonuses(Selector::type()(BonusType::FORGETFULL),"type_FORGETFULL");
+	int attackBase = attacker.attack;
+	int attackSlayer = 0;
+	int attackIgnored = 0;
 
-		if(!forgetfulList->empty())
-		{
-			int forgetful = forgetfulList->valOfBonuses(Selector::all);
+	if(defender.kingLevel >= 0 && attacker.slayerLevel >= defender.kingLevel)
+		attackSlayer = attacker.slayerAttackBonus;
 
-			//none of basic level
-			if(forgetful == 0 || forgetful == 1)
-				return 0.5;
-			else
-				logGlobal->warn("Attempt to calculate shooting damage with adv+ FORGETFULL effect");
-		}
+	if(defender.enemyAttackReductionPercent > 0)
+	{
+		int reduction = (attackBase * defender.enemyAttackReductionPercent + 49) / 100; //using ints so 1.5 for 5 attack is rounded down as in HotA / h3assist etc. (keep in mind h3assist 1.2 shows wrong value for 15 attack points and unupg. nix)
+		attackIgnored = -std::min(reduction, attackBase);
 	}
-	return 0.0;
+
+	return attackBase + attackSlayer + attackIgnored;
 }
 
-double DamageCalculator::getDefensePetrificationFactor() const
+int DamageCalculator::getTargetDefenseEffective(const AttackerFactors & attacker, const DefenderFactors & defender)
 {
-	// Creatures that are petrified by a Basilisk's Petrifying attack or a Medusa's Stone gaze take 50% damage (R8 = 0.50) from ranged and melee attacks. Taking damage also deactivates the effect.
-	const std::string cachingStrAllReduction = "type_GENERAL_DAMAGE_REDUCTIONs_N1_srcSPELL_EFFECT";
-	static const auto selectorAllReduction = Selector::typeSubtype(BonusType::GENERAL_DAMAGE_REDUCTION, BonusCustomSubtype::damageTypeAll).And(Selector::sourceTypeSel(BonusSource::SPELL_EFFECT));
+	int defenseBase = defender.defense;
+	int defenseIgnored = 0;
+	double multDefenceReduction = attacker.enemyDefenceReductionPercent / 100.0;
+
+	if(multDefenceReduction > 0)
+	{
+		int reduction = std::floor(multDefenceReduction * defenseBase) + 1;
+		defenseIgnored = -std::min(reduction, defenseBase);
+	}
 
-	return info.defender->valOfBonuses(selectorAllReduction, cachingStrAllReduction) / 100.0;
+	return defenseBase + defenseIgnored;
 }
 
-double DamageCalculator::getDefenseMagicFactor() const
+void DamageCalculator::getAttackFactors(const CBattleInfoCallback & callback, const BattleAttackInfo & info, const AttackerFactors & attacker, const DefenderFactors & defender, AttackFactors & result)
 {
-	// Magic Elementals deal half damage (R8 = 0.50) against Magic Elementals and Black Dragons. This is not affected by the Orb of Vulnerability, Anti-Magic, or Magic Resistance.
-	if(info.attacker->creatureIndex() == CreatureID::MAGIC_ELEMENTAL)
+	int attackAdvantage = getActorAttackEffective(attacker, defender) - getTargetDefenseEffective(attacker, defender);
+
+	double attackSkillFactor = 0.0;
+	double defenseSkillFactor = 0.0;
+
+	if(attackAdvantage > 0)
 	{
-		const std::string cachingStrMagicImmunity = "type_LEVEL_SPELL_IMMUNITY";
-		static const auto selectorMagicImmunity = Selector::type()(BonusType::LEVEL_SPELL_IMMUNITY);
+		const double attackMultiplier = VLC->settings()->getDouble(EGameSettings::COMBAT_ATTACK_POINT_DAMAGE_FACTOR);
+		const double attackMultiplierCap = VLC->settings()->getDouble(EGameSettings::COMBAT_ATTACK_POINT_DAMAGE_FACTOR_CAP);
 
-		if(info.defender->valOfBonuses(selectorMagicImmunity, cachingStrMagicImmunity) >= 5)
-			return 0.5;
+		attackSkillFactor = std::min(attackMultiplier * attackAdvantage, attackMultiplierCap);
 	}
-	return 0.0;
-}
 
-double DamageCalculator::getDefenseMindFactor() const
-{
-	// Psychic Elementals deal half damage (R8 = 0.50) against creatures that are immune to Mind spells, such as Giants and Undead. This is not affected by the Orb of Vulnerability.
-	if(info.attacker->creatureIndex() == CreatureID::PSYCHIC_ELEMENTAL)
+	//bonus from attack/defense skills
+	if(attackAdvantage < 0) //decreasing dmg
 	{
-		const std::string cachingStrMindImmunity = "type_MIND_IMMUNITY";
-		static const auto selectorMindImmunity = Selector::type()(BonusType::MIND_IMMUNITY);
+		const double defenseMultiplier = VLC->settings()->getDouble(EGameSettings::COMBAT_DEFENSE_POINT_DAMAGE_FACTOR);
+		const double defenseMultiplierCap = VLC->settings()->getDouble(EGameSettings::COMBAT_DEFENSE_POINT_DAMAGE_FACTOR_CAP);
 
-		if(info.defender->hasBonus(selectorMindImmunity, cachingStrMindImmunity))
-			return 0.5;
+		defenseSkillFactor = std::min(defenseMultiplier * -attackAdvantage, defenseMultiplierCap);
 	}
-	return 0.0;
-}
 
-std::vector<double> DamageCalculator::getAttackFactors() const
-{
-	return {
-		getAttackSkillFactor(),
-		getAttackOffenseArcheryFactor(),
-		getAttackBlessFactor(),
-		getAttackLuckFactor(),
-		getAttackJoustingFactor(),
-		getAttackDeathBlowFactor(),
-		getAttackDoubleDamageFactor(),
-		getAttackHateFactor(),
-		getAttackRevengeFactor()
-	};
-}
+	double joustingFactor = 0.0;
+	if(info.chargeDistance > 0 && attacker.joustingPercent && !defender.chargeImmunity)
+		joustingFactor = info.chargeDistance * attacker.joustingPercent / 100.0;
 
-std::vector<double> DamageCalculator::getDefenseFactors() const
-{
-	return {
-		getDefenseSkillFactor(),
-		getDefenseArmorerFactor(),
-		getDefenseMagicShieldFactor(),
-		getDefenseRangePenaltiesFactor(),
-		getDefenseObstacleFactor(),
-		getDefenseBlindParalysisFactor(),
-		getDefenseUnluckyFactor(),
-		getDefenseForgetfulnessFactor(),
-		getDefensePetrificationFactor(),
-		getDefenseMagicFactor(),
-		getDefenseMindFactor()
+	double rangePenaltiesFactor = 0.0;
+	double obstacleFactor = 0.0;
+
+	if(info.shooting)
+	{
+		BattleHex attackerPos = info.attackerPos.isValid() ? info.attackerPos : info.attacker->getPosition();
+		BattleHex defenderPos = info.defenderPos.isValid() ? info.defenderPos : info.defender->getPosition();
+
+		if(defender.advancedAirShield || callback.battleHasDistancePenalty(info.attacker, attackerPos, defenderPos))
+			rangePenaltiesFactor = 0.5;
+
+		if(callback.battleHasWallPenalty(info.attacker, attackerPos, defenderPos))
+			obstacleFactor = 0.5;
+	}
+	else if(attacker.meleePenalty)
+	{
+		rangePenaltiesFactor = 0.5;
+	}
+
+	result.attack = {
+		attackSkillFactor,
+		attacker.offenseArcheryFactor,
+		attacker.blessFactor,
+		info.luckyStrike ? 1.0 : 0.0,
+		joustingFactor,
+		info.deathBlow ? 1.0 : 0.0,
+		info.doubleDamage ? attacker.doubleDamageFactor : 0.0,
+		attacker.hateEffects->valOfBonuses(Selector::subtype()(BonusSubtypeID(defender.creature))) / 100.0,
+		attacker.revengeFactor
 	};
-}
 
-DamageRange DamageCalculator::getCasualties(const DamageRange & damageDealt) const
-{
-	return {
-		getCasualties(damageDealt.min),
-		getCasualties(damageDealt.max),
+	result.defense = {
+		defenseSkillFactor,
+		defender.armorerFactor,
+		defender.magicShieldFactor,
+		rangePenaltiesFactor,
+		obstacleFactor,
+		attacker.blindParalysisFactor,
+		info.unluckyStrike ? 0.5 : 0.0,
+		attacker.forgetfulnessFactor,
+		defender.petrificationFactor,
+		// Magic Elementals deal half damage (R8 = 0.50) against Magic Elementals and Black Dragons. This is not affected by the Orb of Vulnerability, Anti-Magic, or Magic Resistance.
+		attacker.magicElemental && defender.magicImmunity ? 0.5 : 0.0,
+		// Psychic Elementals deal half damage (R8 = 0.50) against creatures that are immune to Mind spells, such as Giants and Undead. This is not affected by the Orb of Vulnerability.
+		attacker.psychicElemental && defender.mindImmunity ? 0.5 : 0.0
 	};
 }
 
-int64_t DamageCalculator::getCasualties(int64_t damageDealt) const
+int64_t DamageCalculator::getCasualties(const DefenderFactors & defender, int64_t damageDealt)
 {
-	if (damageDealt < info.defender->getFirstHPleft())
+	if (damageDealt < defender.firstHPleft)
 		return 0;
 
-	int64_t damageLeft = damageDealt - info.defender->getFirstHPleft();
-	int64_t killsLeft = damageLeft / info.defender->getMaxHealth();
+	int64_t damageLeft = damageDealt - defender.firstHPleft;
+	int64_t killsLeft = damageLeft / defender.maxHealth;
 
 	return 1 + killsLeft;
 }
 
-int DamageCalculator::battleBonusValue(const IBonusBearer * bearer, const CSelector & selector) const
+int DamageCalculator::battleBonusValue(const IBonusBearer * bearer, const CSelector & selector, bool shooting)
 {
 	auto noLimit = Selector::effectRange()(BonusLimitEffect::NO_LIMIT);
-	auto limitMatches = info.shooting
+	auto limitMatches = shooting
 						? Selector::effectRange()(BonusLimitEffect::ONLY_DISTANCE_FIGHT)
 						: Selector::effectRange()(BonusLimitEffect::ONLY_MELEE_FIGHT);
 
@@ -512,38 +491,118 @@ int DamageCalculator::battleBonusValue(const IBonusBearer * bearer, const CSelec
 	return bearer->getBonuses(selector, noLimit.Or(limitMatches))->totalValue();
 };
 
-DamageEstimation DamageCalculator::calculateDmgRange() const
+double DamageCalculator::getResultingFactor(const AttackFactors & factors)
 {
-	DamageRange damageBase = getBaseDamageStack();
+	double attackTotal = 1.0;
+	double defenseTotal = 1.0;
 
-	auto attackFactors = getAttackFactors();
-	auto defenseFactors = getDefenseFactors();
-
-	double attackFactorTotal = 1.0;
-	double defenseFactorTotal = 1.0;
-
-	for (auto & factor : attackFactors)
+	for(double factor : factors.attack)
 	{
 		assert(factor >= 0.0);
-		attackFactorTotal += factor;
+		attackTotal += factor;
 	}
 
-	for (auto & factor : defenseFactors)
+	for(double factor : factors.defense)
 	{
 		assert(factor >= 0.0);
-		defenseFactorTotal *= (1 - std::min(1.0, factor));
+		defenseTotal *= (1 - std::min(1.0, factor));
 	}
 
-	double resultingFactor = attackFactorTotal * defenseFactorTotal;
+	return attackTotal * defenseTotal;
+}
+
+DamageEstimation DamageCalculator::calculateDmgRange() const
+{
+	AttackerFactors attacker = getAttackerFactors(callback, info.attacker, info.shooting);
+	DefenderFactors defender = getDefenderFactors(info.defender, info.shooting);
+
+	AttackFactors factors;
+	getAttackFactors(callback, info, attacker, defender, factors);
+
+	double resultingFactor = getResultingFactor(factors);
+
+	DamageRange damage = {
+		static_cast<int64_t>(std::max(1.0, std::floor(attacker.baseDamage.min * resultingFactor))),
+		static_cast<int64_t>(std::max(1.0, std::floor(attacker.baseDamage.max * resultingFactor)))
+	};
 
-	DamageRange damageDealt {
-		std::max<int64_t>( 1.0, std::floor(damageBase.min * resultingFactor)),
-		std::max<int64_t>( 1.0, std::floor(damageBase.max * resultingFactor))
+	DamageRange killed = {
+		getCasualties(defender, damage.min),
+		getCasualties(defender, damage.max),
 	};
 
-	DamageRange killsDealt = getCasualties(damageDealt);
+	return DamageEstimation{damage, killed};
+}
+
+std::vector<DamageEstimation> DamageCalculator::calculateDmgRanges(const CBattleInfoCallback & callback, const std::vector<BattleAttackInfo> & attacks)
+{
+	const size_t attacksCount = attacks.size();
+
+	// factors of each unit are extracted once per attack mode, attacks refer to them by index
+	std::map<std::pair<const battle::Unit *, bool>, size_t> attackerIndices;
+	std::map<std::pair<const battle::Unit *, bool>, size_t> defenderIndices;
+	std::vector<AttackerFactors> attackers;
+	std::vector<DefenderFactors> defenders;
+	std::vector<size_t> defenderOfAttack(attacksCount);
+
+	// structure of arrays, so loops below operate on contiguous data and can be vectorized by compiler
+	std::vector<double> damageMin(attacksCount);
+	std::vector<double> damageMax(attacksCount);
+	std::vector<double> resultingFactor(attacksCount);
+
+	AttackFactors factors;
+
+	for(size_t i = 0; i < attacksCount; i++)
+	{
+		const BattleAttackInfo & info = attacks[i];
+
+		auto attackerKey = std::make_pair(info.attacker, info.shooting);
+		auto defenderKey = std::make_pair(info.defender, info.shooting);
+
+		auto attackerIndex = attackerIndices.find(attackerKey);
+		if(attackerIndex == attackerIndices.end())
+		{
+			attackerIndex = attackerIndices.emplace(attackerKey, attackers.size()).first;
+			attackers.push_back(getAttackerFactors(callback, info.attacker, info.shooting));
+		}
+
+		auto defenderIndex = defenderIndices.find(defenderKey);
+		if(defenderIndex == defenderIndices.end())
+		{
+			defenderIndex = defenderIndices.emplace(defenderKey, defenders.size()).first;
+			defenders.push_back(getDefenderFactors(info.defender, info.shooting));
+		}
+
+		const AttackerFactors & attacker = attackers[attackerIndex->second];
+		const DefenderFactors & defender = defenders[defenderIndex->second];
+
+		defenderOfAttack[i] = defenderIndex->second;
+		damageMin[i] = attacker.baseDamage.min;
+		damageMax[i] = attacker.baseDamage.max;
+
+		getAttackFactors(callback, info, attacker, defender, factors);
+		resultingFactor[i] = getResultingFactor(factors);
+	}
+
+	for(size_t i = 0; i < attacksCount; i++)
+	{
+		damageMin[i] = std::max(1.0, std::floor(damageMin[i] * resultingFactor[i]));
+		damageMax[i] = std::max(1.0, std::floor(damageMax[i] * resultingFactor[i]));
+	}
+
+	std::vector<DamageEstimation> result(attacksCount);
+
+	for(size_t i = 0; i < attacksCount; i++)
+	{
+		const DefenderFactors & defender = defenders[defenderOfAttack[i]];
+
+		result[i].damage.min = static_cast<int64_t>(damageMin[i]);
+		result[i].damage.max = static_cast<int64_t>(damageMax[i]);
+		result[i].kills.min = getCasualties(defender, result[i].damage.min);
+		result[i].kills.max = getCasualties(defender, result[i].damage.max);
+	}
 
-	return DamageEstimation{damageDealt, killsDealt};
+	return result;
 }
 
 VCMI_LIB_NAMESPACE_END
@@ -16,6 +16,10 @@ VCMI_LIB_NAMESPACE_BEGIN
 
 class CBattleInfoCallback;
 class IBonusBearer;
+namespace battle
+{
+	class Unit;
+}
 class CSelector;
 struct BattleAttackInfo;
 struct DamageRange;
@@ -23,50 +27,41 @@ struct DamageEstimation;
 
 class DLL_LINKAGE DamageCalculator
 {
+	static constexpr size_t ATTACK_FACTORS_COUNT = 9;
+	static constexpr size_t DEFENSE_FACTORS_COUNT = 11;
+
+	/// Bonus-derived values of unit that damage calculation needs when unit attacks or defends
+	/// Extracted once per unit and attack mode (melee or ranged) and reused for all attacks of this unit
+	struct AttackerFactors;
+	struct DefenderFactors;
+
+	/// Factors of single attack, sum of attack factors and product of defense factors give final damage multiplier
+	struct AttackFactors
+	{
+		std::array<double, ATTACK_FACTORS_COUNT> attack;
+		std::array<double, DEFENSE_FACTORS_COUNT> defense;
+	};
+
 	const CBattleInfoCallback & callback;
 	const BattleAttackInfo & info;
 
-	int battleBonusValue(const IBonusBearer * bearer, const CSelector & selector) const;
-
-	DamageRange getCasualties(const DamageRange & damageDealt) const;
-	int64_t getCasualties(int64_t damageDealt) const;
-
-	DamageRange getBaseDamageSingle() const;
-	DamageRange getBaseDamageBlessCurse() const;
-	DamageRange getBaseDamageStack() const;
-
-	int getActorAttackBase() const;
-	int getActorAttackEffective() const;
-	int getActorAttackSlayer() const;
-	int getActorAttackIgnored() const;
-	int getTargetDefenseBase() const;
-	int getTargetDefenseEffective() const;
-	int getTargetDefenseIgnored() const;
-
-	double getAttackSkillFactor() const;
-	double getAttackOffenseArcheryFactor() const;
-	double getAttackBlessFactor() const;
-	double getAttackLuckFactor() const;
-	double getAttackJoustingFactor() const;
-	double getAttackDeathBlowFactor() const;
-	double getAttackDoubleDamageFactor() const;
-	double getAttackHateFactor() const;
-	double getAttackRevengeFactor() const;
-
-	double getDefenseSkillFactor() const;
-	double getDefenseArmorerFactor() const;
-	double getDefenseMagicShieldFactor() const;
-	double getDefenseRangePenaltiesFactor() const;
-	double getDefenseObstacleFactor() const;
-	double getDefenseBlindParalysisFactor() const;
-	double getDefenseUnluckyFactor() const;
-	double getDefenseForgetfulnessFactor() const;
-	double getDefensePetrificationFactor() const;
-	double getDefenseMagicFactor() const;
-	double getDefenseMindFactor() const;
-
-	std::vector<double> getAttackFactors() const;
-	std::vector<double> getDefenseFactors() const;
+	static int battleBonusValue(const IBonusBearer * bearer, const CSelector & selector, bool shooting);
+
+	static DamageRange getBaseDamageSingle(const CBattleInfoCallback & callback, const battle::Unit * attacker, bool shooting);
+	static DamageRange getBaseDamageBlessCurse(const CBattleInfoCallback & callback, const battle::Unit * attacker, bool shooting);
+	static DamageRange getBaseDamageStack(const CBattleInfoCallback & callback, const battle::Unit * attacker, bool shooting);
+
+	static AttackerFactors getAttackerFactors(const CBattleInfoCallback & callback, const battle::Unit * attacker, bool shooting);
+	static DefenderFactors getDefenderFactors(const battle::Unit * defender, bool shooting);
+
+	static int getActorAttackEffective(const AttackerFactors & attacker, const DefenderFactors & defender);
+	static int getTargetDefenseEffective(const AttackerFactors & attacker, const DefenderFactors & defender);
+
+	static void getAttackFactors(const CBattleInfoCallback & callback, const BattleAttackInfo & info, const AttackerFactors & attacker, const DefenderFactors & defender, AttackFactors & result);
+
+	static double getResultingFactor(const AttackFactors & factors);
+	static int64_t getCasualties(const DefenderFactors & defender, int64_t damageDealt);
+
 public:
 	DamageCalculator(const CBattleInfoCallback & callback, const BattleAttackInfo & info ):
 		callback(callback),
@@ -74,6 +69,11 @@ public:
 	{}
 
 	DamageEstimation calculateDmgRange() const;
+
+	/// Calculates damage of all attacks at once, bonuses of each unit are evaluated only once per attack mode
+	/// instead of once per attack. Result is identical to calling calculateDmgRange for each attack
+	/// Meant for AI that evaluates many attacks, single attacks should use calculateDmgRange
+	static std::vector<DamageEstimation> calculateDmgRanges(const CBattleInfoCallback & callback, const std::vector<BattleAttackInfo> & attacks);
 };
 
 VCMI_LIB_NAMESPACE_END
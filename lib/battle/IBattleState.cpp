@@ -10,4 +10,29 @@
 #include "StdInc.h"
 
 #include "IBattleState.h"
+#include "Unit.h"
+#include "../CStack.h"
 
+VCMI_LIB_NAMESPACE_BEGIN
+
+const battle::Unit * IBattleInfo::getUnitAtPos(BattleHex pos) const
+{
+	auto units = getUnitsIf([=](const battle::Unit * unit)
+	{
+		return !unit->isGhost() && unit->alive() && unit->coversPos(pos);
+	});
+
+	return units.empty() ? nullptr : units.front();
+}
+
+const CStack * IBattleInfo::getStackAtPos(BattleHex pos) const
+{
+	auto stacks = getStacksIf([=](const CStack * stack)
+	{
+		return !stack->isGhost() && stack->alive() && stack->coversPos(pos);
+	});
+
+	return stacks.empty() ? nullptr : stacks.front();
+}
+
+VCMI_LIB_NAMESPACE_END
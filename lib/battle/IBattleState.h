@@ -46,6 +46,12 @@ public:
 
 	virtual battle::Units getUnitsIf(const battle::UnitFilter & predicate) const = 0;
 
+	/// Returns alive unit that occupies specified hex, or nullptr if hex is free
+	/// Default implementation scans all units, battle states may override it with faster lookup
+	virtual const battle::Unit * getUnitAtPos(BattleHex pos) const;
+	/// Returns alive stack that occupies specified hex, or nullptr if hex is free
+	virtual const CStack * getStackAtPos(BattleHex pos) const;
+
 	virtual BattleField getBattlefieldType() const = 0;
 	virtual TerrainId getTerrainType() const = 0;
 
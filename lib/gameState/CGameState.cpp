@@ -690,23 +690,16 @@ void CGameState::initFogOfWar()
 {
 	logGlobal->debug("\tFog of war"); //FIXME: should be initialized after all bonuses are set
 
-	int layers = map->levels();
 	for(auto & elem : teams)
 	{
 		auto & fow = elem.second.fogOfWarMap;
-		fow->resize(boost::extents[layers][map->width][map->height]);
-		std::fill(fow->data(), fow->data() + fow->num_elements(), 0);
+		fow->resize(getMapSize());
 
 		for(CGObjectInstance *obj : map->objects)
 		{
 			if(!obj || !vstd::contains(elem.second.players, obj->tempOwner)) continue; //not a flagged object
 
-			std::unordered_set<int3> tiles;
-			getTilesInRange(tiles, obj->getSightCenter(), obj->getSightRadius(), ETileVisibility::HIDDEN, obj->tempOwner);
-			for(const int3 & tile : tiles)
-			{
-				(*elem.second.fogOfWarMap)[tile.z][tile.x][tile.y] = 1;
-			}
+			getTilesInRange(*fow, obj->getSightCenter(), obj->getSightRadius(), ETileVisibility::REVEALED);
 		}
 	}
 }
@@ -935,8 +928,6 @@ void CGameState::initMapObjects()
 		}
 	}
 	CGSubterraneanGate::postInit(callback); //pairing subterranean gates
-
-	map->calculateGuardingGreaturePositions(); //calculate once again when all the guards are placed and initialized
 }
 
 void CGameState::placeHeroesInTowns()
@@ -1154,7 +1145,6 @@ void CGameState::calculatePaths(const std::shared_ptr<PathfinderConfig> & config
 std::vector<CGObjectInstance*> CGameState::guardingCreatures (int3 pos) const
 {
 	std::vector<CGObjectInstance*> guards;
-	const int3 originalPos = pos;
 	if (!map->isInTheMap(pos))
 		return guards;
 
@@ -1170,38 +1160,30 @@ std::vector<CGObjectInstance*> CGameState::guardingCreatures (int3 pos) const
 			}
 		}
 	}
-	pos -= int3(1, 1, 0); // Start with top left.
-	for (int dx = 0; dx < 3; dx++)
+
+	// See if there are any monsters adjacent, including tile itself
+	std::vector<std::pair<int3, CGObjectInstance *>> adjacentGuards;
+	map->getObjectIndex().forEachInRect(pos - int3(1, 1, 0), pos + int3(1, 1, 0), MapObjectIndex::ELayer::GUARDS, [&](CGObjectInstance * obj, const int3 & tile)
 	{
-		for (int dy = 0; dy < 3; dy++)
-		{
-			if (map->isInTheMap(pos))
-			{
-				const auto & tile = map->getTile(pos);
-				if (tile.visitable && (tile.isWater() == posTile.isWater()))
-				{
-					for (CGObjectInstance* obj : tile.visitableObjects)
-					{
-						if (obj->ID == Obj::MONSTER  &&  map->checkForVisitableDir(pos, &map->getTile(originalPos), originalPos)) // Monster being able to attack investigated tile
-						{
-							guards.push_back(obj);
-						}
-					}
-				}
-			}
+		if (map->getTile(tile).isWater() == posTile.isWater() && map->checkForVisitableDir(tile, &posTile, pos)) // Monster being able to attack investigated tile
+			adjacentGuards.emplace_back(tile, obj);
+	});
 
-			pos.y++;
-		}
-		pos.y -= 3;
-		pos.x++;
-	}
-	return guards;
+	// keep column-major order from top left, in which guards were found by scanning tiles
+	std::stable_sort(adjacentGuards.begin(), adjacentGuards.end(), [](const auto & left, const auto & right)
+	{
+		return left.first.x < right.first.x || (left.first.x == right.first.x && left.first.y < right.first.y);
+	});
+
+	for (const auto & guard : adjacentGuards)
+		guards.push_back(guard.second);
 
+	return guards;
 }
 
 int3 CGameState::guardingCreaturePosition (int3 pos) const
 {
-	return gs->map->guardingCreaturePositions[pos.z][pos.x][pos.y];
+	return map->guardingCreaturePosition(pos);
 }
 
 void CGameState::updateRumor()
@@ -1287,7 +1269,7 @@ bool CGameState::isVisible(int3 pos, const std::optional<PlayerColor> & player)
 	if(player->isSpectator())
 		return true;
 
-	return (*getPlayerTeam(*player)->fogOfWarMap)[pos.z][pos.x][pos.y];
+	return getPlayerTeam(*player)->fogOfWarMap->test(pos);
 }
 
 bool CGameState::isVisible(const CGObjectInstance * obj, const std::optional<PlayerColor> & player) const
@@ -1918,7 +1900,19 @@ bool RumorState::update(int id, int extra)
 TeamState::TeamState()
 {
 	setNodeType(TEAM);
-	fogOfWarMap = std::make_unique<boost::multi_array<ui8, 3>>();
+	fogOfWarMap = std::make_unique<TileBitmask>();
+}
+
+void TeamState::loadLegacyFogOfWar(const boost::multi_array<ui8, 3> & legacyFogOfWar)
+{
+	auto shape = legacyFogOfWar.shape();
+	fogOfWarMap->resize(int3(shape[1], shape[2], shape[0]));
+
+	for(size_t z = 0; z < shape[0]; z++)
+		for(size_t x = 0; x < shape[1]; x++)
+			for(size_t y = 0; y < shape[2]; y++)
+				if(legacyFogOfWar[z][x][y])
+					fogOfWarMap->set(int3(x, y, z));
 }
 
 CRandomGenerator & CGameState::getRandomGenerator()
@@ -15,6 +15,26 @@
 
 VCMI_LIB_NAMESPACE_BEGIN
 
+// Word-at-a-time helpers that test 8 input characters at once using plain integer arithmetic
+// Both checks may report false positives only in bytes located after actual match, so they are exact for "any byte" test
+static constexpr uint64_t everyByte(uint8_t value)
+{
+	return 0x0101010101010101ull * value;
+}
+
+/// Returns non-zero if any byte of word is equal to value
+static constexpr uint64_t hasByteEqual(uint64_t word, uint8_t value)
+{
+	uint64_t difference = word ^ everyByte(value);
+	return (difference - everyByte(0x01)) & ~difference & everyByte(0x80);
+}
+
+/// Returns non-zero if any byte of word is less than value, value must not exceed 128
+static constexpr uint64_t hasByteLess(uint64_t word, uint8_t value)
+{
+	return (word - everyByte(value)) & ~word & everyByte(0x80);
+}
+
 JsonParser::JsonParser(const char * inputString, size_t stringSize):
 	input(inputString, stringSize),
 	lineCount(1),
@@ -142,6 +162,21 @@ bool JsonParser::extractEscaping(std::string &str)
 	return true;
 }
 
+void JsonParser::skipPlainCharacters()
+{
+	// skip blocks of characters that need no special handling inside string - anything except quotes, escapes and control characters
+	while (pos + sizeof(uint64_t) <= input.size())
+	{
+		uint64_t word;
+		std::memcpy(&word, input.pointer(pos), sizeof(word));
+
+		if (hasByteEqual(word, '\"') || hasByteEqual(word, '\\') || hasByteLess(word, ' '))
+			return;
+
+		pos += sizeof(word);
+	}
+}
+
 bool JsonParser::extractString(std::string &str)
 {
 	if (input[pos] != '\"')
@@ -152,6 +187,11 @@ bool JsonParser::extractString(std::string &str)
 
 	while (pos != input.size())
 	{
+		skipPlainCharacters();
+
+		if (pos == input.size())
+			break;
+
 		if (input[pos] == '\"') // Correct end of string
 		{
 			str.append( &input[first], pos-first);
@@ -190,7 +230,7 @@ bool JsonParser::extractString(JsonNode &node)
 		return false;
 
 	node.setType(JsonNode::JsonType::DATA_STRING);
-	node.String() = str;
+	node.String() = std::move(str);
 	return true;
 }
 
@@ -261,28 +301,39 @@ bool JsonParser::extractStruct(JsonNode &node)
 
 		// split key string into actual key and meta-flags
 		std::vector<std::string> keyAndFlags;
-		boost::split(keyAndFlags, key, boost::is_any_of("#"));
-		key = keyAndFlags[0];
-		// check for unknown flags - helps with debugging
-		std::vector<std::string> knownFlags = { "override" };
-		for(int i = 1; i < keyAndFlags.size(); i++)
+		if (key.find('#') != std::string::npos)
 		{
-			if(!vstd::contains(knownFlags, keyAndFlags[i]))
-				error("Encountered unknown flag #" + keyAndFlags[i], true);
+			boost::split(keyAndFlags, key, boost::is_any_of("#"));
+			key = keyAndFlags[0];
+			// check for unknown flags - helps with debugging
+			std::vector<std::string> knownFlags = { "override" };
+			for(int i = 1; i < keyAndFlags.size(); i++)
+			{
+				if(!vstd::contains(knownFlags, keyAndFlags[i]))
+					error("Encountered unknown flag #" + keyAndFlags[i], true);
+			}
 		}
 
-		if (node.Struct().find(key) != node.Struct().end())
+		// single lookup in map, reused as insertion hint
+		auto & members = node.Struct();
+		auto element = members.lower_bound(key);
+		bool duplicate = element != members.end() && element->first == key;
+
+		if (duplicate)
 			error("Duplicate element encountered!", true);
 
 		if (!extractSeparator())
 			return false;
 
-		if (!extractElement(node.Struct()[key], '}'))
+		if (!duplicate)
+			element = members.emplace_hint(element, std::move(key), JsonNode());
+
+		if (!extractElement(element->second, '}'))
 			return false;
 
 		// flags from key string belong to referenced element
 		for(int i = 1; i < keyAndFlags.size(); i++)
-			node.Struct()[key].flags.push_back(keyAndFlags[i]);
+			element->second.flags.push_back(keyAndFlags[i]);
 
 		if (input[pos] == '}')
 		{
@@ -37,6 +37,13 @@ public:
 		assert (position < datasize);
 		return data[position];
 	}
+
+	/// pointer to character at specified position, for reading input in blocks
+	inline const char * pointer(size_t position) const
+	{
+		assert (position <= datasize);
+		return data + position;
+	}
 };
 
 //Internal class for string -> JsonNode conversion
@@ -53,6 +60,7 @@ class JsonParser
 	bool extractLiteral(const std::string &literal);
 	bool extractString(std::string &string);
 	bool extractWhitespace(bool verbose = true);
+	void skipPlainCharacters();
 	bool extractSeparator();
 	bool extractElement(JsonNode &node, char terminator);
 
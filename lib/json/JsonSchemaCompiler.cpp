@@ -0,0 +1,736 @@
+/*
+ * JsonSchemaCompiler.cpp, part of VCMI engine
+ *
+ * Authors: listed in file AUTHORS in main folder
+ *
+ * License: GNU General Public License v2.0 or later
+ * Full text of license available in license.txt file, in main folder
+ *
+ */
+
+#include "StdInc.h"
+#include "JsonSchemaCompiler.h"
+
+#include "JsonUtils.h"
+
+VCMI_LIB_NAMESPACE_BEGIN
+
+namespace Validation
+{
+namespace
+{
+	/// Data types used to query known fields of each type group
+	const std::array<JsonNode::JsonType, 5> typeGroupRepresentatives =
+	{
+		JsonNode::JsonType::DATA_NULL,
+		JsonNode::JsonType::DATA_FLOAT,
+		JsonNode::JsonType::DATA_STRING,
+		JsonNode::JsonType::DATA_VECTOR,
+		JsonNode::JsonType::DATA_STRUCT
+	};
+
+	const std::unordered_map<std::string, JsonNode::JsonType> stringToType =
+	{
+		{"null",   JsonNode::JsonType::DATA_NULL},
+		{"boolean", JsonNode::JsonType::DATA_BOOL},
+		{"number", JsonNode::JsonType::DATA_FLOAT},
+		{"string",  JsonNode::JsonType::DATA_STRING},
+		{"array",  JsonNode::JsonType::DATA_VECTOR},
+		{"object",  JsonNode::JsonType::DATA_STRUCT}
+	};
+
+	/// Schema fields that never produce errors on their own
+	const std::set<std::string> passiveFields =
+	{
+		"title", "$schema", "default", "description", "definitions", "exclusiveMaximum", "exclusiveMinimum"
+	};
+
+	/// Same as "false" check in schema - only explicit "true" or absence of field allows entry
+	bool isForbidden(const JsonNode & schema)
+	{
+		return !schema.isNull() && !(schema.getType() == JsonNode::JsonType::DATA_BOOL && schema.Bool());
+	}
+
+	bool reportError(std::string * errors, ValidationData & validator, const std::string & message)
+	{
+		if (errors)
+			*errors += validator.makeErrorMessage(message);
+		return false;
+	}
+
+	/// Checks that have no precompiled version - calls validator function from getKnownFieldsFor
+	class FunctionValidator : public FieldValidator
+	{
+		TFieldValidator function;
+		const JsonNode * baseSchema;
+		const JsonNode * schema;
+
+	public:
+		FunctionValidator(TFieldValidator function, const JsonNode & baseSchema, const JsonNode & schema)
+			: function(std::move(function))
+			, baseSchema(&baseSchema)
+			, schema(&schema)
+		{}
+
+		bool validate(ValidationData & validator, const JsonNode & data, std::string * errors) const override
+		{
+			std::string result = function(validator, *baseSchema, *schema, data);
+
+			if (result.empty())
+				return true;
+
+			if (errors)
+				*errors += result;
+			return false;
+		}
+	};
+
+	class TypeValidator : public FieldValidator
+	{
+		std::optional<JsonNode::JsonType> type;
+		std::string typeName;
+
+	public:
+		explicit TypeValidator(const JsonNode & schema)
+			: typeName(schema.String())
+		{
+			auto it = stringToType.find(typeName);
+			if (it != stringToType.end())
+				type = it->second;
+		}
+
+		bool validate(ValidationData & validator, const JsonNode & data, std::string * errors) const override
+		{
+			if (!type)
+				return reportError(errors, validator, "Unknown type in schema:" + typeName);
+
+			//FIXME: hack for integer values
+			if(data.isNumber() && *type == JsonNode::JsonType::DATA_FLOAT)
+				return true;
+
+			if(*type != data.getType() && data.getType() != JsonNode::JsonType::DATA_NULL)
+				return reportError(errors, validator, "Type mismatch! Expected " + typeName);
+			return true;
+		}
+	};
+
+	class EnumValidator : public FieldValidator
+	{
+		const JsonVector * entries;
+		std::unordered_set<std::string> stringEntries;
+
+	public:
+		explicit EnumValidator(const JsonNode & schema)
+			: entries(&schema.Vector())
+		{
+			for(const auto & entry : *entries)
+			{
+				if (entry.isString())
+					stringEntries.insert(entry.String());
+			}
+		}
+
+		bool validate(ValidationData & validator, const JsonNode & data, std::string * errors) const override
+		{
+			// strings can only be equal to other strings
+			if (data.isString())
+			{
+				if (stringEntries.count(data.String()))
+					return true;
+			}
+			else
+			{
+				for(const auto & enumEntry : *entries)
+				{
+					if (data == enumEntry)
+						return true;
+				}
+			}
+			return reportError(errors, validator, "Key must have one of predefined values");
+		}
+	};
+
+	class FormatValidator : public FieldValidator
+	{
+		const TFormatValidator * formatter = nullptr;
+		std::string formatName;
+
+	public:
+		explicit FormatValidator(const JsonNode & schema)
+			: formatName(schema.String())
+		{
+			const auto & formats = getKnownFormats();
+			auto checker = formats.find(formatName);
+			if (checker != formats.end())
+				formatter = &checker->second;
+		}
+
+		bool validate(ValidationData & validator, const JsonNode & data, std::string * errors) const override
+		{
+			if (!formatter)
+				return reportError(errors, validator, "Unsupported format type: " + formatName);
+
+			if (!data.isString())
+				return reportError(errors, validator, "Format value must be string: " + formatName);
+
+			std::string result = (*formatter)(data);
+			if (!result.empty())
+				return reportError(errors, validator, result);
+			return true;
+		}
+	};
+
+	class ReferenceValidator : public FieldValidator
+	{
+		const CompiledSchema * target;
+
+	public:
+		explicit ReferenceValidator(const CompiledSchema * target)
+			: target(target)
+		{}
+
+		bool validate(ValidationData & validator, const JsonNode & data, std::string * errors) const override
+		{
+			return target->validate(validator, data, errors);
+		}
+	};
+
+	class NotValidator : public FieldValidator
+	{
+		const CompiledSchema * schema;
+
+	public:
+		explicit NotValidator(const CompiledSchema * schema)
+			: schema(schema)
+		{}
+
+		bool validate(ValidationData & validator, const JsonNode & data, std::string * errors) const override
+		{
+			if (schema->validate(validator, data, nullptr))
+				return reportError(errors, validator, "Successful validation against negative check");
+			return true;
+		}
+	};
+
+	/// allOf, anyOf and oneOf checks
+	class SchemaListValidator : public FieldValidator
+	{
+	public:
+		enum class EMode
+		{
+			ALL,
+			ANY,
+			ONE
+		};
+
+	private:
+		std::vector<const CompiledSchema *> schemas;
+		EMode mode;
+
+		bool isValid(size_t count) const
+		{
+			switch (mode)
+			{
+				case EMode::ALL: return count == schemas.size();
+				case EMode::ANY: return count > 0;
+				case EMode::ONE: return count == 1;
+			}
+			return false;
+		}
+
+		std::string getErrorMessage() const
+		{
+			switch (mode)
+			{
+				case EMode::ALL: return "Failed to pass all schemas";
+				case EMode::ANY: return "Failed to pass any schema";
+				case EMode::ONE: return "Failed to pass exactly one schema";
+			}
+			return "";
+		}
+
+	public:
+		SchemaListValidator(std::vector<const CompiledSchema *> schemas, EMode mode)
+			: schemas(std::move(schemas))
+			, mode(mode)
+		{}
+
+		bool validate(ValidationData & validator, const JsonNode & data, std::string * errors) const override
+		{
+			size_t result = 0;
+			for(const auto * schema : schemas)
+			{
+				if (schema->validate(validator, data, nullptr))
+					result++;
+			}
+
+			if (isValid(result))
+				return true;
+
+			// failed - repeat validation to collect messages from all tested schemas
+			if (errors)
+			{
+				*errors += validator.makeErrorMessage(getErrorMessage());
+				*errors += "<tested schemas>\n";
+				for(const auto * schema : schemas)
+				{
+					if (!schema->validate(validator, data, errors))
+						*errors += "<end of schema>\n";
+				}
+			}
+			return false;
+		}
+	};
+
+	class ItemsValidator : public FieldValidator
+	{
+		/// schema for each position in list, if "items" is a list
+		std::vector<const CompiledSchema *> positionSchemas;
+		/// schema for all items, if "items" is a single schema
+		const CompiledSchema * commonSchema = nullptr;
+
+	public:
+		ItemsValidator(std::vector<const CompiledSchema *> positionSchemas, const CompiledSchema * commonSchema)
+			: positionSchemas(std::move(positionSchemas))
+			, commonSchema(commonSchema)
+		{}
+
+		bool validate(ValidationData & validator, const JsonNode & data, std::string * errors) const override
+		{
+			bool valid = true;
+			const auto & items = data.Vector();
+
+			for (size_t i = 0; i < items.size(); i++)
+			{
+				const CompiledSchema * schema = commonSchema;
+				if (!commonSchema)
+					schema = i < positionSchemas.size() ? positionSchemas[i] : nullptr;
+
+				if (!schema)
+					continue;
+
+				validator.currentPath.emplace_back(i);
+				valid &= schema->validate(validator, items[i], errors);
+				validator.currentPath.pop_back();
+
+				if (!valid && !errors)
+					return false;
+			}
+			return valid;
+		}
+	};
+
+	class AdditionalItemsValidator : public FieldValidator
+	{
+		size_t firstItem;
+		/// schema for additional items, or null if they are forbidden
+		const CompiledSchema * schema;
+
+	public:
+		AdditionalItemsValidator(size_t firstItem, const CompiledSchema * schema)
+			: firstItem(firstItem)
+			, schema(schema)
+		{}
+
+		bool validate(ValidationData & validator, const JsonNode & data, std::string * errors) const override
+		{
+			bool valid = true;
+			const auto & items = data.Vector();
+
+			for (size_t i = firstItem; i < items.size(); i++)
+			{
+				if (schema)
+				{
+					validator.currentPath.emplace_back(i);
+					valid &= schema->validate(validator, items[i], errors);
+					validator.currentPath.pop_back();
+				}
+				else
+					valid = reportError(errors, validator, "Unknown entry found");
+
+				if (!valid && !errors)
+					return false;
+			}
+			return valid;
+		}
+	};
+
+	class PropertiesValidator : public FieldValidator
+	{
+		/// sorted in same order as entries of JsonMap
+		std::vector<std::pair<std::string, const CompiledSchema *>> properties;
+
+	public:
+		explicit PropertiesValidator(std::vector<std::pair<std::string, const CompiledSchema *>> properties)
+			: properties(std::move(properties))
+		{}
+
+		bool validate(ValidationData & validator, const JsonNode & data, std::string * errors) const override
+		{
+			bool valid = true;
+			auto property = properties.begin();
+
+			// both lists are sorted by name - walk them together instead of searching for each entry
+			for(const auto & entry : data.Struct())
+			{
+				while (property != properties.end() && property->first < entry.first)
+					property++;
+
+				if (property == properties.end())
+					break;
+
+				if (property->first != entry.first)
+					continue;
+
+				validator.currentPath.emplace_back(std::string_view(entry.first));
+				valid &= property->second->validate(validator, entry.second, errors);
+				validator.currentPath.pop_back();
+
+				if (!valid && !errors)
+					return false;
+			}
+			return valid;
+		}
+	};
+
+	class AdditionalPropertiesValidator : public FieldValidator
+	{
+		const JsonMap * knownProperties;
+		/// schema for additional properties, or null if they are forbidden
+		const CompiledSchema * schema;
+
+	public:
+		AdditionalPropertiesValidator(const JsonMap & knownProperties, const CompiledSchema * schema)
+			: knownProperties(&knownProperties)
+			, schema(schema)
+		{}
+
+		bool validate(ValidationData & validator, const JsonNode & data, std::string * errors) const override
+		{
+			bool valid = true;
+
+			for(const auto & entry : data.Struct())
+			{
+				if (knownProperties->count(entry.first) != 0)
+					continue;
+
+				if (schema)
+				{
+					validator.currentPath.emplace_back(std::string_view(entry.first));
+					valid &= schema->validate(validator, entry.second, errors);
+					validator.currentPath.pop_back();
+				}
+				else
+					valid = reportError(errors, validator, "Unknown entry found: " + entry.first);
+
+				if (!valid && !errors)
+					return false;
+			}
+			return valid;
+		}
+	};
+
+	class RequiredValidator : public FieldValidator
+	{
+		std::vector<std::string> requiredNames;
+
+	public:
+		explicit RequiredValidator(const JsonNode & schema)
+		{
+			for(const auto & required : schema.Vector())
+				requiredNames.push_back(required.String());
+		}
+
+		bool validate(ValidationData & validator, const JsonNode & data, std::string * errors) const override
+		{
+			bool valid = true;
+			for(const auto & name : requiredNames)
+			{
+				if (data[name].isNull())
+				{
+					valid = reportError(errors, validator, "Required entry " + name + " is missing");
+					if (!errors)
+						return false;
+				}
+			}
+			return valid;
+		}
+	};
+
+	class DependenciesValidator : public FieldValidator
+	{
+	public:
+		struct Dependency
+		{
+			std::string name;
+			/// properties that must be present together with this one
+			std::vector<std::string> properties;
+			/// schema that data must pass if this property is present, used if properties are not listed explicitly
+			const CompiledSchema * schema = nullptr;
+		};
+
+	private:
+		std::vector<Dependency> dependencies;
+
+	public:
+		explicit DependenciesValidator(std::vector<Dependency> dependencies)
+			: dependencies(std::move(dependencies))
+		{}
+
+		bool validate(ValidationData & validator, const JsonNode & data, std::string * errors) const override
+		{
+			bool valid = true;
+			for(const auto & dependency : dependencies)
+			{
+				if (data[dependency.name].isNull())
+					continue;
+
+				if (dependency.schema)
+				{
+					if (!dependency.schema->validate(validator, data, nullptr))
+						valid = reportError(errors, validator, "Requirements for " + dependency.name + " are not fulfilled");
+				}
+				else
+				{
+					for(const auto & property : dependency.properties)
+					{
+						if (data[property].isNull())
+							valid = reportError(errors, validator, "Property " + property + " required for " + dependency.name + " is missing");
+					}
+				}
+
+				if (!valid && !errors)
+					return false;
+			}
+			return valid;
+		}
+	};
+}
+
+size_t CompiledSchema::getTypeGroup(JsonNode::JsonType type)
+{
+	switch (type)
+	{
+		case JsonNode::JsonType::DATA_FLOAT:
+		case JsonNode::JsonType::DATA_INTEGER:
+			return 1;
+		case JsonNode::JsonType::DATA_STRING: return 2;
+		case JsonNode::JsonType::DATA_VECTOR: return 3;
+		case JsonNode::JsonType::DATA_STRUCT: return 4;
+		default: return 0;
+	}
+}
+
+bool CompiledSchema::validate(ValidationData & validator, const JsonNode & data, std::string * errors) const
+{
+	bool valid = true;
+	for(const auto * field : fieldsByType[getTypeGroup(data.getType())])
+	{
+		if (!field->validate(validator, data, errors))
+		{
+			valid = false;
+			if (!errors)
+				return false;
+		}
+	}
+	return valid;
+}
+
+SchemaCompiler & SchemaCompiler::get()
+{
+	static SchemaCompiler compiler;
+	return compiler;
+}
+
+const CompiledSchema * SchemaCompiler::compile(const std::string & schemaName)
+{
+	boost::mutex::scoped_lock lock(mutex);
+	return compileSchema(schemaName);
+}
+
+const CompiledSchema * SchemaCompiler::compileSchema(const std::string & schemaName)
+{
+	auto it = compiledSchemas.find(schemaName);
+	if (it != compiledSchemas.end())
+		return it->second;
+
+	const CompiledSchema * result = compileNode(JsonUtils::getSchema(schemaName), schemaName);
+	compiledSchemas[schemaName] = result;
+	return result;
+}
+
+const CompiledSchema * SchemaCompiler::compileNode(const JsonNode & schema, const std::string & schemaName)
+{
+	// Node may be reached again through its own references, so it is registered before its fields are compiled
+	auto & entry = compiledNodes[&schema];
+	if (entry)
+		return entry.get();
+
+	entry = std::make_unique<CompiledSchema>();
+	CompiledSchema * result = entry.get();
+
+	for(const auto & field : schema.Struct())
+	{
+		auto validator = compileField(field.first, schema, field.second, schemaName);
+		if (!validator)
+			continue;
+
+		for (size_t group = 0; group < CompiledSchema::TYPE_GROUPS; group++)
+		{
+			if (getKnownFieldsFor(typeGroupRepresentatives[group]).count(field.first))
+				result->fieldsByType[group].push_back(validator.get());
+		}
+		result->fields.push_back(std::move(validator));
+	}
+	return result;
+}
+
+std::unique_ptr<FieldValidator> SchemaCompiler::compileField(const std::string & fieldName, const JsonNode & baseSchema, const JsonNode & schema, const std::string & schemaName)
+{
+	if (passiveFields.count(fieldName))
+		return nullptr;
+
+	if (fieldName == "type")
+		return std::make_unique<TypeValidator>(schema);
+
+	if (fieldName == "enum")
+		return std::make_unique<EnumValidator>(schema);
+
+	if (fieldName == "format")
+		return std::make_unique<FormatValidator>(schema);
+
+	if (fieldName == "$ref")
+	{
+		std::string URI = schema.String();
+		//Local reference. Turn it into more easy to handle remote ref
+		if (boost::algorithm::starts_with(URI, "#"))
+			URI = schemaName.substr(0, schemaName.find('#')) + URI;
+
+		return std::make_unique<ReferenceValidator>(compileSchema(URI));
+	}
+
+	if (fieldName == "not")
+		return std::make_unique<NotValidator>(compileNode(schema, schemaName));
+
+	if (fieldName == "allOf" || fieldName == "anyOf" || fieldName == "oneOf")
+	{
+		std::vector<const CompiledSchema *> schemas;
+		for(const auto & schemaEntry : schema.Vector())
+			schemas.push_back(compileNode(schemaEntry, schemaName));
+
+		auto mode = SchemaListValidator::EMode::ONE;
+		if (fieldName == "allOf")
+			mode = SchemaListValidator::EMode::ALL;
+		if (fieldName == "anyOf")
+			mode = SchemaListValidator::EMode::ANY;
+
+		return std::make_unique<SchemaListValidator>(schemas, mode);
+	}
+
+	if (fieldName == "items")
+	{
+		if (schema.getType() != JsonNode::JsonType::DATA_VECTOR)
+			return std::make_unique<ItemsValidator>(std::vector<const CompiledSchema *>(), schema.isNull() ? nullptr : compileNode(schema, schemaName));
+
+		std::vector<const CompiledSchema *> positionSchemas;
+		for(const auto & item : schema.Vector())
+			positionSchemas.push_back(item.isNull() ? nullptr : compileNode(item, schemaName));
+
+		return std::make_unique<ItemsValidator>(positionSchemas, nullptr);
+	}
+
+	if (fieldName == "additionalItems")
+	{
+		// "items" is struct or empty (defaults to empty struct) - validation always successful
+		const JsonNode & items = baseSchema["items"];
+		if (items.getType() != JsonNode::JsonType::DATA_VECTOR)
+			return nullptr;
+
+		if (schema.getType() == JsonNode::JsonType::DATA_STRUCT)
+			return std::make_unique<AdditionalItemsValidator>(items.Vector().size(), compileNode(schema, schemaName));
+		if (isForbidden(schema))
+			return std::make_unique<AdditionalItemsValidator>(items.Vector().size(), nullptr);
+		return nullptr;
+	}
+
+	if (fieldName == "properties")
+	{
+		std::vector<std::pair<std::string, const CompiledSchema *>> properties;
+		for(const auto & property : schema.Struct())
+		{
+			// there is schema specifically for this item
+			if (!property.second.isNull())
+				properties.emplace_back(property.first, compileNode(property.second, schemaName));
+		}
+		return std::make_unique<PropertiesValidator>(properties);
+	}
+
+	if (fieldName == "additionalProperties")
+	{
+		const JsonMap & knownProperties = baseSchema["properties"].Struct();
+
+		if (schema.getType() == JsonNode::JsonType::DATA_STRUCT)
+			return std::make_unique<AdditionalPropertiesValidator>(knownProperties, compileNode(schema, schemaName));
+		if (isForbidden(schema))
+			return std::make_unique<AdditionalPropertiesValidator>(knownProperties, nullptr);
+		return nullptr;
+	}
+
+	if (fieldName == "required")
+		return std::make_unique<RequiredValidator>(schema);
+
+	if (fieldName == "dependencies")
+	{
+		std::vector<DependenciesValidator::Dependency> dependencies;
+		for(const auto & deps : schema.Struct())
+		{
+			DependenciesValidator::Dependency dependency;
+			dependency.name = deps.first;
+
+			if (deps.second.getType() == JsonNode::JsonType::DATA_VECTOR)
+			{
+				for(const auto & depEntry : deps.second.Vector())
+					dependency.properties.push_back(depEntry.String());
+			}
+			else
+				dependency.schema = compileNode(deps.second, schemaName);
+
+			dependencies.push_back(dependency);
+		}
+		return std::make_unique<DependenciesValidator>(dependencies);
+	}
+
+	// remaining checks only inspect data and schema value - use their validator functions
+	for (const auto & type : typeGroupRepresentatives)
+	{
+		const auto & knownFields = getKnownFieldsFor(type);
+		auto checker = knownFields.find(fieldName);
+		if (checker != knownFields.end() && checker->second)
+			return std::make_unique<FunctionValidator>(checker->second, baseSchema, schema);
+	}
+
+	// unknown entry in schema, ignored
+	return nullptr;
+}
+
+std::string check(const std::string & schemaName, const JsonNode & data)
+{
+	const CompiledSchema * schema = SchemaCompiler::get().compile(schemaName);
+
+	ValidationData validator;
+	std::string errors;
+	schema->validate(validator, data, &errors);
+	return errors;
+}
+
+bool isValid(const std::string & schemaName, const JsonNode & data)
+{
+	const CompiledSchema * schema = SchemaCompiler::get().compile(schemaName);
+
+	ValidationData validator;
+	return schema->validate(validator, data, nullptr);
+}
+
+} // Validation namespace
+
+VCMI_LIB_NAMESPACE_END
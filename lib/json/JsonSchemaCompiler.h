@@ -0,0 +1,71 @@
+/*
+ * JsonSchemaCompiler.h, part of VCMI engine
+ *
+ * Authors: listed in file AUTHORS in main folder
+ *
+ * License: GNU General Public License v2.0 or later
+ * Full text of license available in license.txt file, in main folder
+ *
+ */
+#pragma once
+
+#include "JsonValidator.h"
+
+VCMI_LIB_NAMESPACE_BEGIN
+
+namespace Validation
+{
+	class CompiledSchema;
+
+	/// Single compiled entry of schema, such as "type" or "properties"
+	class FieldValidator
+	{
+	public:
+		virtual ~FieldValidator() = default;
+
+		/// Returns true if data passes this check
+		/// If errors is not null, error messages are appended to it
+		virtual bool validate(ValidationData & validator, const JsonNode & data, std::string * errors) const = 0;
+	};
+
+	/// Schema node turned into list of validators for each type of data
+	class CompiledSchema : boost::noncopyable
+	{
+		friend class SchemaCompiler;
+
+		/// Groups of data types that share same set of known fields, see getKnownFieldsFor
+		static constexpr size_t TYPE_GROUPS = 5;
+		static size_t getTypeGroup(JsonNode::JsonType type);
+
+		std::vector<std::unique_ptr<FieldValidator>> fields;
+		/// validators that apply to each group of types, in same order as entries in schema
+		std::array<std::vector<const FieldValidator *>, TYPE_GROUPS> fieldsByType;
+
+	public:
+		/// Without errors output, validation stops on first failed check
+		bool validate(ValidationData & validator, const JsonNode & data, std::string * errors) const;
+	};
+
+	/// Compiles schemas into trees of validators on first use. References are resolved during compilation,
+	/// so validation does not need to parse schema URI's or look up schema fields by name.
+	/// Compiled schemas refer to schema nodes returned by JsonUtils::getSchema, which are never unloaded
+	class SchemaCompiler : boost::noncopyable
+	{
+		boost::mutex mutex;
+		std::map<const JsonNode *, std::unique_ptr<CompiledSchema>> compiledNodes;
+		std::map<std::string, const CompiledSchema *> compiledSchemas;
+
+		/// Schema name is used to resolve local references of schema node
+		const CompiledSchema * compileSchema(const std::string & schemaName);
+		const CompiledSchema * compileNode(const JsonNode & schema, const std::string & schemaName);
+		std::unique_ptr<FieldValidator> compileField(const std::string & fieldName, const JsonNode & baseSchema, const JsonNode & schema, const std::string & schemaName);
+
+	public:
+		static SchemaCompiler & get();
+
+		/// Returns compiled version of schema with specified URI, same as accepted by JsonUtils::getSchema
+		const CompiledSchema * compile(const std::string & schemaName);
+	};
+}
+
+VCMI_LIB_NAMESPACE_END
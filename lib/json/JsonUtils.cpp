@@ -129,6 +129,10 @@ void JsonUtils::maximize(JsonNode & node, const std::string & schemaName)
 
 bool JsonUtils::validate(const JsonNode & node, const std::string & schemaName, const std::string & dataName)
 {
+	// error messages are only generated for invalid data
+	if (Validation::isValid(schemaName, node))
+		return true;
+
 	std::string log = Validation::check(schemaName, node);
 	if (!log.empty())
 	{
@@ -20,13 +20,9 @@ namespace Validation
 	/// struct used to pass data around during validation
 	struct ValidationData
 	{
-		/// path from root node to current one.
-		/// JsonNode is used as variant - either string (name of node) or as float (index in list)
-		std::vector<JsonNode> currentPath;
-
-		/// Stack of used schemas. Last schema is the one used currently.
-		/// May contain multiple items in case if remote references were found
-		std::vector<std::string> usedSchemas;
+		/// path from root node to current one - either name of node in struct or index in list
+		/// names refer to keys of validated data and are only valid during validation
+		std::vector<std::variant<std::string_view, size_t>> currentPath;
 
 		/// generates error message
 		std::string makeErrorMessage(const std::string &message);
@@ -37,13 +33,16 @@ namespace Validation
 	using TFieldValidator = std::function<std::string(ValidationData &, const JsonNode &, const JsonNode &, const JsonNode &)>;
 	using TValidatorMap = std::unordered_map<std::string, TFieldValidator>;
 
-	/// map of known fields in schema
+	/// map of known fields in schema for specified type of data
+	/// fields without validator function are handled by SchemaCompiler directly
 	const TValidatorMap & getKnownFieldsFor(JsonNode::JsonType type);
 	const TFormatMap & getKnownFormats();
 
-	std::string check(const std::string & schemaName, const JsonNode & data);
-	std::string check(const std::string & schemaName, const JsonNode & data, ValidationData & validator);
-	std::string check(const JsonNode & schema, const JsonNode & data, ValidationData & validator);
+	/// Validates data using schema compiled into tree of validators on first use, see SchemaCompiler
+	/// Returns error messages, or empty string if data is valid
+	DLL_LINKAGE std::string check(const std::string & schemaName, const JsonNode & data);
+	/// Faster variant of check() for callers that only need the verdict: stops at first error and builds no messages
+	DLL_LINKAGE bool isValid(const std::string & schemaName, const JsonNode & data);
 }
 
 VCMI_LIB_NAMESPACE_END
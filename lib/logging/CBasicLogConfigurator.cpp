@@ -87,7 +87,12 @@ void CBasicLogConfigurator::configure()
 			const JsonNode & fileFormatNode = fileNode["format"];
 			if(!fileFormatNode.isNull()) fileTarget->setFormatter(CLogFormatter(fileFormatNode.String()));
 		}
-		CLogger::getGlobalLogger()->addTarget(std::move(fileTarget));
+
+		// Write log file on background thread, if requested
+		if(fileNode["asynchronous"].Bool())
+			CLogger::getGlobalLogger()->addTarget(std::make_unique<CLogAsyncTarget>(std::move(fileTarget)));
+		else
+			CLogger::getGlobalLogger()->addTarget(std::move(fileTarget));
 		appendToLogFile = true;
 	}
 	catch(const std::exception & e)
@@ -11,6 +11,8 @@
 #include "CLogger.h"
 #include "../CThreadHelper.h"
 
+#include <boost/container/small_vector.hpp>
+
 #ifdef VCMI_ANDROID
 #include <android/log.h>
 
@@ -157,15 +159,13 @@ void CLogger::log(ELogLevel::ELogLevel level, const boost::format & fmt) const
 
 ELogLevel::ELogLevel CLogger::getLevel() const
 {
-	TLockGuard _(mx);
-	return level;
+	return level.load(std::memory_order_relaxed);
 }
 
 void CLogger::setLevel(ELogLevel::ELogLevel level)
 {
-	TLockGuard _(mx);
 	if (!domain.isGlobalDomain() || level != ELogLevel::NOT_SET)
-		this->level = level;
+		this->level.store(level, std::memory_order_relaxed);
 }
 
 const CLoggerDomain & CLogger::getDomain() const { return domain; }
@@ -179,8 +179,11 @@ void CLogger::addTarget(std::unique_ptr<ILogTarget> && target)
 ELogLevel::ELogLevel CLogger::getEffectiveLevel() const
 {
 	for(const CLogger * logger = this; logger != nullptr; logger = logger->parent)
-		if(logger->getLevel() != ELogLevel::NOT_SET)
-			return logger->getLevel();
+	{
+		ELogLevel::ELogLevel loggerLevel = logger->getLevel();
+		if(loggerLevel != ELogLevel::NOT_SET)
+			return loggerLevel;
+	}
 
 	// This shouldn't be reached, as the root logger must have set a log level
 	return ELogLevel::INFO;
@@ -188,10 +191,18 @@ ELogLevel::ELogLevel CLogger::getEffectiveLevel() const
 
 void CLogger::callTargets(const LogRecord & record) const
 {
-	TLockGuard _(mx);
+	// targets are thread-safe, so they are called without holding mutex of logger. Otherwise slow target like
+	// file would serialize all threads that log into this domain, and block adding or removing other targets
+	boost::container::small_vector<std::shared_ptr<ILogTarget>, 4> activeTargets;
+
 	for(const CLogger * logger = this; logger != nullptr; logger = logger->parent)
-		for(const auto & target : logger->targets)
-			target->write(record);
+	{
+		TLockGuard _(logger->mx);
+		activeTargets.insert(activeTargets.end(), logger->targets.begin(), logger->targets.end());
+	}
+
+	for(const auto & target : activeTargets)
+		target->write(record);
 }
 
 void CLogger::clearTargets()
@@ -446,6 +457,180 @@ CLogFileTarget::~CLogFileTarget()
 	file.close();
 }
 
+struct CLogAsyncTarget::Slot
+{
+	/// equal to queue position if slot is free for writing, position + 1 once record is stored
+	std::atomic<size_t> sequence;
+	std::optional<LogRecord> record;
+};
+
+CLogAsyncTarget::CLogAsyncTarget(std::unique_ptr<ILogTarget> && target, size_t capacity)
+	: target(std::move(target))
+	, enqueuePosition(0)
+	, dequeuePosition(0)
+	, writtenPosition(0)
+	, droppedRecords(0)
+	, reportedDrops(0)
+	, writerWaiting(false)
+	, flushWaiters(0)
+	, stopping(false)
+{
+	size_t slotsCount = 1;
+	while (slotsCount < capacity)
+		slotsCount *= 2;
+
+	mask = slotsCount - 1;
+	slots = std::make_unique<Slot[]>(slotsCount);
+	for (size_t i = 0; i < slotsCount; ++i)
+		slots[i].sequence.store(i, std::memory_order_relaxed);
+
+	writer = boost::thread(&CLogAsyncTarget::runWriter, this);
+}
+
+CLogAsyncTarget::~CLogAsyncTarget()
+{
+	{
+		boost::lock_guard<boost::mutex> lock(mx);
+		stopping = true;
+		wakeup.notify_one();
+	}
+	writer.join();
+}
+
+bool CLogAsyncTarget::tryPush(const LogRecord & record)
+{
+	size_t position = enqueuePosition.load(std::memory_order_relaxed);
+	Slot * slot;
+
+	while (true)
+	{
+		slot = &slots[position & mask];
+		size_t sequence = slot->sequence.load(std::memory_order_acquire);
+		auto difference = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(position);
+
+		if (difference == 0)
+		{
+			// slot is free - try to claim it
+			if (enqueuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+				break;
+		}
+		else if (difference < 0)
+		{
+			// writer did not process this slot yet - queue is full
+			return false;
+		}
+		else
+		{
+			// slot was claimed by another thread
+			position = enqueuePosition.load(std::memory_order_relaxed);
+		}
+	}
+
+	slot->record.emplace(record);
+	slot->sequence.store(position + 1, std::memory_order_release);
+	return true;
+}
+
+std::optional<LogRecord> CLogAsyncTarget::tryPop()
+{
+	Slot & slot = slots[dequeuePosition & mask];
+
+	if (slot.sequence.load(std::memory_order_acquire) != dequeuePosition + 1)
+		return std::nullopt;
+
+	std::optional<LogRecord> result = std::move(slot.record);
+	slot.record.reset();
+	slot.sequence.store(dequeuePosition + mask + 1, std::memory_order_release);
+	dequeuePosition++;
+	return result;
+}
+
+bool CLogAsyncTarget::isRecordReady() const
+{
+	return slots[dequeuePosition & mask].sequence.load(std::memory_order_acquire) == dequeuePosition + 1;
+}
+
+void CLogAsyncTarget::write(const LogRecord & record)
+{
+	if (!tryPush(record))
+	{
+		droppedRecords.fetch_add(1, std::memory_order_relaxed);
+		return;
+	}
+
+	// pairs with fence in runWriter: either writer sees this record before going to sleep, or we see that it sleeps
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	if (writerWaiting.load(std::memory_order_relaxed))
+	{
+		boost::lock_guard<boost::mutex> lock(mx);
+		wakeup.notify_one();
+	}
+}
+
+void CLogAsyncTarget::flush()
+{
+	size_t position = enqueuePosition.load(std::memory_order_acquire);
+
+	flushWaiters++;
+
+	// records may still be written into slots claimed before this call - wait until writer gets past all of them
+	boost::unique_lock<boost::mutex> lock(mx);
+	drained.wait(lock, [this, position]()
+	{
+		return writtenPosition.load() >= position;
+	});
+
+	flushWaiters--;
+}
+
+uint64_t CLogAsyncTarget::getDroppedRecords() const
+{
+	return droppedRecords.load(std::memory_order_relaxed);
+}
+
+void CLogAsyncTarget::runWriter()
+{
+	setThreadNameLoggingOnly("logWriter");
+
+	while (true)
+	{
+		// formatting and output of wrapped target happen here, on writer thread
+		while (auto record = tryPop())
+		{
+			target->write(*record);
+			writtenPosition.store(dequeuePosition);
+		}
+
+		if (flushWaiters.load() != 0)
+		{
+			boost::lock_guard<boost::mutex> lock(mx);
+			drained.notify_all();
+		}
+
+		uint64_t dropped = droppedRecords.load(std::memory_order_relaxed);
+		if (dropped != reportedDrops)
+		{
+			std::string message = std::to_string(dropped - reportedDrops) + " log records were dropped due to full log queue";
+			target->write(LogRecord(CLoggerDomain(CLoggerDomain::DOMAIN_GLOBAL), ELogLevel::WARN, message));
+			reportedDrops = dropped;
+		}
+
+		boost::unique_lock<boost::mutex> lock(mx);
+		writerWaiting.store(true, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+
+		if (!isRecordReady())
+		{
+			// records pushed before stop request might be still in the queue
+			if (stopping && dequeuePosition == enqueuePosition.load(std::memory_order_acquire))
+				return;
+
+			wakeup.wait(lock);
+		}
+		writerWaiting.store(false, std::memory_order_relaxed);
+	}
+}
+
 LogRecord::LogRecord(const CLoggerDomain & domain, ELogLevel::ELogLevel level, const std::string & message)
 	: domain(domain),
 	level(level),
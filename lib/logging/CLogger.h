@@ -75,8 +75,9 @@ private:
 
 	CLoggerDomain domain;
 	CLogger * parent;
-	ELogLevel::ELogLevel level;
-	std::vector<std::unique_ptr<ILogTarget> > targets;
+	std::atomic<ELogLevel::ELogLevel> level;
+	/// Shared with logging threads, which call targets without holding mutex of logger
+	std::vector<std::shared_ptr<ILogTarget> > targets;
 	mutable std::mutex mx;
 	static std::recursive_mutex smx;
 };
@@ -219,4 +220,58 @@ private:
 	mutable std::mutex mx;
 };
 
+/// This target passes log records to another target on a background writer thread, so formatting
+/// and output of the wrapped target don't block logging threads.
+/// Records are stored in a bounded lock-free queue. If the queue is full, new records are dropped
+/// and counted, and the writer reports the number of dropped records through the wrapped target.
+class DLL_LINKAGE CLogAsyncTarget : public ILogTarget
+{
+public:
+	static constexpr size_t DEFAULT_CAPACITY = 8192;
+
+	/// Capacity is rounded up to power of two
+	explicit CLogAsyncTarget(std::unique_ptr<ILogTarget> && target, size_t capacity = DEFAULT_CAPACITY);
+	/// Passes all queued records to wrapped target before returning
+	~CLogAsyncTarget();
+
+	void write(const LogRecord & record) override;
+
+	/// Blocks until all records queued before this call are passed to wrapped target
+	void flush();
+
+	/// Total number of records that were dropped due to full queue
+	uint64_t getDroppedRecords() const;
+
+private:
+	struct Slot;
+
+	bool tryPush(const LogRecord & record);
+	std::optional<LogRecord> tryPop();
+	bool isRecordReady() const;
+	void runWriter();
+
+	std::unique_ptr<ILogTarget> target;
+	std::unique_ptr<Slot[]> slots;
+	size_t mask;
+
+	std::atomic<size_t> enqueuePosition;
+	/// position of next record to read, only accessed by writer
+	size_t dequeuePosition;
+	/// number of records that were passed to wrapped target
+	std::atomic<size_t> writtenPosition;
+	std::atomic<uint64_t> droppedRecords;
+	uint64_t reportedDrops;
+
+	/// set while writer is going to sleep, loggers wake it up only in this case
+	std::atomic<bool> writerWaiting;
+	std::atomic<int> flushWaiters;
+	std::atomic<bool> stopping;
+	boost::mutex mx;
+	/// notified by loggers when record is added to queue of waiting writer
+	boost::condition_variable wakeup;
+	/// notified by writer when all records in queue are written, if someone waits in flush
+	boost::condition_variable drained;
+	boost::thread writer;
+};
+
 VCMI_LIB_NAMESPACE_END
@@ -102,15 +102,10 @@ ui32 CGHeroInstance::getTileMovementCost(const TerrainTile & dest, const Terrain
 	{
 		ret = from.roadType->movementCost;
 	}
-	else if(ti->nativeTerrain != from.terType->getId() &&//the terrain is not native
-			ti->nativeTerrain != ETerrainId::ANY_TERRAIN && //no special creature bonus
-			!ti->hasBonusOfType(BonusType::NO_TERRAIN_PENALTY, BonusSubtypeID(from.terType->getId()))) //no special movement bonus
+	else
 	{
-
-		ret = VLC->terrainTypeHandler->getById(from.terType->getId())->moveCost;
-		ret -= ti->valOfBonuses(BonusType::ROUGH_TERRAIN_DISCOUNT);
-		if(ret < GameConstants::BASE_MOVEMENT_COST)
-			ret = GameConstants::BASE_MOVEMENT_COST;
+		// native terrain, terrain penalty and pathfinding discount are already accounted for
+		ret = ti->getTerrainMovementCost(from.terType->getId());
 	}
 	return static_cast<ui32>(ret);
 }
@@ -252,8 +247,7 @@ void CGHeroInstance::setMovementPoints(int points)
 
 int CGHeroInstance::movementPointsLimit(bool onLand) const
 {
-	TurnInfo ti(this);
-	return movementPointsLimitCached(onLand, &ti);
+	return getMovementProfile()->getMaxMovePoints(onLand ? EPathfindingLayer::LAND : EPathfindingLayer::SAIL);
 }
 
 int CGHeroInstance::getLowestCreatureSpeed() const
@@ -261,7 +255,7 @@ int CGHeroInstance::getLowestCreatureSpeed() const
 	return lowestCreatureSpeed;
 }
 
-void CGHeroInstance::updateArmyMovementBonus(bool onLand, const TurnInfo * ti) const
+void CGHeroInstance::updateArmyMovementBonus() const
 {
 	auto realLowestSpeed = lowestSpeed(this);
 	if(lowestCreatureSpeed != realLowestSpeed)
@@ -269,14 +263,34 @@ void CGHeroInstance::updateArmyMovementBonus(bool onLand, const TurnInfo * ti) c
 		lowestCreatureSpeed = realLowestSpeed;
 		//Let updaters run again
 		treeHasChanged();
-		ti->updateHeroBonuses(BonusType::MOVEMENT, Selector::subtype()(onLand ? BonusCustomSubtype::heroMovementLand : BonusCustomSubtype::heroMovementSea));
 	}
 }
 
 int CGHeroInstance::movementPointsLimitCached(bool onLand, const TurnInfo * ti) const
 {
-	updateArmyMovementBonus(onLand, ti);
-	return ti->valOfBonuses(BonusType::MOVEMENT, onLand ? BonusCustomSubtype::heroMovementLand : BonusCustomSubtype::heroMovementSea);
+	return ti->getMaxMovePoints(onLand ? EPathfindingLayer::LAND : EPathfindingLayer::SAIL);
+}
+
+std::shared_ptr<const HeroMovementProfile> CGHeroInstance::getMovementProfile(int turn) const
+{
+	assert(turn >= 0);
+	boost::mutex::scoped_lock lock(movementProfilesMutex);
+
+	if(turn < static_cast<int>(movementProfiles.size()))
+	{
+		const auto & cached = movementProfiles[turn];
+		if(cached && cached->treeVersion == getTreeVersion())
+			return cached;
+	}
+
+	// army speed affects movement bonus updaters, so it must be up to date before bonuses are collected
+	updateArmyMovementBonus();
+
+	auto profile = std::make_shared<const HeroMovementProfile>(this, turn, getTreeVersion());
+	if(turn >= static_cast<int>(movementProfiles.size()))
+		movementProfiles.resize(turn + 1);
+	movementProfiles[turn] = profile;
+	return profile;
 }
 
 CGHeroInstance::CGHeroInstance(IGameCallback * cb)
@@ -1255,20 +1269,15 @@ CBonusSystemNode & CGHeroInstance::whereShouldBeAttached(CGameState * gs)
 
 int CGHeroInstance::movementPointsAfterEmbark(int MPsBefore, int basicCost, bool disembark, const TurnInfo * ti) const
 {
-	std::unique_ptr<TurnInfo> turnInfoLocal;
-	if(!ti)
-	{
-		turnInfoLocal = std::make_unique<TurnInfo>(this);
-		ti = turnInfoLocal.get();
-	}
+	auto profile = ti ? ti->profile : getMovementProfile();
 
-	if(!ti->hasBonusOfType(BonusType::FREE_SHIP_BOARDING))
+	if(!profile->freeShipBoarding)
 		return 0; // take all MPs by default
 	
 	auto boatLayer = boat ? boat->layer : EPathfindingLayer::SAIL;
 
-	int mp1 = ti->getMaxMovePoints(disembark ? EPathfindingLayer::LAND : boatLayer);
-	int mp2 = ti->getMaxMovePoints(disembark ? boatLayer : EPathfindingLayer::LAND);
+	int mp1 = profile->getMaxMovePoints(disembark ? EPathfindingLayer::LAND : boatLayer);
+	int mp2 = profile->getMaxMovePoints(disembark ? boatLayer : EPathfindingLayer::LAND);
 	int ret = static_cast<int>((MPsBefore - basicCost) * static_cast<double>(mp1) / mp2);
 	return ret;
 }
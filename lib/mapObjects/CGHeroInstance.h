@@ -23,6 +23,7 @@ class CGTownInstance;
 class CMap;
 struct TerrainTile;
 struct TurnInfo;
+struct HeroMovementProfile;
 enum class EHeroGender : int8_t;
 
 class DLL_LINKAGE CGHeroPlaceholder : public CGObjectInstance
@@ -60,6 +61,10 @@ private:
 	mutable int lowestCreatureSpeed;
 	ui32 movement; //remaining movement points
 
+	/// Movement profiles of this hero, indexed by turn. Not serialized, rebuilt on demand
+	mutable std::vector<std::shared_ptr<const HeroMovementProfile>> movementProfiles;
+	mutable boost::mutex movementProfilesMutex;
+
 public:
 
 	//////////////////////////////////////////////////////////////////////////
@@ -213,10 +218,13 @@ public:
 	void setMovementPoints(int points);
 	int movementPointsRemaining() const;
 	int movementPointsLimit(bool onLand) const;
-	//cached version is much faster, TurnInfo construction is costly
 	int movementPointsLimitCached(bool onLand, const TurnInfo * ti) const;
 	//update army movement bonus
-	void updateArmyMovementBonus(bool onLand, const TurnInfo * ti) const;
+	void updateArmyMovementBonus() const;
+
+	/// Returns snapshot of movement-related bonuses for specified turn
+	/// Cached profile is reused as long as bonus system tree remains unchanged, so this call is cheap and thread-safe
+	std::shared_ptr<const HeroMovementProfile> getMovementProfile(int turn = 0) const;
 
 	int movementPointsAfterEmbark(int MPsBefore, int basicCost, bool disembark = false, const TurnInfo * ti = nullptr) const;
 
@@ -99,12 +99,101 @@ void CCastleEvent::serializeJson(JsonSerializeFormat & handler)
 	}
 }
 
+TileObjectList::TileObjectList(const TileObjectList & other)
+{
+	if(other.objects)
+		objects = std::make_unique<TList>(*other.objects);
+}
+
+TileObjectList & TileObjectList::operator=(const TileObjectList & other)
+{
+	if(this != &other)
+		assign(other.list());
+	return *this;
+}
+
+const TileObjectList::TList & TileObjectList::list() const
+{
+	static const TList emptyList;
+
+	return objects ? *objects : emptyList;
+}
+
+void TileObjectList::assign(const TList & other)
+{
+	if(other.empty())
+		objects.reset();
+	else
+		objects = std::make_unique<TList>(other);
+}
+
+bool TileObjectList::empty() const
+{
+	return !objects;
+}
+
+TileObjectList::size_type TileObjectList::size() const
+{
+	return list().size();
+}
+
+TileObjectList::const_iterator TileObjectList::begin() const
+{
+	return list().begin();
+}
+
+TileObjectList::const_iterator TileObjectList::end() const
+{
+	return list().end();
+}
+
+CGObjectInstance * TileObjectList::front() const
+{
+	return list().front();
+}
+
+CGObjectInstance * TileObjectList::back() const
+{
+	return list().back();
+}
+
+CGObjectInstance * TileObjectList::operator[](size_type index) const
+{
+	return list()[index];
+}
+
+void TileObjectList::push_back(CGObjectInstance * object)
+{
+	if(!objects)
+		objects = std::make_unique<TList>();
+
+	objects->push_back(object);
+}
+
+bool TileObjectList::remove(const CGObjectInstance * object)
+{
+	if(!objects)
+		return false;
+
+	auto found = std::find(objects->begin(), objects->end(), object);
+
+	if(found == objects->end())
+		return false;
+
+	objects->erase(found);
+
+	if(objects->empty())
+		objects.reset();
+
+	return true;
+}
+
 TerrainTile::TerrainTile():
 	terType(nullptr),
-	terView(0),
 	riverType(VLC->riverTypeHandler->getById(River::NO_RIVER)),
-	riverDir(0),
 	roadType(VLC->roadTypeHandler->getById(Road::NO_ROAD)),
+	terView(0),
+	riverDir(0),
 	roadDir(0),
 	extTileFlags(0),
 	visitable(false),
@@ -207,14 +296,17 @@ void CMap::removeBlockVisTiles(CGObjectInstance * obj, bool total)
 			if(xVal>=0 && xVal < width && yVal>=0 && yVal < height)
 			{
 				TerrainTile & curt = terrain[zVal][xVal][yVal];
+				int3 tile(xVal, yVal, zVal);
 				if(total || obj->visitableAt(xVal, yVal))
 				{
-					curt.visitableObjects -= obj;
+					if(curt.visitableObjects.remove(obj))
+						unindexObject(obj, tile, true);
 					curt.visitable = curt.visitableObjects.size();
 				}
 				if(total || obj->blockingAt(xVal, yVal))
 				{
-					curt.blockingObjects -= obj;
+					if(curt.blockingObjects.remove(obj))
+						unindexObject(obj, tile, false);
 					curt.blocked = curt.blockingObjects.size();
 				}
 			}
@@ -234,36 +326,78 @@ void CMap::addBlockVisTiles(CGObjectInstance * obj)
 			if(xVal>=0 && xVal < width && yVal >= 0 && yVal < height)
 			{
 				TerrainTile & curt = terrain[zVal][xVal][yVal];
+				int3 tile(xVal, yVal, zVal);
 				if(obj->visitableAt(xVal, yVal))
 				{
 					curt.visitableObjects.push_back(obj);
 					curt.visitable = true;
+					indexObject(obj, tile, true);
 				}
 				if(obj->blockingAt(xVal, yVal))
 				{
 					curt.blockingObjects.push_back(obj);
 					curt.blocked = true;
+					indexObject(obj, tile, false);
 				}
 			}
 		}
 	}
 }
 
-void CMap::calculateGuardingGreaturePositions()
+void CMap::indexObject(CGObjectInstance * obj, const int3 & tile, bool visitable)
+{
+	if(!visitable)
+	{
+		objectIndex.add(obj, tile, MapObjectIndex::ELayer::BLOCKING);
+		return;
+	}
+
+	objectIndex.add(obj, tile, MapObjectIndex::ELayer::VISITABLE);
+
+	if(obj->ID == Obj::MONSTER)
+		objectIndex.add(obj, tile, MapObjectIndex::ELayer::GUARDS);
+}
+
+void CMap::unindexObject(const CGObjectInstance * obj, const int3 & tile, bool visitable)
+{
+	if(!visitable)
+	{
+		objectIndex.remove(obj, tile, MapObjectIndex::ELayer::BLOCKING);
+		return;
+	}
+
+	objectIndex.remove(obj, tile, MapObjectIndex::ELayer::VISITABLE);
+	// object type may have been changed since it was indexed, e.g. when random monster is picked
+	objectIndex.remove(obj, tile, MapObjectIndex::ELayer::GUARDS);
+}
+
+void CMap::rebuildObjectIndex()
 {
-	int levels = twoLevel ? 2 : 1;
-	for(int z = 0; z < levels; z++)
+	objectIndex.resize(width, height, levels());
+
+	for(int z = 0; z < levels(); z++)
 	{
 		for(int x = 0; x < width; x++)
 		{
 			for(int y = 0; y < height; y++)
 			{
-				guardingCreaturePositions[z][x][y] = guardingCreaturePosition(int3(x, y, z));
+				const TerrainTile & tile = terrain[z][x][y];
+
+				for(auto * obj : tile.visitableObjects)
+					indexObject(obj, int3(x, y, z), true);
+
+				for(auto * obj : tile.blockingObjects)
+					indexObject(obj, int3(x, y, z), false);
 			}
 		}
 	}
 }
 
+const MapObjectIndex & CMap::getObjectIndex() const
+{
+	return objectIndex;
+}
+
 CGHeroInstance * CMap::getHero(HeroTypeID heroID)
 {
 	for(auto & elem : heroesOnMap)
@@ -346,50 +480,36 @@ bool CMap::checkForVisitableDir(const int3 & src, const TerrainTile * pom, const
 
 int3 CMap::guardingCreaturePosition (int3 pos) const
 {
-	const int3 originalPos = pos;
-	// Give monster at position priority.
 	if (!isInTheMap(pos))
 		return int3(-1, -1, -1);
+
 	const TerrainTile &posTile = getTile(pos);
-	if (posTile.visitable)
+	bool water = posTile.isWater();
+	bool guardedByMonsterAtPos = false;
+	int3 result(-1, -1, -1);
+
+	objectIndex.forEachInRect(pos - int3(1, 1, 0), pos + int3(1, 1, 0), MapObjectIndex::ELayer::GUARDS, [&](const CGObjectInstance * obj, const int3 & tile)
 	{
-		for (CGObjectInstance* obj : posTile.visitableObjects)
+		// Give monster at position priority.
+		if (tile == pos)
 		{
-			if (obj->ID == Obj::MONSTER)
-				return pos;
+			guardedByMonsterAtPos = true;
+			return;
 		}
-	}
 
-	// See if there are any monsters adjacent.
-	bool water = posTile.isWater();
+		// Monster on adjacent tile must be able to attack investigated tile
+		if (getTile(tile).isWater() != water || !checkForVisitableDir(tile, &posTile, pos))
+			return;
 
-	pos -= int3(1, 1, 0); // Start with top left.
-	for (int dx = 0; dx < 3; dx++)
-	{
-		for (int dy = 0; dy < 3; dy++)
-		{
-			if (isInTheMap(pos))
-			{
-				const auto & tile = getTile(pos);
-                if (tile.visitable && (tile.isWater() == water))
-				{
-					for (CGObjectInstance* obj : tile.visitableObjects)
-					{
-						if (obj->ID == Obj::MONSTER  &&  checkForVisitableDir(pos, &posTile, originalPos)) // Monster being able to attack investigated tile
-						{
-							return pos;
-						}
-					}
-				}
-			}
+		// Out of several adjacent monsters, first one in column-major order from top left is selected
+		if (!result.valid() || tile.x < result.x || (tile.x == result.x && tile.y < result.y))
+			result = tile;
+	});
 
-			pos.y++;
-		}
-		pos.y -= 3;
-		pos.x++;
-	}
+	if (guardedByMonsterAtPos)
+		return pos;
 
-	return int3(-1, -1, -1);
+	return result;
 }
 
 const CGObjectInstance * CMap::getObjectiveObjectFrom(const int3 & pos, Obj type)
@@ -671,7 +791,7 @@ void CMap::unbanHero(const HeroTypeID & id)
 void CMap::initTerrain()
 {
 	terrain.resize(boost::extents[levels()][width][height]);
-	guardingCreaturePositions.resize(boost::extents[levels()][width][height]);
+	objectIndex.resize(width, height, levels());
 }
 
 CMapEditManager * CMap::getEditManager()
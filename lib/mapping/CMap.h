@@ -12,6 +12,7 @@
 
 #include "CMapDefines.h"
 #include "CMapHeader.h"
+#include "MapObjectIndex.h"
 
 #include "../ConstTransitivePtr.h"
 #include "../GameCallbackHolder.h"
@@ -94,7 +95,9 @@ public:
 
 	void addBlockVisTiles(CGObjectInstance * obj);
 	void removeBlockVisTiles(CGObjectInstance * obj, bool total = false);
-	void calculateGuardingGreaturePositions();
+
+	/// Spatial index of visitable, blocking and guarding objects, updated together with tile object lists
+	const MapObjectIndex & getObjectIndex() const;
 
 	void addNewArtifactInstance(ConstTransitivePtr<CArtifactInstance> art);
 	void eraseArtifactInstance(CArtifactInstance * art);
@@ -154,7 +157,6 @@ public:
 	std::map<si32, ObjectInstanceID> questIdentifierToId;
 
 	std::unique_ptr<CMapEditManager> editManager;
-	boost::multi_array<int3, 3> guardingCreaturePositions;
 
 	std::map<std::string, ConstTransitivePtr<CGObjectInstance> > instanceNames;
 
@@ -169,9 +171,14 @@ public:
 private:
 	/// a 3-dimensional array of terrain tiles, access is as follows: x, y, level. where level=1 is underground
 	boost::multi_array<TerrainTile, 3> terrain;
+	MapObjectIndex objectIndex;
 
 	si32 uidCounter; //TODO: initialize when loading an old map
 
+	void indexObject(CGObjectInstance * obj, const int3 & tile, bool visitable);
+	void unindexObject(const CGObjectInstance * obj, const int3 & tile, bool visitable);
+	void rebuildObjectIndex();
+
 public:
 	template <typename Handler>
 	void serialize(Handler &h)
@@ -198,7 +205,13 @@ public:
 
 		//TODO: viccondetails
 		h & terrain;
-		h & guardingCreaturePositions;
+
+		if (h.version < Handler::Version::MAP_OBJECT_INDEX)
+		{
+			// old save compatibility, guarded tiles are now found through object index
+			boost::multi_array<int3, 3> guardingCreaturePositions;
+			h & guardingCreaturePositions;
+		}
 
 		h & objects;
 		h & heroesOnMap;
@@ -213,6 +226,9 @@ public:
 		h & townUniversitySkills;
 
 		h & instanceNames;
+
+		if (!h.saving)
+			rebuildObjectIndex();
 	}
 };
 
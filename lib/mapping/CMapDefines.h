@@ -78,6 +78,56 @@ public:
 	void serializeJson(JsonSerializeFormat & handler) override;
 };
 
+/// List of objects located on a tile, with same read interface as std::vector.
+/// Most of map tiles have no objects, so list storage is allocated only for tiles that have any
+class DLL_LINKAGE TileObjectList
+{
+	using TList = std::vector<CGObjectInstance *>;
+
+	std::unique_ptr<TList> objects;
+
+	const TList & list() const;
+	void assign(const TList & other);
+
+public:
+	using const_iterator = TList::const_iterator;
+	using iterator = const_iterator;
+	using value_type = CGObjectInstance *;
+	using size_type = TList::size_type;
+
+	TileObjectList() = default;
+	TileObjectList(const TileObjectList & other);
+	TileObjectList(TileObjectList && other) noexcept = default;
+	TileObjectList & operator=(const TileObjectList & other);
+	TileObjectList & operator=(TileObjectList && other) noexcept = default;
+
+	bool empty() const;
+	size_type size() const;
+	const_iterator begin() const;
+	const_iterator end() const;
+	CGObjectInstance * front() const;
+	CGObjectInstance * back() const;
+	CGObjectInstance * operator[](size_type index) const;
+
+	void push_back(CGObjectInstance * object);
+	/// Removes object from list, returns false if object was not present
+	bool remove(const CGObjectInstance * object);
+
+	template <typename Handler>
+	void serialize(Handler & h)
+	{
+		TList value;
+
+		if (h.saving)
+			value = list();
+
+		h & value;
+
+		if (!h.saving)
+			assign(value);
+	}
+};
+
 /// The terrain tile describes the terrain type and the visual representation of the terrain.
 /// Furthermore the struct defines whether the tile is visitable or/and blocked and which objects reside in it.
 struct DLL_LINKAGE TerrainTile
@@ -96,11 +146,16 @@ struct DLL_LINKAGE TerrainTile
 	EDiggingStatus getDiggingStatus(const bool excludeTop = true) const;
 	bool hasFavorableWinds() const;
 
+	// pointers are placed before byte-sized fields to keep tile free of padding
 	const TerrainType * terType;
-	ui8 terView;
 	const RiverType * riverType;
-	ui8 riverDir;
 	const RoadType * roadType;
+
+	TileObjectList visitableObjects;
+	TileObjectList blockingObjects;
+
+	ui8 terView;
+	ui8 riverDir;
 	ui8 roadDir;
 	/// first two bits - how to rotate terrain graphic (next two - river graphic, next two - road);
 	///	7th bit - whether tile is coastal (allows disembarking if land or block movement if water); 8th bit - Favorable Winds effect
@@ -108,9 +163,6 @@ struct DLL_LINKAGE TerrainTile
 	bool visitable;
 	bool blocked;
 
-	std::vector<CGObjectInstance *> visitableObjects;
-	std::vector<CGObjectInstance *> blockingObjects;
-
 	template <typename Handler>
 	void serialize(Handler & h)
 	{
@@ -29,6 +29,7 @@
 #include "../VCMI_Lib.h"
 #include "../constants/StringConstants.h"
 #include "../filesystem/CBinaryReader.h"
+#include "../filesystem/CMemoryStream.h"
 #include "../filesystem/Filesystem.h"
 #include "../mapObjectConstructors/AObjectTypeHandler.h"
 #include "../mapObjectConstructors/CObjectClassesHandler.h"
@@ -92,21 +93,36 @@ std::unique_ptr<CMapHeader> CMapLoaderH3M::loadMapHeader()
 
 void CMapLoaderH3M::init()
 {
-	//TODO: get rid of double input process
-	si64 temp_size = inputStream->getSize();
+	// Read whole map once. Checksum is computed in background while map is parsed from memory
 	inputStream->seek(0);
+	mapData.resize(inputStream->getSize());
+	inputStream->read(mapData.data(), mapData.size());
 
-	auto * temp_buffer = new ui8[temp_size];
-	inputStream->read(temp_buffer, temp_size);
+	mapDataStream = std::make_unique<CMemoryStream>(mapData.data(), mapData.size());
+	reader = std::make_unique<MapReaderH3M>(mapDataStream.get());
 
-	// Compute checksum
-	boost::crc_32_type result;
-	result.process_bytes(temp_buffer, temp_size);
-	map->checksum = result.checksum();
+	boost::crc_32_type checksum;
+	boost::thread checksumThread([this, &checksum]()
+	{
+		checksum.process_bytes(mapData.data(), mapData.size());
+	});
 
-	delete[] temp_buffer;
-	inputStream->seek(0);
+	try
+	{
+		readContents();
+	}
+	catch(...)
+	{
+		checksumThread.join();
+		throw;
+	}
+
+	checksumThread.join();
+	map->checksum = checksum.checksum();
+}
 
+void CMapLoaderH3M::readContents()
+{
 	readHeader();
 	readDisposedHeroes();
 	readMapOptions();
@@ -119,7 +135,6 @@ void CMapLoaderH3M::init()
 	readObjects();
 	readEvents();
 
-	map->calculateGuardingGreaturePositions();
 	afterRead();
 	//map->banWaterContent(); //Not sure if force this for custom scenarios
 }
@@ -933,23 +948,28 @@ void CMapLoaderH3M::readTerrain()
 {
 	map->initTerrain();
 
-	// Read terrain
+	// Raw terrain of whole map is read in one pass and then decoded tile by tile
+	//OH3 format is [z][y][x], 7 bytes per tile
+	constexpr size_t tileRecordSize = 7;
+	std::vector<uint8_t> records(map->levels() * map->height * map->width * tileRecordSize);
+	reader->readBytes(records.data(), records.size());
+
+	const uint8_t * record = records.data();
 	int3 pos;
 	for(pos.z = 0; pos.z < map->levels(); ++pos.z)
 	{
-		//OH3 format is [z][y][x]
 		for(pos.y = 0; pos.y < map->height; pos.y++)
 		{
-			for(pos.x = 0; pos.x < map->width; pos.x++)
+			for(pos.x = 0; pos.x < map->width; pos.x++, record += tileRecordSize)
 			{
 				auto & tile = map->getTile(pos);
-				tile.terType = VLC->terrainTypeHandler->getById(reader->readTerrain());
-				tile.terView = reader->readUInt8();
-				tile.riverType = VLC->riverTypeHandler->getById(reader->readRiver());
-				tile.riverDir = reader->readUInt8();
-				tile.roadType = VLC->roadTypeHandler->getById(reader->readRoad());
-				tile.roadDir = reader->readUInt8();
-				tile.extTileFlags = reader->readUInt8();
+				tile.terType = VLC->terrainTypeHandler->getById(reader->decodeTerrain(record[0]));
+				tile.terView = record[1];
+				tile.riverType = VLC->riverTypeHandler->getById(reader->decodeRiver(record[2]));
+				tile.riverDir = record[3];
+				tile.roadType = VLC->roadTypeHandler->getById(reader->decodeRoad(record[4]));
+				tile.roadDir = record[5];
+				tile.extTileFlags = record[6];
 				tile.blocked = !tile.terType->isPassable();
 				tile.visitable = false;
 
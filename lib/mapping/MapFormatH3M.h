@@ -114,6 +114,11 @@ private:
 	 */
 	void init();
 
+	/**
+	 * Reads all sections of the map, in order in which they are stored in the file.
+	 */
+	void readContents();
+
 	/**
 	 * Reads the map header.
 	 */
@@ -289,6 +294,10 @@ private:
 	std::unique_ptr<MapReaderH3M> reader;
 	CInputStream * inputStream;
 
+	/// Whole decompressed map, read once when loading full map. Parsing is done from this buffer
+	std::vector<ui8> mapData;
+	std::unique_ptr<CInputStream> mapDataStream;
+
 	std::string mapName;
 	std::string modName;
 	std::string fileEncoding;
@@ -824,8 +824,6 @@ void CMapLoaderJson::readMap()
 	map->initTerrain();
 	readTerrain();
 	readObjects();
-
-	map->calculateGuardingGreaturePositions();
 }
 
 void CMapLoaderJson::readHeader(const bool complete)
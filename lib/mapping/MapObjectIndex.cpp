@@ -0,0 +1,104 @@
+/*
+ * MapObjectIndex.cpp, part of VCMI engine
+ *
+ * Authors: listed in file AUTHORS in main folder
+ *
+ * License: GNU General Public License v2.0 or later
+ * Full text of license available in license.txt file, in main folder
+ *
+ */
+#include "StdInc.h"
+#include "MapObjectIndex.h"
+
+#include "../mapObjects/CGObjectInstance.h"
+
+VCMI_LIB_NAMESPACE_BEGIN
+
+void MapObjectIndex::resize(int width, int height, int levels)
+{
+	this->width = width;
+	this->height = height;
+	this->levels = levels;
+
+	bucketsX = (width + BUCKET_SIZE - 1) / BUCKET_SIZE;
+	bucketsY = (height + BUCKET_SIZE - 1) / BUCKET_SIZE;
+
+	buckets.clear();
+	buckets.resize(bucketsX * bucketsY * levels);
+}
+
+void MapObjectIndex::clear()
+{
+	for(auto & bucket : buckets)
+	{
+		for(auto & entries : bucket.layers)
+			entries.clear();
+	}
+}
+
+MapObjectIndex::Bucket & MapObjectIndex::getBucket(const int3 & tile)
+{
+	assert(tile.x >= 0 && tile.x < width && tile.y >= 0 && tile.y < height && tile.z >= 0 && tile.z < levels);
+
+	return buckets[(tile.z * bucketsY + tile.y / BUCKET_SIZE) * bucketsX + tile.x / BUCKET_SIZE];
+}
+
+const MapObjectIndex::Bucket & MapObjectIndex::getBucket(int bucketX, int bucketY, int level) const
+{
+	return buckets[(level * bucketsY + bucketY) * bucketsX + bucketX];
+}
+
+void MapObjectIndex::add(CGObjectInstance * object, const int3 & tile, ELayer layer)
+{
+	getBucket(tile).layers[static_cast<int>(layer)].push_back(Entry{object, tile});
+}
+
+void MapObjectIndex::remove(const CGObjectInstance * object, const int3 & tile, ELayer layer)
+{
+	auto & entries = getBucket(tile).layers[static_cast<int>(layer)];
+
+	auto found = std::find_if(entries.begin(), entries.end(), [&](const Entry & entry)
+	{
+		return entry.object == object && entry.tile == tile;
+	});
+
+	if(found != entries.end())
+		entries.erase(found);
+}
+
+std::vector<CGObjectInstance *> MapObjectIndex::getObjectsInRect(const int3 & topLeft, const int3 & bottomRight, ELayer layer, const ObjectFilter & filter) const
+{
+	std::vector<CGObjectInstance *> result;
+
+	forEachInRect(topLeft, bottomRight, layer, [&](CGObjectInstance * object, const int3 & tile)
+	{
+		if(!vstd::contains(result, object) && (!filter || filter(object)))
+			result.push_back(object);
+	});
+
+	return result;
+}
+
+std::vector<CGObjectInstance *> MapObjectIndex::getObjectsInRadius(const int3 & center, int radius, ELayer layer, const ObjectFilter & filter) const
+{
+	std::vector<CGObjectInstance *> result;
+	const ui32 radiusSQ = radius * radius;
+
+	forEachInRect(center - int3(radius, radius, 0), center + int3(radius, radius, 0), layer, [&](CGObjectInstance * object, const int3 & tile)
+	{
+		if(center.dist2dSQ(tile) <= radiusSQ && !vstd::contains(result, object) && (!filter || filter(object)))
+			result.push_back(object);
+	});
+
+	return result;
+}
+
+std::vector<CGObjectInstance *> MapObjectIndex::getObjectsInRadius(const int3 & center, int radius, ELayer layer, MapObjectID type) const
+{
+	return getObjectsInRadius(center, radius, layer, [type](const CGObjectInstance * object)
+	{
+		return object->ID == type;
+	});
+}
+
+VCMI_LIB_NAMESPACE_END
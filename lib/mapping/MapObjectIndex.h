@@ -0,0 +1,108 @@
+/*
+ * MapObjectIndex.h, part of VCMI engine
+ *
+ * Authors: listed in file AUTHORS in main folder
+ *
+ * License: GNU General Public License v2.0 or later
+ * Full text of license available in license.txt file, in main folder
+ *
+ */
+
+#pragma once
+
+#include "../int3.h"
+#include "../constants/EntityIdentifiers.h"
+
+VCMI_LIB_NAMESPACE_BEGIN
+
+class CGObjectInstance;
+
+/// Spatial index of map objects, split into uniform grid of buckets on each map level.
+/// Object is stored in index once per each of its visitable or blocking tiles,
+/// so range queries only need to inspect buckets that overlap requested area.
+/// Maintained by CMap together with object lists of terrain tiles
+class DLL_LINKAGE MapObjectIndex
+{
+public:
+	enum class ELayer : ui8
+	{
+		VISITABLE,
+		BLOCKING,
+		GUARDS, /// visitable tiles of wandering monsters
+
+		COUNT
+	};
+
+	using ObjectFilter = std::function<bool(const CGObjectInstance *)>;
+
+	static constexpr int BUCKET_SIZE = 8;
+
+	void resize(int width, int height, int levels);
+	void clear();
+
+	void add(CGObjectInstance * object, const int3 & tile, ELayer layer);
+	void remove(const CGObjectInstance * object, const int3 & tile, ELayer layer);
+
+	/// Objects with at least one tile of selected layer in rectangle between corners (inclusive) on level of first corner
+	/// Each object is reported once, in order in which it was found
+	std::vector<CGObjectInstance *> getObjectsInRect(const int3 & topLeft, const int3 & bottomRight, ELayer layer, const ObjectFilter & filter = nullptr) const;
+	/// Objects with at least one tile of selected layer within radius (in terms of int3::dist2d) of center
+	std::vector<CGObjectInstance *> getObjectsInRadius(const int3 & center, int radius, ELayer layer, const ObjectFilter & filter = nullptr) const;
+	std::vector<CGObjectInstance *> getObjectsInRadius(const int3 & center, int radius, ELayer layer, MapObjectID type) const;
+
+	/// Calls callback(object, tile) for each indexed tile of selected layer in rectangle between corners (inclusive)
+	/// Object that occupies several tiles of rectangle is reported once per tile
+	template<typename Callback>
+	void forEachInRect(const int3 & topLeft, const int3 & bottomRight, ELayer layer, const Callback & callback) const
+	{
+		if(topLeft.z < 0 || topLeft.z >= levels)
+			return;
+
+		int minX = std::max(topLeft.x, 0);
+		int minY = std::max(topLeft.y, 0);
+		int maxX = std::min(bottomRight.x, width - 1);
+		int maxY = std::min(bottomRight.y, height - 1);
+
+		if(minX > maxX || minY > maxY)
+			return;
+
+		for(int bucketY = minY / BUCKET_SIZE; bucketY <= maxY / BUCKET_SIZE; bucketY++)
+		{
+			for(int bucketX = minX / BUCKET_SIZE; bucketX <= maxX / BUCKET_SIZE; bucketX++)
+			{
+				const auto & entries = getBucket(bucketX, bucketY, topLeft.z).layers[static_cast<int>(layer)];
+
+				for(const auto & entry : entries)
+				{
+					if(entry.tile.x >= minX && entry.tile.x <= maxX && entry.tile.y >= minY && entry.tile.y <= maxY)
+						callback(entry.object, entry.tile);
+				}
+			}
+		}
+	}
+
+private:
+	struct Entry
+	{
+		CGObjectInstance * object;
+		int3 tile;
+	};
+
+	struct Bucket
+	{
+		std::array<std::vector<Entry>, static_cast<int>(ELayer::COUNT)> layers;
+	};
+
+	int width = 0;
+	int height = 0;
+	int levels = 0;
+	int bucketsX = 0;
+	int bucketsY = 0;
+
+	std::vector<Bucket> buckets;
+
+	Bucket & getBucket(const int3 & tile);
+	const Bucket & getBucket(int bucketX, int bucketY, int level) const;
+};
+
+VCMI_LIB_NAMESPACE_END
@@ -164,21 +164,36 @@ CreatureID MapReaderH3M::readCreature()
 
 TerrainId MapReaderH3M::readTerrain()
 {
-	TerrainId result(readUInt8());
-	assert(result.getNum() < features.terrainsCount);
-	return remapIdentifier(result);
+	return decodeTerrain(readUInt8());
 }
 
 RoadId MapReaderH3M::readRoad()
 {
-	RoadId result(readInt8());
+	return decodeRoad(readUInt8());
+}
+
+RiverId MapReaderH3M::readRiver()
+{
+	return decodeRiver(readUInt8());
+}
+
+TerrainId MapReaderH3M::decodeTerrain(uint8_t value) const
+{
+	TerrainId result(value);
+	assert(result.getNum() < features.terrainsCount);
+	return remapper.remap(result);
+}
+
+RoadId MapReaderH3M::decodeRoad(uint8_t value) const
+{
+	RoadId result(static_cast<int8_t>(value));
 	assert(result.getNum() <= features.roadsCount);
 	return result;
 }
 
-RiverId MapReaderH3M::readRiver()
+RiverId MapReaderH3M::decodeRiver(uint8_t value) const
 {
-	RiverId result(readInt8());
+	RiverId result(static_cast<int8_t>(value));
 	assert(result.getNum() <= features.riversCount);
 	return result;
 }
@@ -415,6 +430,11 @@ int8_t MapReaderH3M::readInt8Checked(int8_t lowerLimit, int8_t upperLimit)
 	return std::clamp(result, lowerLimit, upperLimit);
 }
 
+void MapReaderH3M::readBytes(uint8_t * destination, size_t size)
+{
+	reader->read(destination, size);
+}
+
 uint8_t MapReaderH3M::readUInt8()
 {
 	return reader->readUInt8();
@@ -40,6 +40,11 @@ public:
 	TerrainId readTerrain();
 	RoadId readRoad();
 	RiverId readRiver();
+
+	/// Convert raw values that were read in bulk via readBytes, same as readTerrain / readRoad / readRiver
+	TerrainId decodeTerrain(uint8_t value) const;
+	RoadId decodeRoad(uint8_t value) const;
+	RiverId decodeRiver(uint8_t value) const;
 	PrimarySkill readPrimary();
 	SecondarySkill readSkill();
 	SpellID readSpell();
@@ -82,6 +87,9 @@ public:
 
 	std::string readBaseString();
 
+	/// Reads block of raw data, e.g. terrain of all map tiles
+	void readBytes(uint8_t * destination, size_t size);
+
 private:
 	template<class Identifier>
 	Identifier remapIdentifier(const Identifier & identifier);
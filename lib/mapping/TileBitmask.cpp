@@ -0,0 +1,229 @@
+/*
+ * TileBitmask.cpp, part of VCMI engine
+ *
+ * Authors: listed in file AUTHORS in main folder
+ *
+ * License: GNU General Public License v2.0 or later
+ * Full text of license available in license.txt file, in main folder
+ *
+ */
+#include "StdInc.h"
+#include "TileBitmask.h"
+
+VCMI_LIB_NAMESPACE_BEGIN
+
+TileBitmask::TileBitmask(const int3 & sizes)
+{
+	resize(sizes);
+}
+
+void TileBitmask::resize(const int3 & newSizes)
+{
+	sizes = newSizes;
+	wordsPerRow = (sizes.x + BITS_PER_WORD - 1) / BITS_PER_WORD;
+	words.assign(static_cast<size_t>(wordsPerRow) * sizes.y * sizes.z, 0);
+}
+
+TileBitmask::Word TileBitmask::lastWordMask() const
+{
+	int usedBits = sizes.x % BITS_PER_WORD;
+	if(usedBits == 0)
+		return ~Word(0);
+	return (Word(1) << usedBits) - 1;
+}
+
+void TileBitmask::fill(bool value)
+{
+	if(!value)
+	{
+		std::fill(words.begin(), words.end(), 0);
+		return;
+	}
+
+	std::fill(words.begin(), words.end(), ~Word(0));
+
+	// keep padding bits past end of each row cleared so count() and comparisons stay exact
+	Word mask = lastWordMask();
+	for(size_t last = wordsPerRow - 1; last < words.size(); last += wordsPerRow)
+		words[last] &= mask;
+}
+
+void TileBitmask::setSpan(int y, int z, int xFrom, int xTo, bool value)
+{
+	if(y < 0 || y >= sizes.y || z < 0 || z >= sizes.z)
+		return;
+
+	xFrom = std::max(xFrom, 0);
+	xTo = std::min(xTo, sizes.x - 1);
+	if(xFrom > xTo)
+		return;
+
+	Word * row = words.data() + rowOffset(y, z);
+	int firstWord = xFrom / BITS_PER_WORD;
+	int lastWord = xTo / BITS_PER_WORD;
+
+	for(int w = firstWord; w <= lastWord; ++w)
+	{
+		Word mask = ~Word(0);
+		if(w == firstWord)
+			mask &= ~Word(0) << (xFrom % BITS_PER_WORD);
+		if(w == lastWord)
+			mask &= ~Word(0) >> (BITS_PER_WORD - 1 - xTo % BITS_PER_WORD);
+
+		if(value)
+			row[w] |= mask;
+		else
+			row[w] &= ~mask;
+	}
+}
+
+void TileBitmask::setRange(const int3 & center, int radius, int3::EDistanceFormula formula, bool value)
+{
+	if(radius < 0)
+		return;
+
+	// offsets larger than map size are never inside the map. Also avoids overflows on "reveal entire map" radius
+	int halfWidth = std::min(radius, sizes.x);
+	int halfHeight = std::min(radius, sizes.y);
+
+	// width of the shape can only shrink when moving away from center row
+	for(int dy = 0; dy <= halfHeight; ++dy)
+	{
+		while(halfWidth >= 0 && static_cast<int>(int3(0, 0, 0).dist(int3(halfWidth, dy, 0), formula)) > radius)
+			--halfWidth;
+
+		if(halfWidth < 0)
+			break;
+
+		setSpan(center.y + dy, center.z, center.x - halfWidth, center.x + halfWidth, value);
+		if(dy != 0)
+			setSpan(center.y - dy, center.z, center.x - halfWidth, center.x + halfWidth, value);
+	}
+}
+
+TileBitmask & TileBitmask::operator|=(const TileBitmask & other)
+{
+	assert(sizes == other.sizes);
+	for(size_t i = 0; i < words.size(); ++i)
+		words[i] |= other.words[i];
+	return *this;
+}
+
+TileBitmask & TileBitmask::operator&=(const TileBitmask & other)
+{
+	assert(sizes == other.sizes);
+	for(size_t i = 0; i < words.size(); ++i)
+		words[i] &= other.words[i];
+	return *this;
+}
+
+void TileBitmask::subtract(const TileBitmask & other)
+{
+	assert(sizes == other.sizes);
+	for(size_t i = 0; i < words.size(); ++i)
+		words[i] &= ~other.words[i];
+}
+
+bool TileBitmask::none() const
+{
+	return std::all_of(words.begin(), words.end(), [](Word word){ return word == 0; });
+}
+
+size_t TileBitmask::count() const
+{
+	size_t result = 0;
+	for(Word word : words)
+	{
+		for(; word != 0; word &= word - 1)
+			++result;
+	}
+	return result;
+}
+
+std::unordered_set<int3> TileBitmask::toSet() const
+{
+	std::unordered_set<int3> result;
+	result.reserve(count());
+	forEach([&result](const int3 & tile)
+	{
+		result.insert(tile);
+	});
+	return result;
+}
+
+std::vector<ui32> TileBitmask::encodeRuns() const
+{
+	// Lengths of alternating runs of cleared and set tiles, starting from cleared run
+	// Tiles are enumerated row by row, same as in forEach
+	std::vector<ui32> runs;
+	bool current = false;
+	ui32 length = 0;
+
+	Word rowEndMask = lastWordMask();
+	for(int z = 0; z < sizes.z; ++z)
+	{
+		for(int y = 0; y < sizes.y; ++y)
+		{
+			const Word * row = words.data() + rowOffset(y, z);
+			for(int w = 0; w < wordsPerRow; ++w)
+			{
+				bool lastInRow = w == wordsPerRow - 1;
+				int bits = lastInRow ? sizes.x - w * BITS_PER_WORD : BITS_PER_WORD;
+				Word fullMask = lastInRow ? rowEndMask : ~Word(0);
+				Word word = row[w];
+
+				if((current && word == fullMask) || (!current && word == 0))
+				{
+					length += bits;
+					continue;
+				}
+
+				for(int bit = 0; bit < bits; ++bit)
+				{
+					bool value = (word >> bit) & 1;
+					if(value != current)
+					{
+						runs.push_back(length);
+						current = value;
+						length = 0;
+					}
+					++length;
+				}
+			}
+		}
+	}
+	runs.push_back(length);
+	return runs;
+}
+
+void TileBitmask::decodeRuns(const std::vector<ui32> & runs)
+{
+	resize(sizes);
+
+	size_t position = 0;
+	bool current = false;
+	const size_t totalTiles = static_cast<size_t>(sizes.x) * sizes.y * sizes.z;
+
+	for(ui32 length : runs)
+	{
+		size_t end = std::min(position + length, totalTiles);
+		if(current)
+		{
+			while(position < end)
+			{
+				int x = position % sizes.x;
+				size_t rowIndex = position / sizes.x;
+				int y = rowIndex % sizes.y;
+				int z = rowIndex / sizes.y;
+				int xTo = static_cast<int>(std::min<size_t>(sizes.x - 1, x + (end - position) - 1));
+
+				setSpan(y, z, x, xTo, true);
+				position += xTo - x + 1;
+			}
+		}
+		position = end;
+		current = !current;
+	}
+}
+
+VCMI_LIB_NAMESPACE_END
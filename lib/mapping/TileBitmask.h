@@ -0,0 +1,137 @@
+/*
+ * TileBitmask.h, part of VCMI engine
+ *
+ * Authors: listed in file AUTHORS in main folder
+ *
+ * License: GNU General Public License v2.0 or later
+ * Full text of license available in license.txt file, in main folder
+ *
+ */
+#pragma once
+
+#include "../int3.h"
+
+VCMI_LIB_NAMESPACE_BEGIN
+
+/// Bit-packed set of adventure map tiles, one bit per tile
+/// Every map row (y, z) is stored as a sequence of 64-bit words, so bulk operations work on whole words
+/// Serialized as run-length encoded stream of tiles, which keeps saves and network packs compact
+class DLL_LINKAGE TileBitmask
+{
+	using Word = uint64_t;
+	static constexpr int BITS_PER_WORD = 64;
+
+	int3 sizes;
+	int wordsPerRow = 0;
+	std::vector<Word> words;
+
+	size_t rowOffset(int y, int z) const
+	{
+		return (static_cast<size_t>(z) * sizes.y + y) * wordsPerRow;
+	}
+
+	/// Mask of bits in last word of a row that represent actual tiles
+	Word lastWordMask() const;
+
+	std::vector<ui32> encodeRuns() const;
+	void decodeRuns(const std::vector<ui32> & runs);
+
+public:
+	TileBitmask() = default;
+	explicit TileBitmask(const int3 & sizes);
+
+	/// Changes dimensions of the mask. All tiles will be cleared
+	void resize(const int3 & newSizes);
+	const int3 & size() const { return sizes; }
+
+	/// Sets or clears all tiles
+	void fill(bool value);
+
+	bool test(const int3 & tile) const
+	{
+		assert(isInside(tile));
+		return (words[rowOffset(tile.y, tile.z) + tile.x / BITS_PER_WORD] >> (tile.x % BITS_PER_WORD)) & 1;
+	}
+
+	void set(const int3 & tile, bool value = true)
+	{
+		assert(isInside(tile));
+		Word & word = words[rowOffset(tile.y, tile.z) + tile.x / BITS_PER_WORD];
+		Word bit = Word(1) << (tile.x % BITS_PER_WORD);
+		if(value)
+			word |= bit;
+		else
+			word &= ~bit;
+	}
+
+	bool isInside(const int3 & tile) const
+	{
+		return tile.x >= 0 && tile.y >= 0 && tile.z >= 0 && tile.x < sizes.x && tile.y < sizes.y && tile.z < sizes.z;
+	}
+
+	/// Sets or clears tiles [xFrom, xTo] in a single row. Range is clamped to map size
+	void setSpan(int y, int z, int xFrom, int xTo, bool value = true);
+
+	/// Sets or clears all tiles within given distance from center, as defined by int3::dist
+	void setRange(const int3 & center, int radius, int3::EDistanceFormula formula = int3::DIST_2D, bool value = true);
+
+	/// Adds all tiles from other mask. Both masks must have same size
+	TileBitmask & operator|=(const TileBitmask & other);
+	/// Keeps only tiles that are also present in other mask. Both masks must have same size
+	TileBitmask & operator&=(const TileBitmask & other);
+	/// Removes all tiles that are present in other mask. Both masks must have same size
+	void subtract(const TileBitmask & other);
+
+	/// Returns true if no tiles are set
+	bool none() const;
+	/// Returns number of set tiles
+	size_t count() const;
+
+	/// Converts mask to explicit list of tiles
+	std::unordered_set<int3> toSet() const;
+
+	/// Calls functor for every set tile, in row order
+	template<typename Func>
+	void forEach(const Func & functor) const
+	{
+		for(int z = 0; z < sizes.z; ++z)
+		{
+			for(int y = 0; y < sizes.y; ++y)
+			{
+				const Word * row = words.data() + rowOffset(y, z);
+				for(int w = 0; w < wordsPerRow; ++w)
+				{
+					Word word = row[w];
+					for(int bit = 0; word != 0; ++bit, word >>= 1)
+					{
+						if(word & 1)
+							functor(int3(w * BITS_PER_WORD + bit, y, z));
+					}
+				}
+			}
+		}
+	}
+
+	bool operator==(const TileBitmask & other) const
+	{
+		return sizes == other.sizes && words == other.words;
+	}
+
+	template <typename Handler> void serialize(Handler & h)
+	{
+		h & sizes;
+		if(h.saving)
+		{
+			std::vector<ui32> runs = encodeRuns();
+			h & runs;
+		}
+		else
+		{
+			std::vector<ui32> runs;
+			h & runs;
+			decodeRuns(runs);
+		}
+	}
+};
+
+VCMI_LIB_NAMESPACE_END
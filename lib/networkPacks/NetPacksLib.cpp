@@ -942,31 +942,32 @@ void FoWChange::applyGs(CGameState *gs)
 {
 	TeamState * team = gs->getPlayerTeam(player);
 	auto & fogOfWarMap = team->fogOfWarMap;
-	for(const int3 & t : tiles)
-		(*fogOfWarMap)[t.z][t.x][t.y] = mode != ETileVisibility::HIDDEN;
 
-	if (mode == ETileVisibility::HIDDEN) //do not hide too much
+	if (mode != ETileVisibility::HIDDEN)
 	{
-		std::unordered_set<int3> tilesRevealed;
-		for (auto & elem : gs->map->objects)
+		*fogOfWarMap |= tiles;
+		return;
+	}
+
+	fogOfWarMap->subtract(tiles);
+
+	//do not hide too much
+	for (auto & elem : gs->map->objects)
+	{
+		const CGObjectInstance *o = elem;
+		if (o)
 		{
-			const CGObjectInstance *o = elem;
-			if (o)
+			switch(o->ID.toEnum())
 			{
-				switch(o->ID.toEnum())
-				{
-				case Obj::HERO:
-				case Obj::MINE:
-				case Obj::TOWN:
-				case Obj::ABANDONED_MINE:
-					if(vstd::contains(team->players, o->tempOwner)) //check owned observators
-						gs->getTilesInRange(tilesRevealed, o->getSightCenter(), o->getSightRadius(), ETileVisibility::HIDDEN, o->tempOwner);
-					break;
-				}
+			case Obj::HERO:
+			case Obj::MINE:
+			case Obj::TOWN:
+			case Obj::ABANDONED_MINE:
+				if(vstd::contains(team->players, o->tempOwner)) //check owned observators
+					gs->getTilesInRange(*fogOfWarMap, o->getSightCenter(), o->getSightRadius(), ETileVisibility::REVEALED);
+				break;
 			}
 		}
-		for(const int3 & t : tilesRevealed) //probably not the most optimal solution ever
-			(*fogOfWarMap)[t.z][t.x][t.y] = 1;
 	}
 }
 
@@ -1231,7 +1232,6 @@ void RemoveObject::applyGs(CGameState *gs)
 
 	gs->map->instanceNames.erase(obj->instanceName);
 	gs->map->objects[objectID.getNum()].dellNull();
-	gs->map->calculateGuardingGreaturePositions();
 }
 
 static int getDir(const int3 & src, const int3 & dst)
@@ -1325,7 +1325,7 @@ void TryMoveHero::applyGs(CGameState *gs)
 
 	auto & fogOfWarMap = gs->getPlayerTeam(h->getOwner())->fogOfWarMap;
 	for(const int3 & t : fowRevealed)
-		(*fogOfWarMap)[t.z][t.x][t.y] = 1;
+		fogOfWarMap->set(t);
 }
 
 void NewStructures::applyGs(CGameState *gs)
@@ -1522,7 +1522,6 @@ void NewObject::applyGs(CGameState *gs)
 	gs->map->objects.emplace_back(o);
 	gs->map->addBlockVisTiles(o);
 	o->initObj(gs->getRandomGenerator());
-	gs->map->calculateGuardingGreaturePositions();
 
 	createdObjectID = o->id;
 
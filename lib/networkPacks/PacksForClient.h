@@ -26,6 +26,7 @@
 #include "../gameState/TavernSlot.h"
 #include "../int3.h"
 #include "../mapping/CMapDefines.h"
+#include "../mapping/TileBitmask.h"
 #include "../spells/ViewSpellInt.h"
 
 class CClient;
@@ -324,7 +325,7 @@ struct DLL_LINKAGE FoWChange : public CPackForClient
 {
 	void applyGs(CGameState * gs);
 
-	std::unordered_set<int3> tiles;
+	TileBitmask tiles;
 	PlayerColor player;
 	ETileVisibility mode;
 	bool waitForDialogs = false;
@@ -12,6 +12,7 @@
 #include "../TerrainHandler.h"
 #include "../mapObjects/CGObjectInstance.h"
 #include "../mapping/CMapDefines.h"
+#include "../mapping/TileBitmask.h"
 #include "../gameState/CGameState.h"
 #include "CGPathNode.h"
 
@@ -19,13 +20,13 @@ VCMI_LIB_NAMESPACE_BEGIN
 
 namespace PathfinderUtil
 {
-	using FoW = std::unique_ptr<boost::multi_array<ui8, 3>>;
+	using FoW = std::unique_ptr<TileBitmask>;
 	using ELayer = EPathfindingLayer;
 
 	template<EPathfindingLayer::Type layer>
 	EPathAccessibility evaluateAccessibility(const int3 & pos, const TerrainTile & tinfo, const FoW & fow, const PlayerColor player, const CGameState * gs)
 	{
-		if(!(*fow)[pos.z][pos.x][pos.y])
+		if(!fow->test(pos))
 			return EPathAccessibility::BLOCKED;
 
 		switch(layer)
@@ -18,32 +18,48 @@
 
 VCMI_LIB_NAMESPACE_BEGIN
 
-TurnInfo::BonusCache::BonusCache(const TConstBonusListPtr & bl)
+HeroMovementProfile::HeroMovementProfile(const CGHeroInstance * hero, int turn, int64_t treeVersion):
+	treeVersion(treeVersion),
+	turn(turn)
 {
+	bonuses = hero->getAllBonuses(Selector::days(turn), Selector::all, nullptr, "");
+	nativeTerrain = hero->getNativeTerrain();
+
+	freeShipBoarding = static_cast<bool>(bonuses->getFirst(Selector::type()(BonusType::FREE_SHIP_BOARDING)));
+	flyingMovement = static_cast<bool>(bonuses->getFirst(Selector::type()(BonusType::FLYING_MOVEMENT)));
+	flyingMovementVal = bonuses->valOfBonuses(Selector::type()(BonusType::FLYING_MOVEMENT));
+	waterWalking = static_cast<bool>(bonuses->getFirst(Selector::type()(BonusType::WATER_WALKING)));
+	waterWalkingVal = bonuses->valOfBonuses(Selector::type()(BonusType::WATER_WALKING));
+	pathfindingVal = bonuses->valOfBonuses(Selector::type()(BonusType::ROUGH_TERRAIN_DISCOUNT));
+	maxMovePointsLand = bonuses->valOfBonuses(Selector::typeSubtype(BonusType::MOVEMENT, BonusCustomSubtype::heroMovementLand));
+	maxMovePointsWater = bonuses->valOfBonuses(Selector::typeSubtype(BonusType::MOVEMENT, BonusCustomSubtype::heroMovementSea));
+
+	size_t terrainsCount = 0;
+	for(const auto & terrain : VLC->terrainTypeHandler->objects)
+		terrainsCount = std::max<size_t>(terrainsCount, terrain->getIndex() + 1);
+
+	noTerrainPenalty.resize(terrainsCount, false);
+	terrainMovementCost.resize(terrainsCount, GameConstants::BASE_MOVEMENT_COST);
+
 	for(const auto & terrain : VLC->terrainTypeHandler->objects)
 	{
-		auto selector = Selector::typeSubtype(BonusType::NO_TERRAIN_PENALTY, BonusSubtypeID(terrain->getId()));
-		if (bl->getFirst(selector))
-			noTerrainPenalty.insert(terrain->getId());
-	}
+		const TerrainId id = terrain->getId();
+		auto selector = Selector::typeSubtype(BonusType::NO_TERRAIN_PENALTY, BonusSubtypeID(id));
+		noTerrainPenalty[id.getNum()] = static_cast<bool>(bonuses->getFirst(selector));
+
+		if(nativeTerrain == id || nativeTerrain == ETerrainId::ANY_TERRAIN || noTerrainPenalty[id.getNum()])
+			continue;
 
-	freeShipBoarding = static_cast<bool>(bl->getFirst(Selector::type()(BonusType::FREE_SHIP_BOARDING)));
-	flyingMovement = static_cast<bool>(bl->getFirst(Selector::type()(BonusType::FLYING_MOVEMENT)));
-	flyingMovementVal = bl->valOfBonuses(Selector::type()(BonusType::FLYING_MOVEMENT));
-	waterWalking = static_cast<bool>(bl->getFirst(Selector::type()(BonusType::WATER_WALKING)));
-	waterWalkingVal = bl->valOfBonuses(Selector::type()(BonusType::WATER_WALKING));
-	pathfindingVal = bl->valOfBonuses(Selector::type()(BonusType::ROUGH_TERRAIN_DISCOUNT));
+		terrainMovementCost[id.getNum()] = std::max<int>(GameConstants::BASE_MOVEMENT_COST, terrain->moveCost - pathfindingVal);
+	}
 }
 
 TurnInfo::TurnInfo(const CGHeroInstance * Hero, const int turn):
 	hero(Hero),
-	maxMovePointsLand(-1),
-	maxMovePointsWater(-1),
 	turn(turn)
 {
-	bonuses = hero->getAllBonuses(Selector::days(turn), Selector::all, nullptr, "");
-	bonusCache = std::make_unique<BonusCache>(bonuses);
-	nativeTerrain = hero->getNativeTerrain();
+	profile = hero->getMovementProfile(turn);
+	nativeTerrain = profile->nativeTerrain;
 }
 
 bool TurnInfo::isLayerAvailable(const EPathfindingLayer & layer) const
@@ -82,17 +98,17 @@ bool TurnInfo::hasBonusOfType(BonusType type, BonusSubtypeID subtype) const
 	switch(type)
 	{
 	case BonusType::FREE_SHIP_BOARDING:
-		return bonusCache->freeShipBoarding;
+		return profile->freeShipBoarding;
 	case BonusType::FLYING_MOVEMENT:
-		return bonusCache->flyingMovement;
+		return profile->flyingMovement;
 	case BonusType::WATER_WALKING:
-		return bonusCache->waterWalking;
+		return profile->waterWalking;
 	case BonusType::NO_TERRAIN_PENALTY:
-		return bonusCache->noTerrainPenalty.count(subtype.as<TerrainId>());
+		return profile->hasNoTerrainPenalty(subtype.as<TerrainId>());
 	}
 
 	return static_cast<bool>(
-			bonuses->getFirst(Selector::type()(type).And(Selector::subtype()(subtype))));
+			profile->bonuses->getFirst(Selector::type()(type).And(Selector::subtype()(subtype))));
 }
 
 int TurnInfo::valOfBonuses(BonusType type) const
@@ -105,47 +121,24 @@ int TurnInfo::valOfBonuses(BonusType type, BonusSubtypeID subtype) const
 	switch(type)
 	{
 	case BonusType::FLYING_MOVEMENT:
-		return bonusCache->flyingMovementVal;
+		return profile->flyingMovementVal;
 	case BonusType::WATER_WALKING:
-		return bonusCache->waterWalkingVal;
+		return profile->waterWalkingVal;
 	case BonusType::ROUGH_TERRAIN_DISCOUNT:
-		return bonusCache->pathfindingVal;
+		return profile->pathfindingVal;
 	}
 
-	return bonuses->valOfBonuses(Selector::type()(type).And(Selector::subtype()(subtype)));
+	return profile->bonuses->valOfBonuses(Selector::type()(type).And(Selector::subtype()(subtype)));
 }
 
 int TurnInfo::getMaxMovePoints(const EPathfindingLayer & layer) const
 {
-	if(maxMovePointsLand == -1)
-		maxMovePointsLand = hero->movementPointsLimitCached(true, this);
-	if(maxMovePointsWater == -1)
-		maxMovePointsWater = hero->movementPointsLimitCached(false, this);
-
-	return layer == EPathfindingLayer::SAIL ? maxMovePointsWater : maxMovePointsLand;
+	return profile->getMaxMovePoints(layer);
 }
 
-void TurnInfo::updateHeroBonuses(BonusType type, const CSelector& sel) const
+ui32 TurnInfo::getTerrainMovementCost(TerrainId terrain) const
 {
-	switch(type)
-	{
-	case BonusType::FREE_SHIP_BOARDING:
-		bonusCache->freeShipBoarding = static_cast<bool>(bonuses->getFirst(Selector::type()(BonusType::FREE_SHIP_BOARDING)));
-		break;
-	case BonusType::FLYING_MOVEMENT:
-		bonusCache->flyingMovement = static_cast<bool>(bonuses->getFirst(Selector::type()(BonusType::FLYING_MOVEMENT)));
-		bonusCache->flyingMovementVal = bonuses->valOfBonuses(Selector::type()(BonusType::FLYING_MOVEMENT));
-		break;
-	case BonusType::WATER_WALKING:
-		bonusCache->waterWalking = static_cast<bool>(bonuses->getFirst(Selector::type()(BonusType::WATER_WALKING)));
-		bonusCache->waterWalkingVal = bonuses->valOfBonuses(Selector::type()(BonusType::WATER_WALKING));
-		break;
-	case BonusType::ROUGH_TERRAIN_DISCOUNT:
-		bonusCache->pathfindingVal = bonuses->valOfBonuses(Selector::type()(BonusType::ROUGH_TERRAIN_DISCOUNT));
-		break;
-	default:
-		bonuses = hero->getAllBonuses(Selector::days(turn), Selector::all, nullptr, "");
-	}
+	return profile->getTerrainMovementCost(terrain);
 }
 
 VCMI_LIB_NAMESPACE_END
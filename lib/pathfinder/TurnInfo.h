@@ -16,27 +16,57 @@ VCMI_LIB_NAMESPACE_BEGIN
 
 class CGHeroInstance;
 
+/// Snapshot of all hero bonuses that affect adventure map movement on specific turn
+/// Pathfinder makes hundreds of thousands of queries per hero, so everything it needs is precomputed here
+/// Profile is immutable once created and can be shared between threads.
+/// Heroes cache their profiles and rebuild them only when bonus tree version changes (see CGHeroInstance::getMovementProfile)
+struct DLL_LINKAGE HeroMovementProfile : boost::noncopyable
+{
+	/// Version of bonus system tree this profile was built for
+	int64_t treeVersion;
+	int turn;
+
+	TConstBonusListPtr bonuses;
+	TerrainId nativeTerrain;
+
+	bool freeShipBoarding;
+	bool flyingMovement;
+	int flyingMovementVal;
+	bool waterWalking;
+	int waterWalkingVal;
+	int pathfindingVal;
+	int maxMovePointsLand;
+	int maxMovePointsWater;
+
+	/// Indexed by TerrainId, true if hero has NO_TERRAIN_PENALTY bonus for this terrain
+	std::vector<uint8_t> noTerrainPenalty;
+	/// Indexed by TerrainId, cost of leaving tile of this terrain without road, with all penalties and discounts applied
+	std::vector<ui32> terrainMovementCost;
+
+	HeroMovementProfile(const CGHeroInstance * hero, int turn, int64_t treeVersion);
+
+	bool hasNoTerrainPenalty(TerrainId terrain) const
+	{
+		return terrain.getNum() >= 0 && terrain.getNum() < static_cast<int>(noTerrainPenalty.size()) && noTerrainPenalty[terrain.getNum()];
+	}
+
+	ui32 getTerrainMovementCost(TerrainId terrain) const
+	{
+		assert(terrain.getNum() >= 0 && terrain.getNum() < static_cast<int>(terrainMovementCost.size()));
+		return terrainMovementCost[terrain.getNum()];
+	}
+
+	int getMaxMovePoints(const EPathfindingLayer & layer) const
+	{
+		return layer == EPathfindingLayer::SAIL ? maxMovePointsWater : maxMovePointsLand;
+	}
+};
+
 struct DLL_LINKAGE TurnInfo
 {
-	/// This is certainly not the best design ever and certainly can be improved
-	/// Unfortunately for pathfinder that do hundreds of thousands calls onus system add too big overhead
-	struct BonusCache {
-		std::set<TerrainId> noTerrainPenalty;
-		bool freeShipBoarding;
-		bool flyingMovement;
-		int flyingMovementVal;
-		bool waterWalking;
-		int waterWalkingVal;
-		int pathfindingVal;
-
-		BonusCache(const TConstBonusListPtr & bonusList);
-	};
-	std::unique_ptr<BonusCache> bonusCache;
+	std::shared_ptr<const HeroMovementProfile> profile;
 
 	const CGHeroInstance * hero;
-	mutable TConstBonusListPtr bonuses;
-	mutable int maxMovePointsLand;
-	mutable int maxMovePointsWater;
 	TerrainId nativeTerrain;
 	int turn;
 
@@ -46,8 +76,9 @@ struct DLL_LINKAGE TurnInfo
 	bool hasBonusOfType(const BonusType type, const BonusSubtypeID subtype) const;
 	int valOfBonuses(const BonusType type) const;
 	int valOfBonuses(const BonusType type, const BonusSubtypeID subtype) const;
-	void updateHeroBonuses(BonusType type, const CSelector& sel) const;
 	int getMaxMovePoints(const EPathfindingLayer & layer) const;
+	/// Movement cost from tile of specified terrain without road
+	ui32 getTerrainMovementCost(TerrainId terrain) const;
 };
 
 VCMI_LIB_NAMESPACE_END
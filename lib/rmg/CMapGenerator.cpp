@@ -120,7 +120,6 @@ std::unique_ptr<CMap> CMapGenerator::generate()
 		initQuestArtsRemaining();
 		genZones();
 		Load::Progress::step();
-		map->getMap(this).calculateGuardingGreaturePositions(); //clear map so that all tiles are unguarded
 		map->addModificators();
 		Load::Progress::step(3);
 		fillZones();
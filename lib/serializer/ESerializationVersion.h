@@ -36,6 +36,8 @@ enum class ESerializationVersion : int32_t
 	HAS_EXTRA_OPTIONS, // 833 +extra options struct as part of startinfo
 	DESTROYED_OBJECTS, // 834 +list of objects destroyed by player
 	CAMPAIGN_MAP_TRANSLATIONS,
+	FOG_OF_WAR_BITMASK, // fog of war is stored as bit-packed mask
+	MAP_OBJECT_INDEX, // guarded tiles are no longer stored in map
 
-	CURRENT = CAMPAIGN_MAP_TRANSLATIONS
+	CURRENT = MAP_OBJECT_INDEX
 };
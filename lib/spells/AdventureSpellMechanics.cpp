@@ -611,7 +611,7 @@ ESpellCastResult ViewMechanics::applyAdventureEffects(SpellCastEnvironment * env
 		{
 			ObjectPosInfo posInfo(obj);
 
-			if((*fowMap)[posInfo.pos.z][posInfo.pos.x][posInfo.pos.y] == 0)
+			if(!fowMap->test(posInfo.pos))
 				pack.objectPositions.push_back(posInfo);
 		}
 	}
@@ -0,0 +1,242 @@
+/*
+ * DatabaseBenchmark.cpp, part of VCMI engine
+ *
+ * Authors: listed in file AUTHORS in main folder
+ *
+ * License: GNU General Public License v2.0 or later
+ * Full text of license available in license.txt file, in main folder
+ *
+ */
+#include "StdInc.h"
+
+#include "LobbyDatabase.h"
+
+#include "../lib/logging/CBasicLogConfigurator.h"
+#include "../lib/VCMIDirs.h"
+
+/// Replays lobby workload against database and reports number of processed messages per second
+///
+/// Usage:
+/// vcmilobbybenchmark                      - replay generated workload
+/// vcmilobbybenchmark <file>               - replay workload from file
+/// vcmilobbybenchmark --generate <file>    - write generated workload into file
+///
+/// Workload file contains one lobby message per line, in form of "<message> <accountID> [argument]":
+/// register, login, logout - account management
+/// chat <accountID> <text> - chat message from account
+/// openRoom, joinRoom, leaveRoom <accountID> <roomID> - game room management
+/// closeRoom <accountID> <roomID> - game room server disconnected
+
+struct WorkloadEntry
+{
+	std::string message;
+	std::string accountID;
+	std::string argument;
+};
+
+static std::vector<WorkloadEntry> generateWorkload(int accountsCount, int messagesCount)
+{
+	std::vector<WorkloadEntry> result;
+	std::mt19937 rng(12345);
+
+	auto accountName = [](int index){ return "account" + std::to_string(index); };
+
+	for(int i = 0; i < accountsCount; ++i)
+	{
+		result.push_back({"register", accountName(i), ""});
+		result.push_back({"login", accountName(i), ""});
+	}
+
+	std::uniform_int_distribution<int> accountDistribution(0, accountsCount - 1);
+	std::uniform_int_distribution<int> messageDistribution(0, 99);
+	int roomsCount = 0;
+
+	while(static_cast<int>(result.size()) < messagesCount)
+	{
+		std::string account = accountName(accountDistribution(rng));
+		int roll = messageDistribution(rng);
+
+		if(roll < 80)
+		{
+			result.push_back({"chat", account, "message number " + std::to_string(result.size())});
+		}
+		else if(roll < 90)
+		{
+			result.push_back({"logout", account, ""});
+			result.push_back({"login", account, ""});
+		}
+		else
+		{
+			std::string room = "room" + std::to_string(roomsCount++);
+			std::string guest = accountName(accountDistribution(rng));
+			result.push_back({"openRoom", account, room});
+			result.push_back({"joinRoom", guest, room});
+			result.push_back({"leaveRoom", guest, room});
+			result.push_back({"leaveRoom", account, room});
+			result.push_back({"closeRoom", account, room});
+		}
+	}
+
+	return result;
+}
+
+static std::vector<WorkloadEntry> loadWorkload(const boost::filesystem::path & path)
+{
+	std::vector<WorkloadEntry> result;
+	std::ifstream file(path.string());
+	std::string line;
+
+	while(std::getline(file, line))
+	{
+		std::istringstream stream(line);
+		WorkloadEntry entry;
+		stream >> entry.message >> entry.accountID;
+		std::getline(stream >> std::ws, entry.argument);
+
+		if(!entry.message.empty())
+			result.push_back(entry);
+	}
+	return result;
+}
+
+static void saveWorkload(const boost::filesystem::path & path, const std::vector<WorkloadEntry> & workload)
+{
+	std::ofstream file(path.string());
+	for(const auto & entry : workload)
+		file << entry.message << ' ' << entry.accountID << ' ' << entry.argument << '\n';
+}
+
+/// Performs same database requests as LobbyServer does when receiving this message
+static void replayMessage(LobbyDatabase & database, const WorkloadEntry & entry)
+{
+	const std::string & accountID = entry.accountID;
+	const std::string cookie = "cookie_" + accountID;
+
+	if(entry.message == "register")
+	{
+		if(database.isAccountNameExists(accountID))
+			return;
+		database.insertAccount(accountID, accountID);
+		database.insertAccessCookie(accountID, cookie);
+	}
+
+	if(entry.message == "login")
+	{
+		if(!database.isAccountIDExists(accountID))
+			return;
+		if(database.getAccountCookieStatus(accountID, cookie) == LobbyCookieStatus::INVALID)
+			return;
+		database.updateAccountLoginTime(accountID);
+		database.setAccountOnline(accountID, true);
+		database.getAccountDisplayName(accountID);
+		database.getActiveAccounts();
+		database.getRecentMessageHistory();
+		database.getActiveGameRooms();
+	}
+
+	if(entry.message == "logout")
+	{
+		database.setAccountOnline(accountID, false);
+		database.getActiveAccounts();
+		database.getActiveGameRooms();
+	}
+
+	if(entry.message == "chat")
+	{
+		database.getAccountDisplayName(accountID);
+		database.insertChatMessage(accountID, "global", "english", entry.argument);
+	}
+
+	if(entry.message == "openRoom")
+	{
+		database.insertGameRoom(entry.argument, accountID);
+		if(database.isPlayerInGameRoom(accountID))
+			return;
+		database.getIdleGameRoom(accountID);
+		database.setGameRoomStatus(entry.argument, LobbyRoomState::PUBLIC);
+		database.insertPlayerIntoGameRoom(accountID, entry.argument);
+		database.getActiveGameRooms();
+	}
+
+	if(entry.message == "joinRoom")
+	{
+		if(database.isPlayerInGameRoom(accountID))
+			return;
+		if(database.getGameRoomStatus(entry.argument) != LobbyRoomState::PUBLIC)
+			return;
+		if(database.getGameRoomFreeSlots(entry.argument) == 0)
+			return;
+		database.insertPlayerIntoGameRoom(accountID, entry.argument);
+		database.getActiveGameRooms();
+	}
+
+	if(entry.message == "leaveRoom")
+	{
+		if(!database.isPlayerInGameRoom(accountID, entry.argument))
+			return;
+		database.deletePlayerFromGameRoom(accountID, entry.argument);
+		database.getActiveGameRooms();
+	}
+
+	if(entry.message == "closeRoom")
+	{
+		database.setGameRoomStatus(entry.argument, LobbyRoomState::CLOSED);
+		database.getActiveAccounts();
+		database.getActiveGameRooms();
+	}
+}
+
+static void runBenchmark(const std::string & name, const std::vector<WorkloadEntry> & workload, bool commitEveryMessage)
+{
+	auto databasePath = boost::filesystem::temp_directory_path() / boost::filesystem::unique_path("vcmiLobbyBenchmark-%%%%%%%%.db");
+
+	{
+		LobbyDatabase database(databasePath);
+
+		auto timeStart = std::chrono::steady_clock::now();
+		for(const auto & entry : workload)
+		{
+			replayMessage(database, entry);
+			if(commitEveryMessage)
+				database.flush();
+		}
+		auto timeReplayed = std::chrono::steady_clock::now();
+		database.flush();
+		auto timeFlushed = std::chrono::steady_clock::now();
+
+		auto replayMs = std::chrono::duration_cast<std::chrono::milliseconds>(timeReplayed - timeStart).count();
+		auto totalMs = std::chrono::duration_cast<std::chrono::milliseconds>(timeFlushed - timeStart).count();
+
+		logGlobal->info("%s: %d messages, replayed in %d ms, committed in %d ms, %d messages per second",
+			name,
+			workload.size(),
+			replayMs,
+			totalMs,
+			workload.size() * 1000 / std::max<int64_t>(1, totalMs));
+	}
+
+	for(const auto & suffix : {"", "-wal", "-shm"})
+		boost::filesystem::remove(databasePath.string() + suffix);
+}
+
+int main(int argc, const char * argv[])
+{
+#ifndef VCMI_IOS
+	console = new CConsoleHandler();
+#endif
+	CBasicLogConfigurator logConfig(VCMIDirs::get().userLogsPath() / "VCMI_LobbyBenchmark_log.txt", console);
+	logConfig.configureDefault();
+
+	if(argc > 2 && std::string(argv[1]) == "--generate")
+	{
+		saveWorkload(argv[2], generateWorkload(500, 20000));
+		return 0;
+	}
+
+	std::vector<WorkloadEntry> workload = argc > 1 ? loadWorkload(argv[1]) : generateWorkload(500, 20000);
+
+	runBenchmark("Transaction per message", workload, true);
+	runBenchmark("Batched transactions", workload, false);
+
+	return 0;
+}
@@ -0,0 +1,277 @@
+/*
+ * LoadTest.cpp, part of VCMI engine
+ *
+ * Authors: listed in file AUTHORS in main folder
+ *
+ * License: GNU General Public License v2.0 or later
+ * Full text of license available in license.txt file, in main folder
+ *
+ */
+#include "StdInc.h"
+
+#include "../lib/json/JsonNode.h"
+#include "../lib/logging/CBasicLogConfigurator.h"
+#include "../lib/network/NetworkInterface.h"
+#include "../lib/VCMIDirs.h"
+
+#include <boost/uuid/uuid_generators.hpp>
+#include <boost/uuid/uuid_io.hpp>
+
+/// Simulates large number of headless lobby clients that register, log in and periodically reconnect
+/// Usage: vcmilobbyloadtest [clients] [duration, seconds] [reconnect interval, seconds, 0 to disable] [host] [port]
+
+struct LoadTestStatistics
+{
+	int connected = 0;
+	int loggedIn = 0;
+	int logins = 0;
+	int failures = 0;
+	uint64_t messagesReceived = 0;
+	uint64_t bytesReceived = 0;
+};
+
+struct LoadTestSettings
+{
+	int clientsCount = 1000;
+	int durationSeconds = 60;
+	int reconnectSeconds = 10;
+	std::string host = "127.0.0.1";
+	uint16_t port = 30303;
+};
+
+class LoadTestClient final : public INetworkClientListener, public INetworkTimerListener
+{
+	INetworkHandler & network;
+	const LoadTestSettings & settings;
+	LoadTestStatistics & statistics;
+
+	std::string accountName;
+	std::string accountID;
+	std::string accountCookie;
+	NetworkConnectionPtr connection;
+	bool loggedIn = false;
+	std::mt19937 rng;
+
+	void sendMessage(const JsonNode & json)
+	{
+		connection->sendPacket(json.toBytes(true));
+	}
+
+	void sendRegister()
+	{
+		JsonNode toSend;
+		toSend["type"].String() = "clientRegister";
+		toSend["displayName"].String() = accountName;
+		toSend["language"].String() = "english";
+		sendMessage(toSend);
+	}
+
+	void sendLogin()
+	{
+		JsonNode toSend;
+		toSend["type"].String() = "clientLogin";
+		toSend["accountID"].String() = accountID;
+		toSend["accountCookie"].String() = accountCookie;
+		toSend["language"].String() = "english";
+		toSend["version"].String() = "loadtest";
+		sendMessage(toSend);
+	}
+
+	void scheduleReconnect()
+	{
+		if(settings.reconnectSeconds == 0)
+			return;
+
+		// spread reconnects over time to produce steady stream of logins and logouts
+		std::uniform_int_distribution<int> distribution(settings.reconnectSeconds * 500, settings.reconnectSeconds * 1500);
+		network.createTimer(*this, std::chrono::milliseconds(distribution(rng)));
+	}
+
+	void onConnectionEstablished(const NetworkConnectionPtr & newConnection) override
+	{
+		connection = newConnection;
+		statistics.connected += 1;
+
+		if(accountID.empty())
+			sendRegister();
+		else
+			sendLogin();
+	}
+
+	void onConnectionFailed(const std::string & errorMessage) override
+	{
+		statistics.failures += 1;
+		logGlobal->warn("%s: connection failed: %s", accountName, errorMessage);
+	}
+
+	void onDisconnected(const NetworkConnectionPtr & oldConnection, const std::string & errorMessage) override
+	{
+		if(oldConnection != connection)
+			return; // closed by us during reconnect
+
+		statistics.connected -= 1;
+		if(loggedIn)
+			statistics.loggedIn -= 1;
+
+		connection.reset();
+		loggedIn = false;
+	}
+
+	void onPacketReceived(const NetworkConnectionPtr &, const std::vector<std::byte> & message) override
+	{
+		statistics.messagesReceived += 1;
+		statistics.bytesReceived += message.size();
+
+		JsonNode json(message.data(), message.size());
+		const std::string & messageType = json["type"].String();
+
+		if(messageType == "accountCreated")
+		{
+			accountID = json["accountID"].String();
+			accountCookie = json["accountCookie"].String();
+			sendLogin();
+		}
+
+		if(messageType == "loginSuccess")
+		{
+			loggedIn = true;
+			statistics.loggedIn += 1;
+			statistics.logins += 1;
+			scheduleReconnect();
+		}
+
+		if(messageType == "operationFailed")
+		{
+			statistics.failures += 1;
+			logGlobal->warn("%s: operation failed: %s", accountName, json["reason"].String());
+		}
+	}
+
+	void onTimer() override
+	{
+		if(connection)
+		{
+			statistics.connected -= 1;
+			if(loggedIn)
+				statistics.loggedIn -= 1;
+
+			connection->close();
+			connection.reset();
+			loggedIn = false;
+		}
+
+		network.connectToRemote(*this, settings.host, settings.port);
+	}
+
+public:
+	LoadTestClient(INetworkHandler & network, const LoadTestSettings & settings, LoadTestStatistics & statistics, const std::string & accountName, int seed)
+		: network(network)
+		, settings(settings)
+		, statistics(statistics)
+		, accountName(accountName)
+		, rng(seed)
+	{
+	}
+
+	void connect()
+	{
+		network.connectToRemote(*this, settings.host, settings.port);
+	}
+};
+
+class LoadTestReporter final : public INetworkTimerListener
+{
+	INetworkHandler & network;
+	const LoadTestSettings & settings;
+	const LoadTestStatistics & statistics;
+	LoadTestStatistics previous;
+	int secondsPassed = 0;
+
+	void onTimer() override
+	{
+		secondsPassed += 1;
+
+		logGlobal->info("%3ds: connected %d, logged in %d, logins %d, failures %d, messages %d/s, traffic %d KB/s",
+			secondsPassed,
+			statistics.connected,
+			statistics.loggedIn,
+			statistics.logins,
+			statistics.failures,
+			statistics.messagesReceived - previous.messagesReceived,
+			(statistics.bytesReceived - previous.bytesReceived) / 1024);
+
+		previous = statistics;
+
+		if(secondsPassed < settings.durationSeconds)
+		{
+			network.createTimer(*this, std::chrono::seconds(1));
+			return;
+		}
+
+		logGlobal->info("Total: %d logins, %d messages, %d KB received, %d failures",
+			statistics.logins,
+			statistics.messagesReceived,
+			statistics.bytesReceived / 1024,
+			statistics.failures);
+
+		if(statistics.logins != 0)
+			logGlobal->info("Average traffic per login: %d bytes", statistics.bytesReceived / statistics.logins);
+
+		network.stop();
+	}
+
+public:
+	LoadTestReporter(INetworkHandler & network, const LoadTestSettings & settings, const LoadTestStatistics & statistics)
+		: network(network)
+		, settings(settings)
+		, statistics(statistics)
+	{
+	}
+
+	void start()
+	{
+		network.createTimer(*this, std::chrono::seconds(1));
+	}
+};
+
+int main(int argc, const char * argv[])
+{
+#ifndef VCMI_IOS
+	console = new CConsoleHandler();
+#endif
+	CBasicLogConfigurator logConfig(VCMIDirs::get().userLogsPath() / "VCMI_LobbyLoadTest_log.txt", console);
+	logConfig.configureDefault();
+
+	LoadTestSettings settings;
+	if(argc > 1)
+		settings.clientsCount = std::stoi(argv[1]);
+	if(argc > 2)
+		settings.durationSeconds = std::stoi(argv[2]);
+	if(argc > 3)
+		settings.reconnectSeconds = std::stoi(argv[3]);
+	if(argc > 4)
+		settings.host = argv[4];
+	if(argc > 5)
+		settings.port = std::stoi(argv[5]);
+
+	logGlobal->info("Starting %d clients against %s:%d for %d seconds", settings.clientsCount, settings.host, settings.port, settings.durationSeconds);
+
+	auto network = INetworkHandler::createHandler();
+	LoadTestStatistics statistics;
+
+	// account names must be unique across runs since lobby database is persistent
+	std::string runPrefix = "lt" + boost::uuids::to_string(boost::uuids::random_generator()()).substr(0, 8);
+
+	std::vector<std::unique_ptr<LoadTestClient>> clients;
+	for(int i = 0; i < settings.clientsCount; ++i)
+	{
+		clients.push_back(std::make_unique<LoadTestClient>(*network, settings, statistics, runPrefix + std::to_string(i), i));
+		clients.back()->connect();
+	}
+
+	LoadTestReporter reporter(*network, settings, statistics);
+	reporter.start();
+
+	network->run();
+	return 0;
+}
@@ -12,6 +12,8 @@
 
 #include "SQLiteConnection.h"
 
+#include "../lib/CThreadHelper.h"
+
 void LobbyDatabase::createTables()
 {
 	static const std::string createChatMessages = R"(
@@ -71,12 +73,28 @@ void LobbyDatabase::createTables()
 		);
 	)";
 
+	// lookups by ID are done on every received message and would otherwise scan entire table
+	static const std::vector<std::string> createIndices = {
+		"CREATE INDEX IF NOT EXISTS chatMessagesCreationTime ON chatMessages(creationTime)",
+		"CREATE INDEX IF NOT EXISTS gameRoomsRoomID ON gameRooms(roomID)",
+		"CREATE INDEX IF NOT EXISTS gameRoomsStatus ON gameRooms(status)",
+		"CREATE INDEX IF NOT EXISTS gameRoomPlayersRoomID ON gameRoomPlayers(roomID)",
+		"CREATE INDEX IF NOT EXISTS gameRoomPlayersAccountID ON gameRoomPlayers(accountID)",
+		"CREATE INDEX IF NOT EXISTS accountsAccountID ON accounts(accountID)",
+		"CREATE INDEX IF NOT EXISTS accountsDisplayName ON accounts(displayName)",
+		"CREATE INDEX IF NOT EXISTS accountsOnline ON accounts(online)",
+		"CREATE INDEX IF NOT EXISTS accountCookiesAccountID ON accountCookies(accountID)",
+		"CREATE INDEX IF NOT EXISTS gameRoomInvitesAccountID ON gameRoomInvites(accountID)",
+	};
+
 	database->prepare(createChatMessages)->execute();
 	database->prepare(createTableGameRoomPlayers)->execute();
 	database->prepare(createTableGameRooms)->execute();
 	database->prepare(createTableAccounts)->execute();
 	database->prepare(createTableAccountCookies)->execute();
 	database->prepare(createTableGameRoomInvites)->execute();
+	for(const auto & index : createIndices)
+		database->prepare(index)->execute();
 }
 
 void LobbyDatabase::clearOldData()
@@ -97,8 +115,139 @@ void LobbyDatabase::clearOldData()
 	database->prepare(removeActiveRooms)->execute();
 }
 
+void LobbyDatabase::queueWrite(uint32_t tables, std::function<void()> && writeFunctor)
+{
+	boost::mutex::scoped_lock lock(writeQueueMutex);
+	writeQueue.push_back(std::move(writeFunctor));
+	writeQueueTables |= tables;
+	writeQueueCondition.notify_one();
+}
+
+void LobbyDatabase::commitWrites(const std::vector<std::function<void()>> & writes)
+{
+	beginTransactionStatement->execute();
+	beginTransactionStatement->reset();
+	try
+	{
+		for(const auto & write : writes)
+			write();
+		commitTransactionStatement->execute();
+		commitTransactionStatement->reset();
+	}
+	catch(const std::exception &)
+	{
+		rollbackTransactionStatement->execute();
+		rollbackTransactionStatement->reset();
+		throw;
+	}
+}
+
+void LobbyDatabase::commitQueuedWrites()
+{
+	std::vector<std::function<void()>> writesToCommit;
+	{
+		boost::mutex::scoped_lock lock(writeQueueMutex);
+		std::swap(writesToCommit, writeQueue);
+		writeQueueTables = 0;
+	}
+
+	if(writesToCommit.empty())
+		return;
+
+	try
+	{
+		commitWrites(writesToCommit);
+		return;
+	}
+	catch(const std::exception & e)
+	{
+		if(writesToCommit.size() == 1)
+		{
+			logGlobal->error("Failed to write change to database: %s", e.what());
+			return;
+		}
+		logGlobal->warn("Failed to write %d changes to database in single transaction: %s. Retrying them one by one", writesToCommit.size(), e.what());
+	}
+
+	// entire transaction was rolled back - retry each change separately so only changes that fail on their own are lost
+	for(const auto & write : writesToCommit)
+	{
+		try
+		{
+			commitWrites({write});
+		}
+		catch(const std::exception & e)
+		{
+			logGlobal->error("Failed to write change to database: %s", e.what());
+		}
+	}
+}
+
+boost::mutex::scoped_lock LobbyDatabase::lockForReading(uint32_t tables)
+{
+	boost::mutex::scoped_lock lock(databaseMutex);
+
+	bool hasQueuedWrites = false;
+	{
+		boost::mutex::scoped_lock queueLock(writeQueueMutex);
+		hasQueuedWrites = (writeQueueTables & tables) != 0;
+	}
+
+	if(hasQueuedWrites)
+		commitQueuedWrites();
+
+	return lock;
+}
+
+void LobbyDatabase::flush()
+{
+	boost::mutex::scoped_lock lock(databaseMutex);
+	commitQueuedWrites();
+}
+
+void LobbyDatabase::writerThreadLoop()
+{
+	setThreadName("lobbyDatabase");
+
+	for(;;)
+	{
+		bool terminating = false;
+		{
+			boost::mutex::scoped_lock lock(writeQueueMutex);
+			writeQueueCondition.wait(lock, [this](){ return writerTerminating || !writeQueue.empty(); });
+			terminating = writerTerminating;
+		}
+
+		// give caller some time to queue more changes so they can be committed in one transaction
+		if(!terminating)
+			boost::this_thread::sleep_for(boost::chrono::milliseconds(BATCH_INTERVAL.count()));
+
+		{
+			boost::mutex::scoped_lock lock(databaseMutex);
+			commitQueuedWrites();
+		}
+
+		if(terminating)
+			return;
+	}
+}
+
 void LobbyDatabase::prepareStatements()
 {
+	// TRANSACTIONS
+
+	static const std::string beginTransactionText = R"(
+		BEGIN TRANSACTION
+	)";
+
+	static const std::string commitTransactionText = R"(
+		COMMIT TRANSACTION
+	)";
+
+	static const std::string rollbackTransactionText = R"(
+		ROLLBACK TRANSACTION
+	)";
+
 	// INSERT INTO
 
 	static const std::string insertChatMessageText = R"(
@@ -257,6 +406,10 @@ void LobbyDatabase::prepareStatements()
 		WHERE displayName = ?
 	)";
 
+	beginTransactionStatement = database->prepare(beginTransactionText);
+	commitTransactionStatement = database->prepare(commitTransactionText);
+	rollbackTransactionStatement = database->prepare(rollbackTransactionText);
+
 	insertChatMessageStatement = database->prepare(insertChatMessageText);
 	insertAccountStatement = database->prepare(insertAccountText);
 	insertAccessCookieStatement = database->prepare(insertAccessCookieText);
@@ -288,23 +441,41 @@ void LobbyDatabase::prepareStatements()
 	isAccountNameExistsStatement = database->prepare(isAccountNameExistsText);
 }
 
-LobbyDatabase::~LobbyDatabase() = default;
+LobbyDatabase::~LobbyDatabase()
+{
+	{
+		boost::mutex::scoped_lock lock(writeQueueMutex);
+		writerTerminating = true;
+		writeQueueCondition.notify_one();
+	}
+	writerThread.join();
+}
 
 LobbyDatabase::LobbyDatabase(const boost::filesystem::path & databasePath)
 {
 	database = SQLiteInstance::open(databasePath, true);
+	// write-ahead log allows faster commits. Normal synchronization is sufficient for WAL and only risks losing last transactions on power loss
+	database->prepare("PRAGMA journal_mode = WAL")->execute();
+	database->prepare("PRAGMA synchronous = NORMAL")->execute();
 	createTables();
 	clearOldData();
 	prepareStatements();
+
+	writerThread = boost::thread(&LobbyDatabase::writerThreadLoop, this);
 }
 
 void LobbyDatabase::insertChatMessage(const std::string & sender, const std::string & roomType, const std::string & roomName, const std::string & messageText)
 {
-	insertChatMessageStatement->executeOnce(sender, messageText);
+	queueWrite(TABLE_CHAT_MESSAGES, [this, sender, messageText]()
+	{
+		insertChatMessageStatement->executeOnce(sender, messageText);
+	});
 }
 
 bool LobbyDatabase::isPlayerInGameRoom(const std::string & accountID)
 {
+	auto lock = lockForReading(TABLE_GAME_ROOMS | TABLE_GAME_ROOM_PLAYERS);
+
 	bool result = false;
 
 	isPlayerInAnyGameRoomStatement->setBinds(accountID);
@@ -317,6 +488,8 @@ bool LobbyDatabase::isPlayerInGameRoom(const std::string & accountID)
 
 bool LobbyDatabase::isPlayerInGameRoom(const std::string & accountID, const std::string & roomID)
 {
+	auto lock = lockForReading(TABLE_GAME_ROOMS | TABLE_GAME_ROOM_PLAYERS);
+
 	bool result = false;
 
 	isPlayerInGameRoomStatement->setBinds(accountID, roomID);
@@ -329,6 +502,8 @@ bool LobbyDatabase::isPlayerInGameRoom(const std::string & accountID, const std:
 
 std::vector<LobbyChatMessage> LobbyDatabase::getRecentMessageHistory()
 {
+	auto lock = lockForReading(TABLE_CHAT_MESSAGES | TABLE_ACCOUNTS);
+
 	std::vector<LobbyChatMessage> result;
 
 	while(getRecentMessageHistoryStatement->execute())
@@ -344,56 +519,88 @@ std::vector<LobbyChatMessage> LobbyDatabase::getRecentMessageHistory()
 
 void LobbyDatabase::setAccountOnline(const std::string & accountID, bool isOnline)
 {
-	setAccountOnlineStatement->executeOnce(isOnline ? 1 : 0, accountID);
+	queueWrite(TABLE_ACCOUNTS, [this, isOnline, accountID]()
+	{
+		setAccountOnlineStatement->executeOnce(isOnline ? 1 : 0, accountID);
+	});
 }
 
 void LobbyDatabase::setGameRoomStatus(const std::string & roomID, LobbyRoomState roomStatus)
 {
-	setGameRoomStatusStatement->executeOnce(vstd::to_underlying(roomStatus), roomID);
+	queueWrite(TABLE_GAME_ROOMS, [this, roomStatus, roomID]()
+	{
+		setGameRoomStatusStatement->executeOnce(vstd::to_underlying(roomStatus), roomID);
+	});
 }
 
 void LobbyDatabase::insertPlayerIntoGameRoom(const std::string & accountID, const std::string & roomID)
 {
-	insertGameRoomPlayersStatement->executeOnce(roomID, accountID);
+	queueWrite(TABLE_GAME_ROOM_PLAYERS, [this, roomID, accountID]()
+	{
+		insertGameRoomPlayersStatement->executeOnce(roomID, accountID);
+	});
 }
 
 void LobbyDatabase::deletePlayerFromGameRoom(const std::string & accountID, const std::string & roomID)
 {
-	deleteGameRoomPlayersStatement->executeOnce(roomID, accountID);
+	queueWrite(TABLE_GAME_ROOM_PLAYERS, [this, roomID, accountID]()
+	{
+		deleteGameRoomPlayersStatement->executeOnce(roomID, accountID);
+	});
 }
 
 void LobbyDatabase::deleteGameRoomInvite(const std::string & targetAccountID, const std::string & roomID)
 {
-	deleteGameRoomInvitesStatement->executeOnce(roomID, targetAccountID);
+	queueWrite(TABLE_GAME_ROOM_INVITES, [this, roomID, targetAccountID]()
+	{
+		deleteGameRoomInvitesStatement->executeOnce(roomID, targetAccountID);
+	});
 }
 
 void LobbyDatabase::insertGameRoomInvite(const std::string & targetAccountID, const std::string & roomID)
 {
-	insertGameRoomInvitesStatement->executeOnce(roomID, targetAccountID);
+	queueWrite(TABLE_GAME_ROOM_INVITES, [this, roomID, targetAccountID]()
+	{
+		insertGameRoomInvitesStatement->executeOnce(roomID, targetAccountID);
+	});
 }
 
 void LobbyDatabase::insertGameRoom(const std::string & roomID, const std::string & hostAccountID)
 {
-	insertGameRoomStatement->executeOnce(roomID, hostAccountID);
+	queueWrite(TABLE_GAME_ROOMS, [this, roomID, hostAccountID]()
+	{
+		insertGameRoomStatement->executeOnce(roomID, hostAccountID);
+	});
 }
 
 void LobbyDatabase::insertAccount(const std::string & accountID, const std::string & displayName)
 {
-	insertAccountStatement->executeOnce(accountID, displayName);
+	queueWrite(TABLE_ACCOUNTS, [this, accountID, displayName]()
+	{
+		insertAccountStatement->executeOnce(accountID, displayName);
+	});
 }
 
 void LobbyDatabase::insertAccessCookie(const std::string & accountID, const std::string & accessCookieUUID)
 {
-	insertAccessCookieStatement->executeOnce(accountID, accessCookieUUID);
+	queueWrite(TABLE_ACCOUNT_COOKIES, [this, accountID, accessCookieUUID]()
+	{
+		insertAccessCookieStatement->executeOnce(accountID, accessCookieUUID);
+	});
 }
 
 void LobbyDatabase::updateAccountLoginTime(const std::string & accountID)
 {
-	updateAccountLoginTimeStatement->executeOnce(accountID);
+	queueWrite(TABLE_ACCOUNTS, [this, accountID]()
+	{
+		updateAccountLoginTimeStatement->executeOnce(accountID);
+	});
 }
 
 std::string LobbyDatabase::getAccountDisplayName(const std::string & accountID)
 {
+	auto lock = lockForReading(TABLE_ACCOUNTS);
+
 	std::string result;
 
 	getAccountDisplayNameStatement->setBinds(accountID);
@@ -406,6 +613,8 @@ std::string LobbyDatabase::getAccountDisplayName(const std::string & accountID)
 
 LobbyCookieStatus LobbyDatabase::getAccountCookieStatus(const std::string & accountID, const std::string & accessCookieUUID)
 {
+	auto lock = lockForReading(TABLE_ACCOUNT_COOKIES);
+
 	bool result = false;
 
 	isAccountCookieValidStatement->setBinds(accountID, accessCookieUUID);
@@ -424,6 +633,8 @@ LobbyInviteStatus LobbyDatabase::getAccountInviteStatus(const std::string & acco
 
 LobbyRoomState LobbyDatabase::getGameRoomStatus(const std::string & roomID)
 {
+	auto lock = lockForReading(TABLE_GAME_ROOMS);
+
 	int result = -1;
 
 	getGameRoomStatusStatement->setBinds(roomID);
@@ -438,6 +649,8 @@ LobbyRoomState LobbyDatabase::getGameRoomStatus(const std::string & roomID)
 
 uint32_t LobbyDatabase::getGameRoomFreeSlots(const std::string & roomID)
 {
+	auto lock = lockForReading(TABLE_GAME_ROOMS | TABLE_GAME_ROOM_PLAYERS);
+
 	uint32_t usedSlots = 0;
 	uint32_t totalSlots = 0;
 
@@ -459,6 +672,8 @@ uint32_t LobbyDatabase::getGameRoomFreeSlots(const std::string & roomID)
 
 bool LobbyDatabase::isAccountNameExists(const std::string & displayName)
 {
+	auto lock = lockForReading(TABLE_ACCOUNTS);
+
 	bool result = false;
 
 	isAccountNameExistsStatement->setBinds(displayName);
@@ -470,6 +685,8 @@ bool LobbyDatabase::isAccountNameExists(const std::string & displayName)
 
 bool LobbyDatabase::isAccountIDExists(const std::string & accountID)
 {
+	auto lock = lockForReading(TABLE_ACCOUNTS);
+
 	bool result = false;
 
 	isAccountIDExistsStatement->setBinds(accountID);
@@ -481,6 +698,8 @@ bool LobbyDatabase::isAccountIDExists(const std::string & accountID)
 
 std::vector<LobbyGameRoom> LobbyDatabase::getActiveGameRooms()
 {
+	auto lock = lockForReading(TABLE_GAME_ROOMS | TABLE_GAME_ROOM_PLAYERS | TABLE_ACCOUNTS);
+
 	std::vector<LobbyGameRoom> result;
 
 	while(getActiveGameRoomsStatement->execute())
@@ -503,6 +722,8 @@ std::vector<LobbyGameRoom> LobbyDatabase::getActiveGameRooms()
 
 std::vector<LobbyAccount> LobbyDatabase::getActiveAccounts()
 {
+	auto lock = lockForReading(TABLE_ACCOUNTS);
+
 	std::vector<LobbyAccount> result;
 
 	while(getActiveAccountsStatement->execute())
@@ -517,6 +738,8 @@ std::vector<LobbyAccount> LobbyDatabase::getActiveAccounts()
 
 std::string LobbyDatabase::getIdleGameRoom(const std::string & hostAccountID)
 {
+	auto lock = lockForReading(TABLE_GAME_ROOMS);
+
 	std::string result;
 
 	getIdleGameRoomStatement->setBinds(hostAccountID);
@@ -529,6 +752,8 @@ std::string LobbyDatabase::getIdleGameRoom(const std::string & hostAccountID)
 
 std::string LobbyDatabase::getAccountGameRoom(const std::string & accountID)
 {
+	auto lock = lockForReading(TABLE_GAME_ROOMS | TABLE_GAME_ROOM_PLAYERS);
+
 	std::string result;
 
 	getAccountGameRoomStatement->setBinds(accountID);
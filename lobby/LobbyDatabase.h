@@ -11,16 +11,49 @@
 
 #include "LobbyDefines.h"
 
+#include <boost/thread/condition_variable.hpp>
+
 class SQLiteInstance;
 class SQLiteStatement;
 
 using SQLiteInstancePtr = std::unique_ptr<SQLiteInstance>;
 using SQLiteStatementPtr = std::unique_ptr<SQLiteStatement>;
 
+/// All modifications are queued and written in batched transactions by dedicated database thread
+/// Queries that read tables with queued modifications commit them first, so reads always see latest state
 class LobbyDatabase
 {
+	/// Bitmask of tables affected by queued modifications
+	enum TableMask : uint32_t
+	{
+		TABLE_CHAT_MESSAGES = 1 << 0,
+		TABLE_ACCOUNTS = 1 << 1,
+		TABLE_ACCOUNT_COOKIES = 1 << 2,
+		TABLE_GAME_ROOMS = 1 << 3,
+		TABLE_GAME_ROOM_PLAYERS = 1 << 4,
+		TABLE_GAME_ROOM_INVITES = 1 << 5,
+	};
+
+	/// Interval during which writer thread accumulates modifications before committing them
+	static constexpr std::chrono::milliseconds BATCH_INTERVAL{20};
+
 	SQLiteInstancePtr database;
 
+	/// Protects database connection and all statements
+	boost::mutex databaseMutex;
+
+	/// Protects queue of modifications
+	boost::mutex writeQueueMutex;
+	boost::condition_variable writeQueueCondition;
+	std::vector<std::function<void()>> writeQueue;
+	uint32_t writeQueueTables = 0;
+	bool writerTerminating = false;
+	boost::thread writerThread;
+
+	SQLiteStatementPtr beginTransactionStatement;
+	SQLiteStatementPtr commitTransactionStatement;
+	SQLiteStatementPtr rollbackTransactionStatement;
+
 	SQLiteStatementPtr insertChatMessageStatement;
 	SQLiteStatementPtr insertAccountStatement;
 	SQLiteStatementPtr insertAccessCookieStatement;
@@ -56,10 +89,23 @@ class LobbyDatabase
 	void createTables();
 	void clearOldData();
 
+	/// Adds modification to write queue. Statements must only be accessed from within provided functor
+	void queueWrite(uint32_t tables, std::function<void()> && writeFunctor);
+	/// Executes provided modifications in single transaction. Rolls back transaction and rethrows if any of them fails
+	void commitWrites(const std::vector<std::function<void()>> & writes);
+	/// Commits all queued modifications in single transaction, or one by one if transaction fails. Requires locked databaseMutex
+	void commitQueuedWrites();
+	/// Locks database for reading from specified tables, committing queued modifications to these tables, if any
+	boost::mutex::scoped_lock lockForReading(uint32_t tables);
+	void writerThreadLoop();
+
 public:
 	explicit LobbyDatabase(const boost::filesystem::path & databasePath);
 	~LobbyDatabase();
 
+	/// Blocks until all queued modifications are written to database
+	void flush();
+
 	void setAccountOnline(const std::string & accountID, bool isOnline);
 	void setGameRoomStatus(const std::string & roomID, LobbyRoomState roomStatus);
 
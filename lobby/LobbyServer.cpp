@@ -117,33 +117,72 @@ void LobbyServer::sendChatHistory(const NetworkConnectionPtr & target, const std
 	sendMessage(target, reply);
 }
 
-void LobbyServer::broadcastActiveAccounts()
+void LobbyServer::broadcastMessage(const JsonNode & json)
 {
-	auto activeAccountsStats = database->getActiveAccounts();
+	auto payload = json.toBytes(true);
 
-	JsonNode reply;
-	reply["type"].String() = "activeAccounts";
+	for(const auto & connection : activeAccounts)
+		connection.first->sendPacket(payload);
+}
+
+/// Writes entries that were added or changed into update[listName] and IDs of removed entries into update["removed"]
+/// Returns true if lists are different
+static bool prepareListChanges(const std::map<std::string, JsonNode> & oldList, const std::map<std::string, JsonNode> & newList, const std::string & listName, JsonNode & update)
+{
+	bool changed = false;
 
-	for(const auto & account : activeAccountsStats)
+	for(const auto & entry : newList)
+	{
+		auto it = oldList.find(entry.first);
+		if(it != oldList.end() && it->second == entry.second)
+			continue;
+
+		update[listName].Vector().push_back(entry.second);
+		changed = true;
+	}
+
+	for(const auto & entry : oldList)
+	{
+		if(newList.count(entry.first))
+			continue;
+
+		JsonNode removedID;
+		removedID.String() = entry.first;
+		update["removed"].Vector().push_back(removedID);
+		changed = true;
+	}
+
+	return changed;
+}
+
+void LobbyServer::updateActiveAccounts()
+{
+	std::map<std::string, JsonNode> currentAccounts;
+
+	for(const auto & account : database->getActiveAccounts())
 	{
 		JsonNode jsonEntry;
 		jsonEntry["accountID"].String() = account.accountID;
 		jsonEntry["displayName"].String() = account.displayName;
 		jsonEntry["status"].String() = "In Lobby"; // TODO: in room status, in match status, offline status(?)
-		reply["accounts"].Vector().push_back(jsonEntry);
+		currentAccounts[account.accountID] = jsonEntry;
 	}
 
-	for(const auto & connection : activeAccounts)
-		sendMessage(connection.first, reply);
+	JsonNode update;
+	if(prepareListChanges(knownAccounts, currentAccounts, "accounts", update))
+	{
+		update["type"].String() = "activeAccountsChanged";
+		broadcastMessage(update);
+	}
+
+	knownAccounts = std::move(currentAccounts);
 }
 
-JsonNode LobbyServer::prepareActiveGameRooms()
+void LobbyServer::updateActiveGameRooms()
 {
-	auto activeGameRoomStats = database->getActiveGameRooms();
-	JsonNode reply;
-	reply["type"].String() = "activeGameRooms";
+	std::map<std::string, JsonNode> currentGameRooms;
 
-	for(const auto & gameRoom : activeGameRoomStats)
+	for(const auto & gameRoom : database->getActiveGameRooms())
 	{
 		JsonNode jsonEntry;
 		jsonEntry["gameRoomID"].String() = gameRoom.roomID;
@@ -152,18 +191,41 @@ JsonNode LobbyServer::prepareActiveGameRooms()
 		jsonEntry["description"].String() = "TODO: ROOM DESCRIPTION";
 		jsonEntry["playersCount"].Integer() = gameRoom.playersCount;
 		jsonEntry["playersLimit"].Integer() = gameRoom.playersLimit;
-		reply["gameRooms"].Vector().push_back(jsonEntry);
+		currentGameRooms[gameRoom.roomID] = jsonEntry;
+	}
+
+	JsonNode update;
+	if(prepareListChanges(knownGameRooms, currentGameRooms, "gameRooms", update))
+	{
+		update["type"].String() = "activeGameRoomsChanged";
+		broadcastMessage(update);
 	}
 
+	knownGameRooms = std::move(currentGameRooms);
+}
+
+JsonNode LobbyServer::prepareActiveAccounts() const
+{
+	JsonNode reply;
+	reply["type"].String() = "activeAccounts";
+	reply["accounts"].setType(JsonNode::JsonType::DATA_VECTOR);
+
+	for(const auto & account : knownAccounts)
+		reply["accounts"].Vector().push_back(account.second);
+
 	return reply;
 }
 
-void LobbyServer::broadcastActiveGameRooms()
+JsonNode LobbyServer::prepareActiveGameRooms() const
 {
-	auto reply = prepareActiveGameRooms();
+	JsonNode reply;
+	reply["type"].String() = "activeGameRooms";
+	reply["gameRooms"].setType(JsonNode::JsonType::DATA_VECTOR);
 
-	for(const auto & connection : activeAccounts)
-		sendMessage(connection.first, reply);
+	for(const auto & gameRoom : knownGameRooms)
+		reply["gameRooms"].Vector().push_back(gameRoom.second);
+
+	return reply;
 }
 
 void LobbyServer::sendAccountJoinsRoom(const NetworkConnectionPtr & target, const std::string & accountID)
@@ -183,7 +245,7 @@ void LobbyServer::sendJoinRoomSuccess(const NetworkConnectionPtr & target, const
 	sendMessage(target, reply);
 }
 
-void LobbyServer::sendChatMessage(const NetworkConnectionPtr & target, const std::string & roomMode, const std::string & roomName, const std::string & accountID, const std::string & displayName, const std::string & messageText)
+void LobbyServer::broadcastChatMessage(const std::string & roomMode, const std::string & roomName, const std::string & accountID, const std::string & displayName, const std::string & messageText)
 {
 	JsonNode reply;
 	reply["type"].String() = "chatMessage";
@@ -193,7 +255,7 @@ void LobbyServer::sendChatMessage(const NetworkConnectionPtr & target, const std
 	reply["roomMode"].String() = roomMode;
 	reply["roomName"].String() = roomName;
 
-	sendMessage(target, reply);
+	broadcastMessage(reply);
 }
 
 void LobbyServer::onNewConnection(const NetworkConnectionPtr & connection)
@@ -226,8 +288,8 @@ void LobbyServer::onDisconnected(const NetworkConnectionPtr & connection, const
 		activeProxies.erase(otherConnection);
 	}
 
-	broadcastActiveAccounts();
-	broadcastActiveGameRooms();
+	updateActiveAccounts();
+	updateActiveGameRooms();
 }
 
 void LobbyServer::onPacketReceived(const NetworkConnectionPtr & connection, const std::vector<std::byte> & message)
@@ -321,8 +383,7 @@ void LobbyServer::receiveSendChatMessage(const NetworkConnectionPtr & connection
 
 	database->insertChatMessage(accountID, "global", "english", messageText);
 
-	for(const auto & otherConnection : activeAccounts)
-		sendChatMessage(otherConnection.first, "global", "english", accountID, displayName, messageText);
+	broadcastChatMessage("global", "english", accountID, displayName, messageText);
 }
 
 void LobbyServer::receiveClientRegister(const NetworkConnectionPtr & connection, const JsonNode & json)
@@ -330,7 +391,7 @@ void LobbyServer::receiveClientRegister(const NetworkConnectionPtr & connection,
 	std::string displayName = json["displayName"].String();
 	std::string language = json["language"].String();
 
-	if(isAccountNameValid(displayName))
+	if(!isAccountNameValid(displayName))
 		return sendOperationFailed(connection, "Illegal account name");
 
 	if(database->isAccountNameExists(displayName))
@@ -365,14 +426,16 @@ void LobbyServer::receiveClientLogin(const NetworkConnectionPtr & connection, co
 
 	std::string displayName = database->getAccountDisplayName(accountID);
 
+	// notify everybody else about new account before adding it to list of active accounts
+	updateActiveAccounts();
+
 	activeAccounts[connection] = accountID;
 
 	sendLoginSuccess(connection, accountCookie, displayName);
 	sendChatHistory(connection, database->getRecentMessageHistory());
 
-	// send active game rooms list to new account
-	// and update acount list to everybody else including new account
-	broadcastActiveAccounts();
+	// new account receives full lists and will only get changes from now on
+	sendMessage(connection, prepareActiveAccounts());
 	sendMessage(connection, prepareActiveGameRooms());
 }
 
@@ -394,7 +457,7 @@ void LobbyServer::receiveServerLogin(const NetworkConnectionPtr & connection, co
 		database->insertGameRoom(gameRoomID, accountID);
 		activeGameRooms[connection] = gameRoomID;
 		sendLoginSuccess(connection, accountCookie, {});
-		broadcastActiveGameRooms();
+		updateActiveGameRooms();
 	}
 }
 
@@ -486,7 +549,7 @@ void LobbyServer::receiveOpenGameRoom(const NetworkConnectionPtr & connection, c
 		database->setGameRoomStatus(gameRoomID, LobbyRoomState::PRIVATE);
 
 	database->insertPlayerIntoGameRoom(accountID, gameRoomID);
-	broadcastActiveGameRooms();
+	updateActiveGameRooms();
 	sendJoinRoomSuccess(connection, gameRoomID, false);
 }
 
@@ -521,7 +584,7 @@ void LobbyServer::receiveJoinGameRoom(const NetworkConnectionPtr & connection, c
 	sendAccountJoinsRoom(targetRoom, accountID);
 	//No reply to client - will be sent once match server establishes proxy connection with lobby
 
-	broadcastActiveGameRooms();
+	updateActiveGameRooms();
 }
 
 void LobbyServer::receiveLeaveGameRoom(const NetworkConnectionPtr & connection, const JsonNode & json)
@@ -534,7 +597,7 @@ void LobbyServer::receiveLeaveGameRoom(const NetworkConnectionPtr & connection,
 
 	database->deletePlayerFromGameRoom(accountID, gameRoomID);
 
-	broadcastActiveGameRooms();
+	updateActiveGameRooms();
 }
 
 void LobbyServer::receiveSendInvite(const NetworkConnectionPtr & connection, const JsonNode & json)
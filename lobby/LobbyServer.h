@@ -12,9 +12,7 @@
 #include "../lib/network/NetworkInterface.h"
 #include "LobbyDefines.h"
 
-VCMI_LIB_NAMESPACE_BEGIN
-class JsonNode;
-VCMI_LIB_NAMESPACE_END
+#include "../lib/json/JsonNode.h"
 
 class LobbyDatabase;
 
@@ -40,6 +38,11 @@ class LobbyServer final : public INetworkServerListener
 	/// list of currently logged in game rooms (vcmiserver's)
 	std::map<NetworkConnectionPtr, std::string> activeGameRooms;
 
+	/// accounts and game rooms as they are currently known to logged in clients, by account or room ID
+	/// Clients receive full list on login and only changes to these lists afterwards
+	std::map<std::string, JsonNode> knownAccounts;
+	std::map<std::string, JsonNode> knownGameRooms;
+
 	std::unique_ptr<LobbyDatabase> database;
 	std::unique_ptr<INetworkHandler> networkHandler;
 	std::unique_ptr<INetworkServer> networkServer;
@@ -55,13 +58,17 @@ class LobbyServer final : public INetworkServerListener
 	void onPacketReceived(const NetworkConnectionPtr & connection, const std::vector<std::byte> & message) override;
 
 	void sendMessage(const NetworkConnectionPtr & target, const JsonNode & json);
+	/// Sends message to all logged in accounts. Message is serialized only once
+	void broadcastMessage(const JsonNode & json);
 
-	void broadcastActiveAccounts();
-	void broadcastActiveGameRooms();
+	/// Compares lists in database with lists known to clients and broadcasts changes, if any
+	void updateActiveAccounts();
+	void updateActiveGameRooms();
 
-	JsonNode prepareActiveGameRooms();
+	JsonNode prepareActiveAccounts() const;
+	JsonNode prepareActiveGameRooms() const;
 
-	void sendChatMessage(const NetworkConnectionPtr & target, const std::string & roomMode, const std::string & roomName, const std::string & accountID, const std::string & displayName, const std::string & messageText);
+	void broadcastChatMessage(const std::string & roomMode, const std::string & roomName, const std::string & accountID, const std::string & displayName, const std::string & messageText);
 	void sendAccountCreated(const NetworkConnectionPtr & target, const std::string & accountID, const std::string & accountCookie);
 	void sendOperationFailed(const NetworkConnectionPtr & target, const std::string & reason);
 	void sendLoginSuccess(const NetworkConnectionPtr & target, const std::string & accountCookie, const std::string & displayName);
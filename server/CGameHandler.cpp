@@ -872,14 +872,9 @@ void CGameHandler::onNewTurn()
 				fw.mode = ETileVisibility::REVEALED;
 				fw.player = player;
 				// find all hidden tiles
-				const auto & fow = getPlayerTeam(player)->fogOfWarMap;
-
-				auto shape = fow->shape();
-				for(size_t z = 0; z < shape[0]; z++)
-					for(size_t x = 0; x < shape[1]; x++)
-						for(size_t y = 0; y < shape[2]; y++)
-							if (!(*fow)[z][x][y])
-								fw.tiles.insert(int3(x, y, z));
+				fw.tiles.resize(getMapSize());
+				fw.tiles.fill(true);
+				fw.tiles.subtract(*getPlayerTeam(player)->fogOfWarMap);
 
 				sendAndApply (&fw);
 			}
@@ -4146,13 +4141,15 @@ void CGameHandler::removeAfterVisit(const CGObjectInstance *object)
 
 void CGameHandler::changeFogOfWar(int3 center, ui32 radius, PlayerColor player, ETileVisibility mode)
 {
-	std::unordered_set<int3> tiles;
+	FoWChange fow;
+	fow.player = player;
+	fow.mode = mode;
 
 	if (mode == ETileVisibility::HIDDEN)
 	{
-		getTilesInRange(tiles, center, radius, ETileVisibility::REVEALED, player);
+		getTilesInRange(fow.tiles, center, radius, ETileVisibility::REVEALED, player);
 
-		std::unordered_set<int3> observedTiles; //do not hide tiles observed by heroes. May lead to disastrous AI problems
+		TileBitmask observedTiles; //do not hide tiles observed by heroes. May lead to disastrous AI problems
 		auto p = getPlayerState(player);
 		for (auto h : p->heroes)
 		{
@@ -4162,20 +4159,22 @@ void CGameHandler::changeFogOfWar(int3 center, ui32 radius, PlayerColor player,
 		{
 			getTilesInRange(observedTiles, t->getSightCenter(), t->getSightRadius(), ETileVisibility::REVEALED, t->tempOwner);
 		}
-		for (auto tile : observedTiles)
-			vstd::erase_if_present (tiles, tile);
+		if (!observedTiles.none())
+			fow.tiles.subtract(observedTiles);
 	}
 	else
 	{
-		getTilesInRange(tiles, center, radius, ETileVisibility::HIDDEN, player);
+		getTilesInRange(fow.tiles, center, radius, ETileVisibility::HIDDEN, player);
 	}
-	changeFogOfWar(tiles, player, mode);
+	sendAndApply(&fow);
 }
 
 void CGameHandler::changeFogOfWar(std::unordered_set<int3> &tiles, PlayerColor player, ETileVisibility mode)
 {
 	FoWChange fow;
-	fow.tiles = tiles;
+	fow.tiles.resize(getMapSize());
+	for (const int3 & tile : tiles)
+		fow.tiles.set(tile);
 	fow.player = player;
 	fow.mode = mode;
 	sendAndApply(&fow);
@@ -0,0 +1,138 @@
+/*
+ * DamageCalculatorTest.cpp, part of VCMI engine
+ *
+ * Authors: listed in file AUTHORS in main folder
+ *
+ * License: GNU General Public License v2.0 or later
+ * Full text of license available in license.txt file, in main folder
+ *
+ */
+
+#include "StdInc.h"
+#include "mock/mock_BonusBearer.h"
+#include "mock/mock_UnitInfo.h"
+#include "mock/mock_UnitEnvironment.h"
+#include "../../lib/battle/BattleAttackInfo.h"
+#include "../../lib/battle/CBattleInfoCallback.h"
+#include "../../lib/battle/CUnitState.h"
+#include "../../lib/CCreatureHandler.h"
+
+namespace test
+{
+using namespace ::testing;
+
+class DamageCalculatorTest : public Test
+{
+public:
+	class TestSubject : public CBattleInfoCallback
+	{
+	public:
+		const IBattleInfo * getBattle() const override
+		{
+			return nullptr;
+		}
+
+		std::optional<PlayerColor> getPlayerID() const override
+		{
+			return std::nullopt;
+		}
+
+#if SCRIPTING_ENABLED
+		scripting::Pool * getContextPool() const override
+		{
+			return nullptr;
+		}
+#endif
+	};
+
+	struct UnitFake
+	{
+		UnitInfoMock infoMock;
+		UnitEnvironmentMock envMock;
+		BonusBearerMock bonusMock;
+		battle::CUnitStateDetached state;
+
+		UnitFake(CreatureID creature, int32_t amount, int attack, int defence, int minDamage, int maxDamage, int health)
+			: state(&infoMock, &bonusMock)
+		{
+			addBonus(BonusType::PRIMARY_SKILL, attack, BonusSubtypeID(PrimarySkill::ATTACK));
+			addBonus(BonusType::PRIMARY_SKILL, defence, BonusSubtypeID(PrimarySkill::DEFENSE));
+			addBonus(BonusType::CREATURE_DAMAGE, minDamage, BonusCustomSubtype::creatureDamageMin);
+			addBonus(BonusType::CREATURE_DAMAGE, maxDamage, BonusCustomSubtype::creatureDamageMax);
+			addBonus(BonusType::STACK_HEALTH, health);
+
+			EXPECT_CALL(infoMock, unitBaseAmount()).WillRepeatedly(Return(amount));
+			EXPECT_CALL(infoMock, unitType()).WillRepeatedly(Return(creature.toCreature()));
+			EXPECT_CALL(envMock, unitHasAmmoCart(_)).WillRepeatedly(Return(false));
+
+			state.localInit(&envMock);
+		}
+
+		void addBonus(BonusType type, int value, BonusSubtypeID subtype = BonusSubtypeID())
+		{
+			bonusMock.addNewBonus(std::make_shared<Bonus>(BonusDuration::PERMANENT, type, BonusSource::CREATURE_ABILITY, value, BonusSourceID(), subtype));
+		}
+	};
+
+	TestSubject subject;
+	std::vector<std::unique_ptr<UnitFake>> units;
+
+	battle::CUnitState * addUnit(CreatureID creature, int32_t amount, int attack, int defence, int minDamage, int maxDamage, int health)
+	{
+		units.push_back(std::make_unique<UnitFake>(creature, amount, attack, defence, minDamage, maxDamage, health));
+		return &units.back()->state;
+	}
+};
+
+TEST_F(DamageCalculatorTest, batchMatchesSingleAttacks)
+{
+	auto * pikemen = addUnit(CreatureID(0), 20, 4, 5, 1, 3, 10);
+	auto * halberdiers = addUnit(CreatureID(1), 7, 6, 5, 2, 3, 10);
+	auto * imps = addUnit(CreatureID::IMP, 35, 2, 3, 1, 2, 4);
+	auto * elementals = addUnit(CreatureID::FIRE_ELEMENTAL, 2, 19, 21, 30, 40, 160);
+
+	// factors that depend on both units or on attack itself
+	units[1]->addBonus(BonusType::HATE, 50, BonusSubtypeID(CreatureID(CreatureID::FIRE_ELEMENTAL)));
+	units[1]->addBonus(BonusType::JOUSTING, 5);
+	units[3]->addBonus(BonusType::ENEMY_DEFENCE_REDUCTION, 40);
+	units[2]->addBonus(BonusType::GENERAL_DAMAGE_REDUCTION, 30, BonusCustomSubtype::damageTypeMelee);
+
+	std::vector<BattleAttackInfo> attacks;
+
+	for(auto * attacker : {pikemen, halberdiers})
+	{
+		for(auto * defender : {imps, elementals})
+		{
+			attacks.emplace_back(attacker, defender, 0, false);
+			attacks.back().luckyStrike = true;
+
+			attacks.emplace_back(attacker, defender, 3, false);
+			attacks.back().unluckyStrike = true;
+
+			// same units again, to reuse factors of first attack
+			attacks.emplace_back(attacker, defender, 0, false);
+		}
+	}
+
+	for(auto * attacker : {imps, elementals})
+	{
+		attacks.emplace_back(attacker, pikemen, 0, false);
+		attacks.emplace_back(attacker, halberdiers, 0, false);
+		attacks.back().deathBlow = true;
+	}
+
+	auto estimations = subject.calculateDmgRanges(attacks);
+	ASSERT_EQ(estimations.size(), attacks.size());
+
+	for(size_t i = 0; i < attacks.size(); i++)
+	{
+		DamageEstimation expected = subject.calculateDmgRange(attacks[i]);
+
+		EXPECT_EQ(estimations[i].damage.min, expected.damage.min) << "attack " << i;
+		EXPECT_EQ(estimations[i].damage.max, expected.damage.max) << "attack " << i;
+		EXPECT_EQ(estimations[i].kills.min, expected.kills.min) << "attack " << i;
+		EXPECT_EQ(estimations[i].kills.max, expected.kills.max) << "attack " << i;
+	}
+}
+
+}
@@ -0,0 +1,135 @@
+/*
+ * BattleStateBenchmark.cpp, part of VCMI engine
+ *
+ * Authors: listed in file AUTHORS in main folder
+ *
+ * License: GNU General Public License v2.0 or later
+ * Full text of license available in license.txt file, in main folder
+ *
+ */
+#include "StdInc.h"
+
+#include "../mock/mock_Environment.h"
+
+#include "../../AI/BattleAI/PotentialTargets.h"
+#include "../../AI/BattleAI/StackWithBonuses.h"
+#include "../../lib/battle/BattleInfo.h"
+#include "../../lib/filesystem/Filesystem.h"
+#include "../../lib/json/JsonNode.h"
+#include "../../lib/mapObjects/CArmedInstance.h"
+
+using namespace ::testing;
+
+static const int FORK_ITERATIONS = 10000;
+static const int LOOKUP_ITERATIONS = 10000;
+static const int SEARCH_ITERATIONS = 20;
+static const int FORK_DEPTH = 8;
+
+/// Returns average duration of one call of action, in microseconds
+template<typename Action>
+static double measure(int iterations, const Action & action)
+{
+	auto start = std::chrono::steady_clock::now();
+
+	for(int i = 0; i < iterations; i++)
+		action(i);
+
+	auto end = std::chrono::steady_clock::now();
+
+	return std::chrono::duration<double, std::micro>(end - start).count() / iterations;
+}
+
+static std::unique_ptr<CArmedInstance> loadArmy(const JsonNode & stacks)
+{
+	auto army = std::make_unique<CArmedInstance>(nullptr);
+
+	for(size_t i = 0; i < stacks.Vector().size(); i++)
+	{
+		const JsonNode & stack = stacks.Vector()[i];
+		CreatureID creature(CreatureID::decode(stack["type"].String()));
+
+		army->putStack(SlotID(i), new CStackInstance(creature, stack["count"].Integer()));
+	}
+
+	return army;
+}
+
+/// Reports cost of basic operations on hypothetic battle states for every battle scenario in test data
+/// Scenario lists creature stacks of attacker and defender in same format as test/testdata/BattleScenarios/*.json
+/// Run with --gtest_also_run_disabled_tests --gtest_filter=BattleStateBenchmark.DISABLED_ForkAndSearch
+TEST(BattleStateBenchmark, DISABLED_ForkAndSearch)
+{
+	auto scenarios = CResourceHandler::get()->getFilteredFiles([](const ResourcePath & resource)
+	{
+		return resource.getType() == EResType::JSON && boost::algorithm::starts_with(resource.getName(), "TEST/BATTLESCENARIOS/");
+	});
+
+	ASSERT_FALSE(scenarios.empty());
+
+	NiceMock<EnvironmentMock> env;
+
+	for(const auto & resource : scenarios)
+	{
+		JsonNode scenario(JsonPath::fromResource(resource));
+
+		std::unique_ptr<CArmedInstance> armies[2] = { loadArmy(scenario["attacker"]), loadArmy(scenario["defender"]) };
+		const CArmedInstance * armiesPtr[2] = { armies[0].get(), armies[1].get() };
+		const CGHeroInstance * heroes[2] = { nullptr, nullptr };
+
+		std::shared_ptr<BattleInfo> battle(BattleInfo::setupBattle(int3(4, 4, 0), ETerrainId::GRASS, BattleField(0), armiesPtr, heroes, false, nullptr));
+
+		auto root = std::make_shared<HypotheticBattle>(&env, battle);
+
+		auto units = root->battleAliveUnits();
+		vstd::erase_if(units, [](const battle::Unit * unit){ return unit->isTurret(); });
+
+		ASSERT_FALSE(units.empty());
+
+		const battle::Unit * activeUnit = units.front();
+
+		// make sure that every unit has its own state, like after few simulated turns
+		for(const auto * unit : units)
+			root->getForUpdate(unit->unitId())->waiting = true;
+
+		double forkTime = measure(FORK_ITERATIONS, [&](int i)
+		{
+			auto fork = HypotheticBattle::fork(root);
+			fork->getForUpdate(units[i % units.size()]->unitId())->waiting = false;
+		});
+
+		std::vector<std::shared_ptr<HypotheticBattle>> chain = { root };
+
+		for(int depth = 0; depth < FORK_DEPTH; depth++)
+		{
+			chain.push_back(HypotheticBattle::fork(chain.back()));
+			chain.back()->getForUpdate(units[depth % units.size()]->unitId())->waiting = false;
+		}
+
+		auto measureLookup = [&](const std::shared_ptr<HypotheticBattle> & state)
+		{
+			return measure(LOOKUP_ITERATIONS, [&](int i)
+			{
+				const auto * unit = state->battleGetUnitByID(units[i % units.size()]->unitId());
+				unit->getAttack(false);
+			});
+		};
+
+		double lookupTimeRoot = measureLookup(chain.front());
+		double lookupTimeDeep = measureLookup(chain.back());
+
+		double searchTime = measure(SEARCH_ITERATIONS, [&](int)
+		{
+			auto fork = HypotheticBattle::fork(root);
+			DamageCache damageCache;
+
+			damageCache.buildDamageCache(fork, activeUnit->unitSide());
+			PotentialTargets targets(activeUnit, damageCache, fork);
+		});
+
+		std::cout << resource.getName() << ", " << units.size() << " units"
+			<< ": fork " << forkTime << " us"
+			<< ", unit lookup " << lookupTimeRoot << " us"
+			<< ", after " << FORK_DEPTH << " forks " << lookupTimeDeep << " us"
+			<< ", attack search " << searchTime << " us" << std::endl;
+	}
+}
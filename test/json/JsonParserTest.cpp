@@ -0,0 +1,109 @@
+/*
+ * JsonParserTest.cpp, part of VCMI engine
+ *
+ * Authors: listed in file AUTHORS in main folder
+ *
+ * License: GNU General Public License v2.0 or later
+ * Full text of license available in license.txt file, in main folder
+ *
+ */
+#include "StdInc.h"
+
+#include "../../lib/json/JsonNode.h"
+#include "../../lib/filesystem/Filesystem.h"
+#include "../../lib/TextOperations.h"
+
+static JsonNode parseJson(const std::string & text)
+{
+	return JsonNode(text.data(), text.size());
+}
+
+TEST(JsonParserTest, stringsAroundBlockBoundaries)
+{
+	// place escape sequence at every offset within and around 8-character blocks
+	for(size_t length = 0; length < 40; length++)
+	{
+		for(size_t offset = 0; offset <= length; offset++)
+		{
+			std::string plain(length, 'a');
+			std::string expected = plain.substr(0, offset) + "\"\n" + plain.substr(offset);
+			std::string text = "\"" + plain.substr(0, offset) + "\\\"\\n" + plain.substr(offset) + "\"";
+
+			EXPECT_EQ(parseJson(text).String(), expected) << text;
+		}
+	}
+}
+
+TEST(JsonParserTest, nonAsciiStrings)
+{
+	const std::string value = "Zamek \xC5\x81\xC3\xB3\x64\xC5\xBA \xE2\x80\x94 long enough for several blocks";
+
+	EXPECT_EQ(parseJson("{\"name\" : \"" + value + "\"}")["name"].String(), value);
+	EXPECT_TRUE(TextOperations::isValidUnicodeString(value));
+
+	// truncated multi-byte character after block of ASCII characters
+	EXPECT_FALSE(TextOperations::isValidUnicodeString(std::string("abcdefghijklmnop\xC5")));
+	EXPECT_FALSE(TextOperations::isValidUnicodeString(std::string("abcdefgh\xFFijklmnop")));
+}
+
+TEST(JsonParserTest, structKeysAndFlags)
+{
+	JsonNode node = parseJson("{ \"first\" : 1, \"second#override\" : { \"inner\" : true }, \"first\" : 2 }");
+
+	ASSERT_EQ(node.Struct().size(), 2);
+	EXPECT_EQ(node["first"].Integer(), 2);
+	EXPECT_TRUE(node["second"]["inner"].Bool());
+	EXPECT_EQ(node["second"].flags, std::vector<std::string>{"override"});
+	EXPECT_TRUE(node["first"].flags.empty());
+}
+
+/// Run with --gtest_also_run_disabled_tests --gtest_filter=JsonParserTest.DISABLED_ParseThroughput
+/// Set VCMI_JSON_BENCHMARK_PATH to directory with unpacked mods to include them into measurement
+TEST(JsonParserTest, DISABLED_ParseThroughput)
+{
+	static const int PARSES_PER_FILE = 20;
+
+	std::vector<std::string> files;
+
+	auto configs = CResourceHandler::get()->getFilteredFiles([](const ResourcePath & resource)
+	{
+		return resource.getType() == EResType::JSON && boost::algorithm::starts_with(resource.getName(), "CONFIG/");
+	});
+
+	for(const auto & resource : configs)
+	{
+		auto data = CResourceHandler::get()->load(resource)->readAll();
+		files.emplace_back(reinterpret_cast<const char *>(data.first.get()), data.second);
+	}
+
+	if(const char * modsPath = std::getenv("VCMI_JSON_BENCHMARK_PATH"))
+	{
+		for(const auto & entry : boost::filesystem::recursive_directory_iterator(modsPath))
+		{
+			if(!boost::iequals(entry.path().extension().string(), ".json"))
+				continue;
+
+			std::ifstream file(entry.path().string(), std::ios::binary);
+			files.emplace_back(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+		}
+	}
+
+	ASSERT_FALSE(files.empty());
+
+	size_t totalBytes = 0;
+	auto timeStart = std::chrono::steady_clock::now();
+
+	for(int i = 0; i < PARSES_PER_FILE; i++)
+	{
+		for(const auto & file : files)
+		{
+			JsonNode node(file.data(), file.size());
+			totalBytes += file.size();
+		}
+	}
+
+	double totalSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - timeStart).count();
+
+	std::cout << files.size() << " files, " << totalBytes / PARSES_PER_FILE / 1024 << " KiB, "
+		<< totalBytes / totalSeconds / (1024 * 1024) << " MiB/s" << std::endl;
+}
@@ -0,0 +1,158 @@
+/*
+ * JsonValidatorTest.cpp, part of VCMI engine
+ *
+ * Authors: listed in file AUTHORS in main folder
+ *
+ * License: GNU General Public License v2.0 or later
+ * Full text of license available in license.txt file, in main folder
+ *
+ */
+#include "StdInc.h"
+
+#include "../../lib/json/JsonNode.h"
+#include "../../lib/json/JsonValidator.h"
+#include "../../lib/filesystem/ResourcePath.h"
+#include "../../lib/modding/ModScope.h"
+
+namespace
+{
+	struct ContentObject
+	{
+		std::string schemaName;
+		std::string name;
+		JsonNode data;
+	};
+
+	/// All objects from built-in content files listed in gameConfig.json, with schema used for their validation
+	std::vector<ContentObject> loadBuiltinContent()
+	{
+		static const std::map<std::string, std::string> contentSchemas =
+		{
+			{"heroClasses", "heroClass"},
+			{"artifacts", "artifact"},
+			{"creatures", "creature"},
+			{"factions", "faction"},
+			{"objects", "object"},
+			{"heroes", "hero"},
+			{"spells", "spell"},
+			{"skills", "skill"},
+			{"battlefields", "battlefield"},
+			{"terrains", "terrain"},
+			{"rivers", "river"},
+			{"roads", "road"},
+			{"obstacles", "obstacle"}
+		};
+
+		std::vector<ContentObject> result;
+		JsonNode gameConfig(JsonPath::builtin("config/gameConfig.json"));
+
+		for(const auto & content : contentSchemas)
+		{
+			for(const auto & file : gameConfig[content.first].Vector())
+			{
+				JsonNode objects(JsonPath::builtin(file.String()));
+				objects.setMeta(ModScope::scopeBuiltin());
+
+				for(const auto & object : objects.Struct())
+					result.push_back({"vcmi:" + content.second, object.first, object.second});
+			}
+		}
+		return result;
+	}
+}
+
+TEST(JsonValidatorTest, reportsErrorsOfNestedEntries)
+{
+	const std::string json = R"({
+		"shortIdentifier" : "rw",
+		"text" : "River",
+		"unknown" : 1,
+		"paletteAnimation" : [ { "start" : "invalid", "extra" : 1 } ]
+	})";
+	JsonNode data(json.data(), json.size());
+
+	std::string expected =
+		"At <root>\n\t Error: Unknown entry found: unknown\n"
+		"At /paletteAnimation/0\n\t Error: Unknown entry found: extra\n"
+		"At /paletteAnimation/0/start\n\t Error: Type mismatch! Expected number\n"
+		"At <root>\n\t Error: Required entry tilesFilename is missing\n"
+		"At <root>\n\t Error: Required entry delta is missing\n";
+
+	EXPECT_EQ(Validation::check("vcmi:river", data), expected);
+	EXPECT_FALSE(Validation::isValid("vcmi:river", data));
+}
+
+TEST(JsonValidatorTest, reportsErrorsOfAllTestedSchemas)
+{
+	const std::string json = R"({ "class" : "knight" })";
+	JsonNode data(json.data(), json.size());
+
+	std::string expected =
+		"At <root>\n\t Error: Failed to pass exactly one schema\n"
+		"<tested schemas>\n"
+		"At <root>\n\t Error: Required entry images is missing\n"
+		"<end of schema>\n"
+		"At <root>\n\t Error: Required entry index is missing\n"
+		"<end of schema>\n"
+		"At <root>\n\t Error: Required entry army is missing\n"
+		"At <root>\n\t Error: Required entry skills is missing\n"
+		"At <root>\n\t Error: Required entry texts is missing\n";
+
+	EXPECT_EQ(Validation::check("vcmi:hero", data), expected);
+	EXPECT_FALSE(Validation::isValid("vcmi:hero", data));
+}
+
+TEST(JsonValidatorTest, quietValidationMatchesMessages)
+{
+	auto content = loadBuiltinContent();
+	ASSERT_FALSE(content.empty());
+
+	for(const auto & object : content)
+	{
+		EXPECT_EQ(Validation::isValid(object.schemaName, object.data), Validation::check(object.schemaName, object.data).empty()) << object.name;
+
+		// replace each entry with value of different type, so both valid and invalid data is tested
+		for(const auto & entry : object.data.Struct())
+		{
+			JsonNode broken = object.data;
+			if(entry.second.isString())
+				broken[entry.first].Integer() = 1;
+			else
+				broken[entry.first].String() = "invalid";
+			broken.setMeta(ModScope::scopeBuiltin());
+
+			EXPECT_EQ(Validation::isValid(object.schemaName, broken), Validation::check(object.schemaName, broken).empty()) << object.name << "/" << entry.first;
+		}
+	}
+}
+
+/// Run with --gtest_also_run_disabled_tests --gtest_filter=JsonValidatorTest.DISABLED_ValidateBuiltinContent
+TEST(JsonValidatorTest, DISABLED_ValidateBuiltinContent)
+{
+	static const int VALIDATIONS_PER_OBJECT = 10;
+
+	auto content = loadBuiltinContent();
+	ASSERT_FALSE(content.empty());
+
+	auto measure = [&](const std::function<bool(const ContentObject &)> & validate)
+	{
+		size_t validObjects = 0;
+		auto timeStart = std::chrono::steady_clock::now();
+
+		for(int i = 0; i < VALIDATIONS_PER_OBJECT; i++)
+		{
+			for(const auto & object : content)
+				validObjects += validate(object);
+		}
+
+		auto totalMs = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - timeStart).count();
+		std::cout << validObjects / VALIDATIONS_PER_OBJECT << " of " << content.size() << " objects valid, "
+			<< totalMs / static_cast<double>(VALIDATIONS_PER_OBJECT) << " ms per pass" << std::endl;
+	};
+
+	std::cout << "Validation: ";
+	measure([](const ContentObject & object){ return Validation::isValid(object.schemaName, object.data); });
+
+	std::cout << "Validation with error messages: ";
+	measure([](const ContentObject & object){ return Validation::check(object.schemaName, object.data).empty(); });
+}
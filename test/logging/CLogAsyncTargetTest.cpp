@@ -0,0 +1,165 @@
+/*
+ * CLogAsyncTargetTest.cpp, part of VCMI engine
+ *
+ * Authors: listed in file AUTHORS in main folder
+ *
+ * License: GNU General Public License v2.0 or later
+ * Full text of license available in license.txt file, in main folder
+ *
+ */
+#include "StdInc.h"
+
+#include "../../lib/logging/CLogger.h"
+
+namespace
+{
+	class LogTargetMock : public ILogTarget
+	{
+	public:
+		std::mutex mx;
+		std::vector<std::string> messages;
+		/// delays each write, to simulate slow output
+		boost::chrono::milliseconds delay{0};
+
+		void write(const LogRecord & record) override
+		{
+			boost::this_thread::sleep_for(delay);
+			TLockGuard _(mx);
+			messages.push_back(record.message);
+		}
+	};
+
+	static const std::string DROP_REPORT = "log records were dropped";
+
+	/// Logs messages "thread:index" from several threads at once
+	void writeConcurrently(ILogTarget & target, int threadsCount, int messagesPerThread)
+	{
+		std::vector<boost::thread> threads;
+		for(int thread = 0; thread < threadsCount; thread++)
+		{
+			threads.emplace_back([&target, thread, messagesPerThread]()
+			{
+				for(int i = 0; i < messagesPerThread; i++)
+					target.write(LogRecord(CLoggerDomain(CLoggerDomain::DOMAIN_GLOBAL), ELogLevel::INFO, std::to_string(thread) + ":" + std::to_string(i)));
+			});
+		}
+
+		for(auto & thread : threads)
+			thread.join();
+	}
+}
+
+TEST(CLogAsyncTargetTest, deliversAllRecordsInOrderOfEachThread)
+{
+	static const int THREADS = 4;
+	static const int MESSAGES = 2000;
+
+	auto mock = std::make_unique<LogTargetMock>();
+	LogTargetMock * target = mock.get();
+	CLogAsyncTarget subject(std::move(mock), THREADS * MESSAGES);
+
+	writeConcurrently(subject, THREADS, MESSAGES);
+	subject.flush();
+
+	EXPECT_EQ(subject.getDroppedRecords(), 0);
+	ASSERT_EQ(target->messages.size(), THREADS * MESSAGES);
+
+	std::map<int, int> lastIndex;
+	for(const auto & message : target->messages)
+	{
+		int thread = std::stoi(message.substr(0, message.find(':')));
+		int index = std::stoi(message.substr(message.find(':') + 1));
+
+		if(lastIndex.count(thread))
+			EXPECT_EQ(lastIndex[thread] + 1, index);
+		lastIndex[thread] = index;
+	}
+}
+
+TEST(CLogAsyncTargetTest, countsAndReportsDroppedRecords)
+{
+	static const int THREADS = 4;
+	static const int MESSAGES = 100;
+
+	auto mock = std::make_unique<LogTargetMock>();
+	mock->delay = boost::chrono::milliseconds(1);
+	LogTargetMock * target = mock.get();
+	CLogAsyncTarget subject(std::move(mock), 16);
+
+	writeConcurrently(subject, THREADS, MESSAGES);
+	subject.flush();
+
+	size_t delivered = 0;
+	{
+		TLockGuard _(target->mx);
+		for(const auto & message : target->messages)
+		{
+			if(message.find(DROP_REPORT) == std::string::npos)
+				delivered++;
+		}
+	}
+
+	EXPECT_GT(subject.getDroppedRecords(), 0);
+	EXPECT_EQ(delivered + subject.getDroppedRecords(), THREADS * MESSAGES);
+
+	// report is written once writer catches up with the queue
+	subject.write(LogRecord(CLoggerDomain(CLoggerDomain::DOMAIN_GLOBAL), ELogLevel::INFO, "last"));
+	subject.flush();
+	boost::this_thread::sleep_for(boost::chrono::milliseconds(50));
+
+	TLockGuard _(target->mx);
+	EXPECT_GT(std::count_if(target->messages.begin(), target->messages.end(), [](const std::string & message)
+	{
+		return message.find(DROP_REPORT) != std::string::npos;
+	}), 0);
+}
+
+/// Run with --gtest_also_run_disabled_tests --gtest_filter=CLogAsyncTargetTest.DISABLED_LogCallsPerSecond
+TEST(CLogAsyncTargetTest, DISABLED_LogCallsPerSecond)
+{
+	static const int MESSAGES_PER_THREAD = 50000;
+
+	auto logPath = boost::filesystem::temp_directory_path() / boost::filesystem::unique_path("vcmi-log-benchmark-%%%%.txt");
+	CLogger * logger = CLogger::getLogger(CLoggerDomain("benchmark"));
+
+	uint64_t dropped = 0;
+
+	// measures whole logging call, including level check and dispatch to targets of logger
+	auto measure = [&](std::unique_ptr<ILogTarget> && target, int threadsCount)
+	{
+		auto * asyncTarget = dynamic_cast<CLogAsyncTarget *>(target.get());
+		logger->addTarget(std::move(target));
+
+		auto timeStart = std::chrono::steady_clock::now();
+		std::vector<boost::thread> threads;
+		for(int thread = 0; thread < threadsCount; thread++)
+		{
+			threads.emplace_back([logger]()
+			{
+				for(int i = 0; i < MESSAGES_PER_THREAD; i++)
+					logger->info("message %d", i);
+			});
+		}
+
+		for(auto & thread : threads)
+			thread.join();
+		double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - timeStart).count();
+
+		if(asyncTarget)
+			dropped = asyncTarget->getDroppedRecords();
+		logger->clearTargets();
+		return threadsCount * MESSAGES_PER_THREAD / seconds;
+	};
+
+	for(int threads : {1, 4, 16})
+	{
+		double syncRate = measure(std::make_unique<CLogFileTarget>(logPath, false), threads);
+
+		double asyncRate = measure(std::make_unique<CLogAsyncTarget>(std::make_unique<CLogFileTarget>(logPath, false)), threads);
+
+		std::cout << threads << " threads: " << static_cast<int64_t>(syncRate) << " calls/s synchronous, "
+			<< static_cast<int64_t>(asyncRate) << " calls/s asynchronous, " << dropped << " dropped" << std::endl;
+	}
+
+	boost::filesystem::remove(logPath);
+}
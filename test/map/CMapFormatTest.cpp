@@ -16,6 +16,8 @@
 #include "../../lib/rmg/CMapGenOptions.h"
 #include "../../lib/rmg/CMapGenerator.h"
 #include "../../lib/mapping/MapFormatJson.h"
+#include "../../lib/mapping/CMapService.h"
+#include "../../lib/mapObjects/CGObjectInstance.h"
 
 #include "../lib/VCMIDirs.h"
 
@@ -221,3 +223,48 @@ TEST(MapFormat, DISABLED_Terrain)
 		c.compare("underground", actualUnderground, expectedUnderground);
 	}
 }
+
+/// Reports average load time of every H3M map in test data
+/// Run with --gtest_also_run_disabled_tests --gtest_filter=MapFormat.DISABLED_LoadTimeH3M
+TEST(MapFormat, DISABLED_LoadTimeH3M)
+{
+	static const int LOADS_PER_MAP = 20;
+
+	auto maps = CResourceHandler::get()->getFilteredFiles([](const ResourcePath & resource)
+	{
+		return resource.getType() == EResType::MAP && boost::algorithm::starts_with(resource.getName(), "TEST/");
+	});
+
+	ASSERT_FALSE(maps.empty());
+
+	CMapService mapService;
+
+	for(const auto & resource : maps)
+	{
+		auto reference = mapService.loadMap(resource, nullptr);
+
+		auto timeStart = std::chrono::steady_clock::now();
+
+		for(int i = 0; i < LOADS_PER_MAP; i++)
+		{
+			auto map = mapService.loadMap(resource, nullptr);
+
+			// staged loading must produce same map on every run
+			EXPECT_EQ(map->checksum, reference->checksum);
+			ASSERT_EQ(map->objects.size(), reference->objects.size());
+
+			for(size_t objectIndex = 0; objectIndex < map->objects.size(); objectIndex++)
+			{
+				EXPECT_EQ(map->objects[objectIndex]->id, reference->objects[objectIndex]->id);
+				EXPECT_EQ(map->objects[objectIndex]->ID, reference->objects[objectIndex]->ID);
+				EXPECT_EQ(map->objects[objectIndex]->pos, reference->objects[objectIndex]->pos);
+			}
+		}
+
+		auto totalMs = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - timeStart).count();
+
+		std::cout << resource.getName() << ": " << reference->width << "x" << reference->height << "x" << reference->levels()
+			<< ", " << reference->objects.size() << " objects, "
+			<< totalMs / static_cast<double>(LOADS_PER_MAP) << " ms per load" << std::endl;
+	}
+}
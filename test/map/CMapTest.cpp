@@ -0,0 +1,109 @@
+/*
+ * CMapTest.cpp, part of VCMI engine
+ *
+ * Authors: listed in file AUTHORS in main folder
+ *
+ * License: GNU General Public License v2.0 or later
+ * Full text of license available in license.txt file, in main folder
+ *
+ */
+
+#include "StdInc.h"
+
+#include "../lib/mapping/CMap.h"
+#include "../lib/mapObjects/CGObjectInstance.h"
+#include "../lib/mapObjects/ObjectTemplate.h"
+#include "../lib/TerrainHandler.h"
+#include "../lib/VCMI_Lib.h"
+
+namespace
+{
+	class CMapGuardsTest : public ::testing::Test
+	{
+	public:
+		CMap map;
+		std::vector<std::unique_ptr<CGObjectInstance>> monsters;
+
+		CMapGuardsTest()
+			: map(nullptr)
+		{
+			map.width = 10;
+			map.height = 10;
+			map.initTerrain();
+
+			for(int x = 0; x < map.width; x++)
+				for(int y = 0; y < map.height; y++)
+					map.getTile(int3(x, y, 0)).terType = VLC->terrainTypeHandler->getById(ETerrainId::GRASS);
+		}
+
+		CGObjectInstance * addMonster(const int3 & pos)
+		{
+			// single visitable and blocking tile, visitable from all sides
+			const std::string json = R"({"mask" : ["A"], "visitableFrom" : ["+++", "+-+", "+++"]})";
+			auto appearance = std::make_shared<ObjectTemplate>();
+			appearance->readJson(JsonNode(json.data(), json.size()), false);
+
+			auto monster = std::make_unique<CGObjectInstance>(nullptr);
+			monster->ID = Obj::MONSTER;
+			monster->pos = pos;
+			monster->appearance = appearance;
+
+			map.addBlockVisTiles(monster.get());
+			monsters.push_back(std::move(monster));
+			return monsters.back().get();
+		}
+
+		void expectGuard(const int3 & tile, const int3 & guard)
+		{
+			EXPECT_EQ(map.guardingCreaturePosition(tile), guard) << tile.toString();
+		}
+	};
+}
+
+TEST_F(CMapGuardsTest, monsterGuardsAdjacentTiles)
+{
+	const int3 monster(5, 5, 0);
+	const int3 unguarded(-1, -1, -1);
+
+	map.getTile(int3(4, 5, 0)).terType = VLC->terrainTypeHandler->getById(ETerrainId::WATER);
+	addMonster(monster);
+
+	expectGuard(monster, monster);
+	expectGuard(int3(4, 4, 0), monster);
+	expectGuard(int3(6, 6, 0), monster);
+	expectGuard(int3(5, 6, 0), monster);
+
+	// monster on land does not guard water
+	expectGuard(int3(4, 5, 0), unguarded);
+
+	expectGuard(int3(7, 5, 0), unguarded);
+	expectGuard(int3(3, 3, 0), unguarded);
+}
+
+TEST_F(CMapGuardsTest, monsterOnTileHasPriority)
+{
+	const int3 first(5, 5, 0);
+	const int3 second(6, 6, 0);
+
+	addMonster(first);
+	auto * secondMonster = addMonster(second);
+
+	expectGuard(first, first);
+	expectGuard(second, second);
+
+	// out of several adjacent monsters, first one from top left is selected
+	expectGuard(int3(5, 6, 0), first);
+	expectGuard(int3(6, 5, 0), first);
+	expectGuard(int3(7, 7, 0), second);
+
+	// guards are found through object index, which is updated together with tile object lists
+	map.removeBlockVisTiles(secondMonster, true);
+
+	expectGuard(second, first);
+	expectGuard(int3(7, 7, 0), int3(-1, -1, -1));
+
+	map.addBlockVisTiles(secondMonster);
+
+	expectGuard(second, second);
+	expectGuard(int3(7, 7, 0), second);
+}
@@ -0,0 +1,87 @@
+/*
+ * MapObjectIndexTest.cpp, part of VCMI engine
+ *
+ * Authors: listed in file AUTHORS in main folder
+ *
+ * License: GNU General Public License v2.0 or later
+ * Full text of license available in license.txt file, in main folder
+ *
+ */
+
+#include "StdInc.h"
+
+#include "../lib/mapping/MapObjectIndex.h"
+#include "../lib/mapObjects/CGObjectInstance.h"
+
+using ELayer = MapObjectIndex::ELayer;
+
+TEST(MapObjectIndexTest, rectQueryReportsEachObjectOnce)
+{
+	MapObjectIndex subject;
+	subject.resize(36, 20, 2);
+
+	CGObjectInstance large(nullptr);
+	CGObjectInstance small(nullptr);
+	CGObjectInstance underground(nullptr);
+
+	// object spanning border between buckets
+	for(int x = 6; x < 10; x++)
+		subject.add(&large, int3(x, 3, 0), ELayer::BLOCKING);
+
+	subject.add(&small, int3(35, 19, 0), ELayer::BLOCKING);
+	subject.add(&underground, int3(7, 3, 1), ELayer::BLOCKING);
+
+	auto found = subject.getObjectsInRect(int3(0, 0, 0), int3(35, 19, 0), ELayer::BLOCKING);
+	EXPECT_EQ(found.size(), 2);
+	EXPECT_TRUE(vstd::contains(found, &large));
+	EXPECT_TRUE(vstd::contains(found, &small));
+
+	EXPECT_EQ(subject.getObjectsInRect(int3(9, 3, 0), int3(20, 10, 0), ELayer::BLOCKING), std::vector<CGObjectInstance *>{&large});
+	EXPECT_TRUE(subject.getObjectsInRect(int3(0, 0, 0), int3(35, 19, 0), ELayer::VISITABLE).empty());
+	EXPECT_TRUE(subject.getObjectsInRect(int3(10, 0, 0), int3(34, 19, 0), ELayer::BLOCKING).empty());
+
+	subject.remove(&large, int3(9, 3, 0), ELayer::BLOCKING);
+	EXPECT_TRUE(subject.getObjectsInRect(int3(9, 3, 0), int3(20, 10, 0), ELayer::BLOCKING).empty());
+	EXPECT_EQ(subject.getObjectsInRect(int3(8, 3, 0), int3(20, 10, 0), ELayer::BLOCKING), std::vector<CGObjectInstance *>{&large});
+}
+
+TEST(MapObjectIndexTest, radiusQueryMatchesDistanceAndType)
+{
+	MapObjectIndex subject;
+	subject.resize(64, 64, 1);
+
+	std::vector<std::unique_ptr<CGObjectInstance>> objects;
+	const int3 center(30, 30, 0);
+	const int radius = 5;
+
+	for(int x = 0; x < 64; x += 3)
+	{
+		for(int y = 0; y < 64; y += 4)
+		{
+			objects.push_back(std::make_unique<CGObjectInstance>(nullptr));
+			objects.back()->ID = (x + y) % 2 ? Obj::MONSTER : Obj::RESOURCE;
+			objects.back()->pos = int3(x, y, 0);
+			subject.add(objects.back().get(), objects.back()->pos, ELayer::VISITABLE);
+		}
+	}
+
+	auto found = subject.getObjectsInRadius(center, radius, ELayer::VISITABLE);
+	auto monsters = subject.getObjectsInRadius(center, radius, ELayer::VISITABLE, Obj::MONSTER);
+
+	size_t expectedCount = 0;
+	size_t expectedMonsters = 0;
+
+	for(const auto & object : objects)
+	{
+		bool inRange = object->pos.dist2dSQ(center) <= radius * radius;
+
+		EXPECT_EQ(vstd::contains(found, object.get()), inRange);
+		EXPECT_EQ(vstd::contains(monsters, object.get()), inRange && object->ID == Obj::MONSTER);
+
+		expectedCount += inRange;
+		expectedMonsters += inRange && object->ID == Obj::MONSTER;
+	}
+
+	EXPECT_EQ(found.size(), expectedCount);
+	EXPECT_EQ(monsters.size(), expectedMonsters);
+}
@@ -0,0 +1,122 @@
+/*
+ * TileBitmaskTest.cpp, part of VCMI engine
+ *
+ * Authors: listed in file AUTHORS in main folder
+ *
+ * License: GNU General Public License v2.0 or later
+ * Full text of license available in license.txt file, in main folder
+ *
+ */
+
+#include "StdInc.h"
+
+#include "../lib/mapping/TileBitmask.h"
+#include "../lib/mapping/CMap.h"
+#include "../lib/gameState/CGameState.h"
+#include "../lib/serializer/CMemorySerializer.h"
+#include "../lib/CTownHandler.h"
+
+TEST(TileBitmaskTest, setAndTest)
+{
+	TileBitmask subject(int3(100, 70, 2));
+
+	EXPECT_TRUE(subject.none());
+
+	subject.set(int3(0, 0, 0));
+	subject.set(int3(63, 5, 1));
+	subject.set(int3(64, 5, 1));
+	subject.set(int3(99, 69, 1));
+
+	EXPECT_TRUE(subject.test(int3(0, 0, 0)));
+	EXPECT_TRUE(subject.test(int3(63, 5, 1)));
+	EXPECT_TRUE(subject.test(int3(64, 5, 1)));
+	EXPECT_TRUE(subject.test(int3(99, 69, 1)));
+	EXPECT_FALSE(subject.test(int3(63, 5, 0)));
+	EXPECT_EQ(subject.count(), 4);
+
+	subject.set(int3(63, 5, 1), false);
+	EXPECT_FALSE(subject.test(int3(63, 5, 1)));
+	EXPECT_EQ(subject.count(), 3);
+}
+
+TEST(TileBitmaskTest, fillKeepsPaddingClear)
+{
+	TileBitmask subject(int3(70, 3, 2));
+	subject.fill(true);
+
+	EXPECT_EQ(subject.count(), 70 * 3 * 2);
+
+	TileBitmask other(int3(70, 3, 2));
+	other.set(int3(69, 2, 1));
+	subject.subtract(other);
+
+	EXPECT_EQ(subject.count(), 70 * 3 * 2 - 1);
+	EXPECT_FALSE(subject.test(int3(69, 2, 1)));
+}
+
+TEST(TileBitmaskTest, setRangeMatchesDistance)
+{
+	const int3 size(144, 144, 1);
+	const int3 centers[] = { int3(70, 70, 0), int3(0, 3, 0), int3(143, 100, 0), int3(64, 64, 0) };
+	const int3::EDistanceFormula formulas[] = { int3::DIST_2D, int3::DIST_MANHATTAN, int3::DIST_CHEBYSHEV };
+
+	for(const auto & center : centers)
+	{
+		for(auto formula : formulas)
+		{
+			for(int radius : {0, 1, 5, 13, 70})
+			{
+				TileBitmask subject(size);
+				subject.setRange(center, radius, formula);
+
+				for(int x = 0; x < size.x; ++x)
+					for(int y = 0; y < size.y; ++y)
+						EXPECT_EQ(subject.test(int3(x, y, 0)), static_cast<int>(center.dist(int3(x, y, 0), formula)) <= radius);
+			}
+		}
+	}
+}
+
+TEST(TileBitmaskTest, setRangeLargeRadius)
+{
+	TileBitmask subject(int3(36, 36, 2));
+	subject.setRange(int3(10, 10, 1), std::numeric_limits<int>::max());
+
+	EXPECT_EQ(subject.count(), 36 * 36);
+}
+
+TEST(TileBitmaskTest, sightRangeOfSkyshipCoversAllLevels)
+{
+	CGameState gameState;
+	gameState.map = new CMap(nullptr);
+	gameState.map->width = 36;
+	gameState.map->height = 20;
+	gameState.map->twoLevel = true;
+
+	TileBitmask subject;
+	gameState.getTilesInRange(subject, int3(10, 10, 0), 3, ETileVisibility::REVEALED);
+
+	EXPECT_EQ(subject.size(), int3(36, 20, 2));
+	EXPECT_TRUE(subject.test(int3(10, 13, 0)));
+	EXPECT_FALSE(subject.test(int3(10, 10, 1)));
+
+	gameState.getTilesInRange(subject, int3(10, 10, 0), CBuilding::HEIGHT_SKYSHIP, ETileVisibility::REVEALED);
+
+	EXPECT_EQ(subject.count(), 36 * 20 * 2);
+}
+
+TEST(TileBitmaskTest, serializationRoundTrip)
+{
+	TileBitmask subject(int3(130, 40, 2));
+	subject.setRange(int3(60, 20, 0), 9);
+	subject.setRange(int3(128, 39, 1), 4);
+	subject.setSpan(0, 1, 0, 129);
+	subject.set(int3(64, 10, 1));
+
+	auto copy = CMemorySerializer::deepCopy(subject);
+
+	ASSERT_TRUE(copy);
+	EXPECT_EQ(copy->size(), subject.size());
+	EXPECT_EQ(copy->count(), subject.count());
+	EXPECT_TRUE(*copy == subject);
+}
@@ -0,0 +1,63 @@
+/*
+ * AISharedStorageTest.cpp, part of VCMI engine
+ *
+ * Authors: listed in file AUTHORS in main folder
+ *
+ * License: GNU General Public License v2.0 or later
+ * Full text of license available in license.txt file, in main folder
+ *
+ */
+
+#include "StdInc.h"
+
+#include "../../AI/Nullkiller/Pathfinding/AINodeStorage.h"
+
+using namespace NKAI;
+
+TEST(AISharedStorageTest, reusedChainsBelongToNewTile)
+{
+	const int3 firstTile(1, 2, 0);
+	const int3 secondTile(3, 0, 1);
+
+	auto storage = AISharedStorage::lease(int3(4, 4, 2));
+
+	storage->reset();
+	storage->resetTile(firstTile, EPathfindingLayer::LAND, EPathAccessibility::ACCESSIBLE);
+
+	auto firstChains = storage->getOrCreate(firstTile, EPathfindingLayer::LAND);
+	ASSERT_FALSE(firstChains.empty());
+
+	for(AIPathNode & node : firstChains)
+	{
+		EXPECT_EQ(node.coord, firstTile);
+		EXPECT_EQ(node.layer, EPathfindingLayer::LAND);
+
+		node.setCost(1.5f);
+		node.turns = 1;
+		node.moveRemains = 100;
+		node.danger = 1000;
+	}
+
+	// second pass over other tile gets the same memory block
+	storage->reset();
+	storage->resetTile(secondTile, EPathfindingLayer::SAIL, EPathAccessibility::VISITABLE);
+
+	EXPECT_TRUE(storage->get(firstTile, EPathfindingLayer::LAND).empty());
+
+	auto secondChains = storage->getOrCreate(secondTile, EPathfindingLayer::SAIL);
+	ASSERT_FALSE(secondChains.empty());
+
+	for(const AIPathNode & node : secondChains)
+	{
+		EXPECT_EQ(node.coord, secondTile);
+		EXPECT_EQ(node.layer, EPathfindingLayer::SAIL);
+		EXPECT_EQ(node.accessible, EPathAccessibility::VISITABLE);
+		EXPECT_FALSE(node.reachable());
+		EXPECT_EQ(node.moveRemains, 0);
+		EXPECT_EQ(node.danger, 0);
+		EXPECT_EQ(node.actor, nullptr);
+		EXPECT_EQ(node.theNodeBefore, nullptr);
+	}
+
+	EXPECT_TRUE(storage->getOrCreate(firstTile, EPathfindingLayer::LAND).empty());
+}
@@ -0,0 +1,93 @@
+/*
+ * CompiledFuzzyEngineTest.cpp, part of VCMI engine
+ *
+ * Authors: listed in file AUTHORS in main folder
+ *
+ * License: GNU General Public License v2.0 or later
+ * Full text of license available in license.txt file, in main folder
+ *
+ */
+
+#include "StdInc.h"
+
+#include "../../AI/Nullkiller/Engine/CompiledFuzzyEngine.h"
+#include "../../lib/filesystem/Filesystem.h"
+
+#include <random>
+
+using namespace NKAI;
+
+static std::unique_ptr<fl::Engine> loadObjectPriorities()
+{
+	auto file = CResourceHandler::get()->load(ResourcePath("config/ai/object-priorities.txt"))->readAll();
+	std::string str(reinterpret_cast<char *>(file.first.get()), file.second);
+
+	return std::unique_ptr<fl::Engine>(fl::FllImporter().fromString(str));
+}
+
+TEST(CompiledFuzzyEngineTest, objectPrioritiesMatchInterpreter)
+{
+	auto engine = loadObjectPriorities();
+	auto compiled = CompiledFuzzyEngine::compile(engine.get());
+
+	ASSERT_TRUE(compiled);
+
+	fl::OutputVariable * output = engine->getOutputVariable(0);
+	std::mt19937 rng(12345);
+
+	for(int sample = 0; sample < 2000; sample++)
+	{
+		for(std::size_t i = 0; i < engine->numberOfInputVariables(); i++)
+		{
+			fl::InputVariable * variable = engine->getInputVariable(i);
+			std::uniform_real_distribution<double> distribution(variable->getMinimum(), variable->getMaximum());
+
+			// half of samples use exact term boundaries of discrete inputs like hero role and turn
+			double value = distribution(rng);
+			variable->setValue(sample % 2 ? value : std::round(value));
+		}
+
+		engine->process();
+		double expected = output->getValue();
+
+		compiled->process();
+		double actual = output->getValue();
+
+		if(std::isnan(expected))
+			EXPECT_TRUE(std::isnan(actual));
+		else
+			EXPECT_NEAR(expected, actual, 1e-6);
+	}
+
+	EXPECT_LT(compiled->compareWithInterpreter(100, 0), 1e-6);
+}
+
+TEST(CompiledFuzzyEngineTest, disjunctionIsNotCompiled)
+{
+	std::string rules =
+		"Engine: test\n"
+		"InputVariable: a\n"
+		"  enabled: true\n"
+		"  range: 0.000 1.000\n"
+		"  term: LOW Ramp 1.000 0.000\n"
+		"  term: HIGH Ramp 0.000 1.000\n"
+		"OutputVariable: out\n"
+		"  enabled: true\n"
+		"  range: 0.000 1.000\n"
+		"  aggregation: AlgebraicSum\n"
+		"  defuzzifier: Centroid 100\n"
+		"  default: 0.500\n"
+		"  term: LOW Rectangle 0.000 0.500\n"
+		"  term: HIGH Rectangle 0.500 1.000\n"
+		"RuleBlock: rules\n"
+		"  enabled: true\n"
+		"  conjunction: AlgebraicProduct\n"
+		"  disjunction: AlgebraicSum\n"
+		"  implication: AlgebraicProduct\n"
+		"  activation: General\n"
+		"  rule: if a is LOW or a is HIGH then out is HIGH\n";
+
+	std::unique_ptr<fl::Engine> engine(fl::FllImporter().fromString(rules));
+
+	EXPECT_FALSE(CompiledFuzzyEngine::compile(engine.get()));
+}
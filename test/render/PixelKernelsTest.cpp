@@ -0,0 +1,289 @@
+/*
+ * PixelKernelsTest.cpp, part of VCMI engine
+ *
+ * Authors: listed in file AUTHORS in main folder
+ *
+ * License: GNU General Public License v2.0 or later
+ * Full text of license available in license.txt file, in main folder
+ *
+ */
+#include "StdInc.h"
+
+#include "../../client/renderSDL/PixelKernels.h"
+
+#include <random>
+
+using namespace PixelKernels;
+
+namespace
+{
+	/// All vectorized kernels supported by this build and CPU
+	std::vector<std::pair<std::string, const KernelSet *>> getVectorizedKernels()
+	{
+		std::vector<std::pair<std::string, const KernelSet *>> result;
+		for(const auto & entry : std::vector<std::pair<std::string, EInstructionSet>>{{"SSE2", EInstructionSet::SSE2}, {"AVX2", EInstructionSet::AVX2}, {"NEON", EInstructionSet::NEON}})
+		{
+			if(const auto * kernels = getKernels(entry.second))
+				result.emplace_back(entry.first, kernels);
+		}
+		return result;
+	}
+
+	template<typename Type>
+	std::vector<Type> randomVector(std::mt19937 & rng, size_t size)
+	{
+		std::uniform_int_distribution<uint32_t> distribution;
+		std::vector<Type> result(size);
+		for(auto & value : result)
+			value = static_cast<Type>(distribution(rng));
+		return result;
+	}
+
+	/// Columns and distances to source pixels, computed in same way as in CSDL_Ext::scaleSurface
+	void getBilinearColumns(int sourceWidth, int targetWidth, std::vector<int> & columns, std::vector<float> & distances)
+	{
+		const float factorX = float(sourceWidth - 1) / float(targetWidth);
+
+		for(int x = 0; x < targetWidth; x++)
+		{
+			float origX = factorX * x;
+			float x1 = std::floor(origX);
+			float x2 = std::floor(origX + 1);
+
+			columns.push_back(static_cast<int>(x1));
+			distances.push_back(origX - x1);
+			distances.push_back(x2 - origX);
+		}
+	}
+
+	/// Row lengths that cover tails of all vector widths
+	const std::vector<size_t> rowLengths = {0, 1, 3, 4, 5, 7, 8, 9, 15, 16, 17, 31, 33, 64, 333};
+}
+
+TEST(PixelKernelsTest, blitPaletteAlphaMatchesScalar)
+{
+	std::mt19937 rng(42);
+	const auto * scalar = getKernels(EInstructionSet::SCALAR);
+
+	auto palette = randomVector<uint8_t>(rng, 256 * 4);
+	// alpha values that have special handling in scalar code
+	const uint8_t specialAlpha[] = {0, 1, 127, 128, 129, 254, 255};
+	for(size_t i = 0; i < 256; i += 2)
+		palette[i * 4 + 3] = specialAlpha[(i / 2) % std::size(specialAlpha)];
+
+	for(const auto & kernels : getVectorizedKernels())
+	{
+		for(size_t length : rowLengths)
+		{
+			auto source = randomVector<uint8_t>(rng, length);
+			auto expected = randomVector<uint32_t>(rng, length);
+			auto actual = expected;
+
+			scalar->blitPaletteAlphaRow(source.data(), expected.data(), length, palette.data());
+			kernels.second->blitPaletteAlphaRow(source.data(), actual.data(), length, palette.data());
+
+			EXPECT_EQ(actual, expected) << kernels.first << ", " << length << " pixels";
+		}
+	}
+}
+
+TEST(PixelKernelsTest, grayscaleMatchesScalarForAllColors)
+{
+	const auto * scalar = getKernels(EInstructionSet::SCALAR);
+
+	for(const auto & kernels : getVectorizedKernels())
+	{
+		std::vector<uint32_t> expected(256 * 256);
+
+		for(uint32_t red = 0; red < 256; red++)
+		{
+			for(uint32_t i = 0; i < expected.size(); i++)
+				expected[i] = ((i & 0xFF) << 24) | (red << 16) | i;
+
+			auto actual = expected;
+			scalar->grayscaleRow(expected.data(), expected.size());
+			kernels.second->grayscaleRow(actual.data(), actual.size());
+
+			ASSERT_EQ(actual, expected) << kernels.first << ", red = " << red;
+		}
+
+		for(size_t length : rowLengths)
+		{
+			std::mt19937 rng(length);
+			auto expected = randomVector<uint32_t>(rng, length);
+			auto actual = expected;
+
+			scalar->grayscaleRow(expected.data(), length);
+			kernels.second->grayscaleRow(actual.data(), length);
+
+			EXPECT_EQ(actual, expected) << kernels.first << ", " << length << " pixels";
+		}
+	}
+}
+
+TEST(PixelKernelsTest, colorMatrixMatchesScalar)
+{
+	std::mt19937 rng(42);
+	std::uniform_real_distribution<float> coefficient(-1.5f, 1.5f);
+	const auto * scalar = getKernels(EInstructionSet::SCALAR);
+
+	std::vector<ColorMatrix> matrices = {
+		{{1, 0, 0, 0}, {0, 1, 0, 0}, {0, 0, 1, 0}, 1},
+		{{0.5f, 0, 0, 0.25f}, {0, 0.5f, 0, 0.25f}, {0, 0, 0.5f, 0.25f}, 0.5f}
+	};
+
+	for(int i = 0; i < 20; i++)
+	{
+		ColorMatrix matrix;
+		for(float * row : {matrix.r, matrix.g, matrix.b})
+		{
+			for(int j = 0; j < 4; j++)
+				row[j] = coefficient(rng);
+		}
+		matrix.alpha = coefficient(rng) + 1.5f;
+		matrices.push_back(matrix);
+	}
+
+	for(const auto & kernels : getVectorizedKernels())
+	{
+		for(const auto & matrix : matrices)
+		{
+			for(size_t length : rowLengths)
+			{
+				auto source = randomVector<uint8_t>(rng, length * 4);
+				std::vector<uint8_t> expected(length * 4);
+				std::vector<uint8_t> actual(length * 4);
+
+				scalar->colorMatrix(source.data(), expected.data(), length, matrix);
+				kernels.second->colorMatrix(source.data(), actual.data(), length, matrix);
+
+				EXPECT_EQ(actual, expected) << kernels.first << ", " << length << " colors";
+			}
+		}
+	}
+}
+
+TEST(PixelKernelsTest, scalingMatchesScalar)
+{
+	std::mt19937 rng(42);
+	const auto * scalar = getKernels(EInstructionSet::SCALAR);
+
+	for(const auto & kernels : getVectorizedKernels())
+	{
+		for(int sourceWidth : {5, 57})
+		{
+			auto upperRow = randomVector<uint32_t>(rng, sourceWidth);
+			auto lowerRow = randomVector<uint32_t>(rng, sourceWidth);
+			auto upperRow8 = randomVector<uint8_t>(rng, sourceWidth);
+
+			// some sizes produce total weight above 1 due to rounding, which must be handled in same way as in scalar code
+			for(int targetWidth = 1; targetWidth < 200; targetWidth++)
+			{
+				std::vector<int> columns;
+				std::vector<float> distances;
+				getBilinearColumns(sourceWidth, targetWidth, columns, distances);
+
+				std::vector<uint32_t> expected(targetWidth);
+				std::vector<uint32_t> actual(targetWidth);
+
+				for(float upperDistance : {0.0f, 0.3f, 0.5f, 0.99f})
+				{
+					scalar->scaleBilinearRow(upperRow.data(), lowerRow.data(), expected.data(), targetWidth, columns.data(), distances.data(), upperDistance, 1 - upperDistance);
+					kernels.second->scaleBilinearRow(upperRow.data(), lowerRow.data(), actual.data(), targetWidth, columns.data(), distances.data(), upperDistance, 1 - upperDistance);
+
+					EXPECT_EQ(actual, expected) << kernels.first << ", bilinear to " << targetWidth;
+				}
+
+				std::vector<int> nearestColumns;
+				for(int x = 0; x < targetWidth; x++)
+					nearestColumns.push_back(x * sourceWidth / targetWidth);
+
+				scalar->scaleNearestRow32(upperRow.data(), expected.data(), targetWidth, nearestColumns.data());
+				kernels.second->scaleNearestRow32(upperRow.data(), actual.data(), targetWidth, nearestColumns.data());
+				EXPECT_EQ(actual, expected) << kernels.first << ", nearest to " << targetWidth;
+
+				std::vector<uint8_t> expected8(targetWidth);
+				std::vector<uint8_t> actual8(targetWidth);
+				scalar->scaleNearestRow8(upperRow8.data(), expected8.data(), targetWidth, nearestColumns.data());
+				kernels.second->scaleNearestRow8(upperRow8.data(), actual8.data(), targetWidth, nearestColumns.data());
+				EXPECT_EQ(actual8, expected8) << kernels.first << ", 8-bit nearest to " << targetWidth;
+			}
+		}
+	}
+}
+
+/// Run with --gtest_also_run_disabled_tests --gtest_filter=PixelKernelsTest.DISABLED_Throughput
+TEST(PixelKernelsTest, DISABLED_Throughput)
+{
+	static const int WIDTH = 1920;
+	static const int HEIGHT = 1080;
+	static const int PASSES = 20;
+
+	std::mt19937 rng(42);
+	auto palette = randomVector<uint8_t>(rng, 256 * 4);
+	auto indices = randomVector<uint8_t>(rng, WIDTH * HEIGHT);
+	auto pixels = randomVector<uint32_t>(rng, WIDTH * HEIGHT);
+	auto colors = randomVector<uint8_t>(rng, WIDTH * HEIGHT * 4);
+	std::vector<uint8_t> filteredColors(WIDTH * HEIGHT * 4);
+	std::vector<uint32_t> target(WIDTH * HEIGHT);
+
+	// downscaling by 2/3 and upscaling by 3/2, similar to interface scaling
+	std::vector<int> downscaleColumns;
+	std::vector<float> downscaleDistances;
+	getBilinearColumns(WIDTH, WIDTH * 2 / 3, downscaleColumns, downscaleDistances);
+
+	std::vector<int> upscaleColumns;
+	for(int x = 0; x < WIDTH * 3 / 2; x++)
+		upscaleColumns.push_back(x * 2 / 3);
+
+	ColorMatrix matrix = {{0.5f, 0.2f, 0.1f, 0.1f}, {0.2f, 0.5f, 0.1f, 0.1f}, {0.1f, 0.2f, 0.5f, 0.1f}, 0.8f};
+
+	auto measure = [](const std::string & name, size_t pixelsPerPass, const std::function<void()> & pass)
+	{
+		auto timeStart = std::chrono::steady_clock::now();
+		for(int i = 0; i < PASSES; i++)
+			pass();
+		double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - timeStart).count();
+
+		std::cout << "  " << name << ": " << static_cast<int64_t>(pixelsPerPass * PASSES / seconds / 1000000) << " Mpixels/s" << std::endl;
+	};
+
+	auto allKernels = getVectorizedKernels();
+	allKernels.emplace(allKernels.begin(), "Scalar", getKernels(EInstructionSet::SCALAR));
+
+	for(const auto & kernels : allKernels)
+	{
+		const KernelSet & set = *kernels.second;
+		std::cout << kernels.first << ":" << std::endl;
+
+		measure("palette blit", WIDTH * HEIGHT, [&]()
+		{
+			for(int y = 0; y < HEIGHT; y++)
+				set.blitPaletteAlphaRow(indices.data() + y * WIDTH, target.data() + y * WIDTH, WIDTH, palette.data());
+		});
+
+		measure("grayscale", WIDTH * HEIGHT, [&]()
+		{
+			target = pixels;
+			for(int y = 0; y < HEIGHT; y++)
+				set.grayscaleRow(target.data() + y * WIDTH, WIDTH);
+		});
+
+		measure("color matrix", WIDTH * HEIGHT, [&]()
+		{
+			set.colorMatrix(colors.data(), filteredColors.data(), WIDTH * HEIGHT, matrix);
+		});
+
+		measure("bilinear scaling", downscaleColumns.size() * (HEIGHT - 1), [&]()
+		{
+			for(int y = 0; y < HEIGHT - 1; y++)
+				set.scaleBilinearRow(pixels.data() + y * WIDTH, pixels.data() + (y + 1) * WIDTH, target.data() + y * WIDTH, downscaleColumns.size(), downscaleColumns.data(), downscaleDistances.data(), 0.25f, 0.75f);
+		});
+
+		measure("nearest scaling", upscaleColumns.size() * HEIGHT / 2, [&]()
+		{
+			for(int y = 0; y < HEIGHT / 2; y++)
+				set.scaleNearestRow32(pixels.data() + y * WIDTH, target.data() + y * upscaleColumns.size(), upscaleColumns.size(), upscaleColumns.data());
+		});
+	}
+}